@@ -34,6 +34,7 @@
 
 static gboolean show_version = FALSE;
 static gboolean debug = FALSE;
+static gint duck_level = -1;
 
 int
 main (int argc, char **argv)
@@ -44,6 +45,7 @@ main (int argc, char **argv)
         GOptionEntry  entries[] = {
                 { "version", 'v', 0, G_OPTION_ARG_NONE, &show_version, N_("Version of this application"), NULL },
                 { "debug", 'd', 0, G_OPTION_ARG_NONE, &debug, N_("Enable debug"), NULL },
+                { "duck-level", 0, 0, G_OPTION_ARG_INT, &duck_level, N_("Lower music and video to PERCENT of their volume during calls"), N_("PERCENT") },
                 { NULL }
         };
 
@@ -90,6 +92,9 @@ main (int argc, char **argv)
 
         applet = gvc_applet_new ();
 
+        if (duck_level >= 0)
+                gvc_applet_set_duck_level (applet, duck_level);
+
         gvc_applet_start (applet);
         gtk_main ();
 
@@ -0,0 +1,282 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 8 -*-
+ * Copyright (C) 2026 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/* Times the reading of a large generated alert sound definition file,
+ * with the streaming reader used by the sound preferences and with the
+ * document tree based parser it replaced.
+ *
+ * Usage: bench-sound-alerts [SOUNDS [LANGUAGES [ITERATIONS]]] */
+
+#include <config.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <libxml/parser.h>
+
+#include "sound-alert-reader.h"
+
+#define DEFAULT_SOUNDS      500
+#define DEFAULT_LANGUAGES   80
+#define DEFAULT_ITERATIONS  20
+
+typedef struct {
+        guint count;
+        guint hash;
+} Result;
+
+static void
+add_result (const char *filename, const char *name, Result *result)
+{
+        result->count++;
+        result->hash = result->hash * 31 + g_str_hash (filename) + g_str_hash (name);
+}
+
+/* The parser used before the streaming reader, adapted from
+ * yelp-toc-pager.c */
+static xmlChar *
+dom_get_and_trim_names (xmlNodePtr node, const gchar * const *langs)
+{
+        xmlNodePtr cur;
+        xmlChar   *keep_lang = NULL;
+        xmlChar   *value = NULL;
+        int        j, keep_pri = INT_MAX;
+
+        for (cur = node->children; cur; cur = cur->next) {
+                if (! xmlStrcmp (cur->name, (xmlChar *) "name")) {
+                        xmlChar *cur_lang = NULL;
+                        int      cur_pri = INT_MAX;
+
+                        cur_lang = xmlNodeGetLang (cur);
+
+                        if (cur_lang) {
+                                for (j = 0; langs[j]; j++) {
+                                        if (g_str_equal (cur_lang, langs[j])) {
+                                                cur_pri = j;
+                                                break;
+                                        }
+                                }
+                        } else {
+                                cur_pri = INT_MAX - 1;
+                        }
+
+                        if (cur_pri <= keep_pri) {
+                                if (keep_lang)
+                                        xmlFree (keep_lang);
+                                if (value)
+                                        xmlFree (value);
+
+                                value = xmlNodeGetContent (cur);
+
+                                keep_lang = cur_lang;
+                                keep_pri = cur_pri;
+                        } else {
+                                if (cur_lang)
+                                        xmlFree (cur_lang);
+                        }
+                }
+        }
+        if (keep_lang)
+                xmlFree (keep_lang);
+
+        cur = node->children;
+        while (cur) {
+                xmlNodePtr this = cur;
+                cur = cur->next;
+                if (! xmlStrcmp (this->name, (xmlChar *) "name")) {
+                        xmlUnlinkNode (this);
+                        xmlFreeNode (this);
+                }
+        }
+
+        return value;
+}
+
+static gboolean
+dom_read_file (const char          *path,
+               const gchar * const *langs,
+               SoundAlertFunc       func,
+               gpointer             user_data)
+{
+        xmlDocPtr  doc;
+        xmlNodePtr child;
+
+        doc = xmlParseFile (path);
+        if (doc == NULL)
+                return FALSE;
+
+        for (child = xmlDocGetRootElement (doc)->children; child; child = child->next) {
+                xmlNodePtr node;
+                xmlChar   *filename = NULL;
+                xmlChar   *name;
+
+                if (xmlNodeIsText (child) || xmlStrcmp (child->name, (xmlChar *) "sound") != 0)
+                        continue;
+
+                name = dom_get_and_trim_names (child, langs);
+
+                for (node = child->children; node; node = node->next) {
+                        if (xmlNodeIsText (node))
+                                continue;
+                        if (xmlStrcmp (node->name, (xmlChar *) "filename") == 0) {
+                                if (filename != NULL)
+                                        xmlFree (filename);
+                                filename = xmlNodeGetContent (node);
+                        }
+                }
+
+                if (filename != NULL && name != NULL)
+                        func ((const char *) filename, (const char *) name, user_data);
+
+                xmlFree (filename);
+                xmlFree (name);
+        }
+
+        xmlFreeDoc (doc);
+        return TRUE;
+}
+
+/* Lays the file out like the installed ones, every sound has a name in
+ * each of the languages followed by its file */
+static char *
+write_alerts_file (guint sounds, guint languages)
+{
+        GString *xml;
+        GError  *error = NULL;
+        char    *path;
+        int      fd;
+        guint    i, j;
+
+        xml = g_string_new ("<?xml version=\"1.0\"?>\n<sounds>\n");
+
+        for (i = 0; i < sounds; i++) {
+                g_string_append (xml, "  <sound deleted=\"false\">\n");
+                g_string_append_printf (xml, "    <name>Alert %u</name>\n", i);
+
+                for (j = 0; j < languages; j++)
+                        g_string_append_printf (xml,
+                                                "    <name xml:lang=\"l%u\">Alert %u in language %u</name>\n",
+                                                j, i, j);
+
+                g_string_append_printf (xml,
+                                        "    <filename>/usr/share/sounds/alerts/alert-%u.ogg</filename>\n"
+                                        "  </sound>\n",
+                                        i);
+        }
+        g_string_append (xml, "</sounds>\n");
+
+        fd = g_file_open_tmp ("bench-sound-alerts-XXXXXX.xml", &path, &error);
+        if (fd < 0) {
+                g_printerr ("%s\n", error->message);
+                exit (1);
+        }
+        close (fd);
+
+        if (g_file_set_contents (path, xml->str, xml->len, &error) == FALSE) {
+                g_printerr ("%s\n", error->message);
+                exit (1);
+        }
+
+        g_print ("%u sounds in %u languages, %" G_GSIZE_FORMAT " KiB\n",
+                 sounds, languages, xml->len / 1024);
+
+        g_string_free (xml, TRUE);
+        return path;
+}
+
+static gdouble
+run (const char          *label,
+     gboolean           (*read_file) (const char *, const gchar * const *, SoundAlertFunc, gpointer),
+     const char          *path,
+     const gchar * const *langs,
+     guint                iterations,
+     Result              *result)
+{
+        gint64 start;
+        gdouble msec;
+        guint  i;
+
+        start = g_get_monotonic_time ();
+
+        for (i = 0; i < iterations; i++) {
+                result->count = 0;
+                result->hash  = 0;
+
+                if (read_file (path, langs, (SoundAlertFunc) add_result, result) == FALSE) {
+                        g_printerr ("Failed to read %s\n", path);
+                        exit (1);
+                }
+        }
+
+        msec = (gdouble) (g_get_monotonic_time () - start) / 1000 / iterations;
+
+        g_print ("%-8s %8.2f ms per file\n", label, msec);
+        return msec;
+}
+
+int
+main (int argc, char **argv)
+{
+        Result       dom, reader;
+        const gchar *langs[3];
+        char        *lang;
+        char        *path;
+        guint        sounds     = DEFAULT_SOUNDS;
+        guint        languages  = DEFAULT_LANGUAGES;
+        guint        iterations = DEFAULT_ITERATIONS;
+        gdouble      dom_msec, reader_msec;
+
+        if (argc > 1)
+                sounds = MAX (1, atoi (argv[1]));
+        if (argc > 2)
+                languages = MAX (1, atoi (argv[2]));
+        if (argc > 3)
+                iterations = MAX (1, atoi (argv[3]));
+
+        xmlInitParser ();
+
+        path = write_alerts_file (sounds, languages);
+
+        /* A language in the middle of the list, so both parsers skip
+         * names before and after the one they keep */
+        lang = g_strdup_printf ("l%u", languages / 2);
+        langs[0] = lang;
+        langs[1] = "C";
+        langs[2] = NULL;
+
+        dom_msec    = run ("DOM", dom_read_file, path, langs, iterations, &dom);
+        reader_msec = run ("Reader", sound_alerts_read_file, path, langs, iterations, &reader);
+
+        g_print ("Speedup  %8.2fx\n", dom_msec / MAX (reader_msec, 0.001));
+
+        g_unlink (path);
+        g_free (path);
+        g_free (lang);
+
+        xmlCleanupParser ();
+
+        if (dom.count != reader.count || dom.hash != reader.hash) {
+                g_printerr ("The parsers disagree: %u alerts with the DOM, %u with the reader\n",
+                            dom.count, reader.count);
+                return 1;
+        }
+        return 0;
+}
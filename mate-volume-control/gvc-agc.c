@@ -0,0 +1,426 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2026 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* Automatic gain control of an input stream, driven by the peak values of
+ * the stream monitor.
+ *
+ * Two envelopes are followed: a peak envelope which rises quickly and falls
+ * slowly, and a mean square level averaged over about a second. The volume
+ * is only changed when the level leaves the target band or when the peaks
+ * get too close to clipping, and at most a few times per second. */
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+
+#include <libmatemixer/matemixer.h>
+
+#include "gvc-agc.h"
+
+#define GVC_AGC_GET_PRIVATE(o) (G_TYPE_INSTANCE_GET_PRIVATE ((o), GVC_TYPE_AGC, GvcAgcPrivate))
+
+/* Time constants of the envelopes in milliseconds */
+#define PEAK_ATTACK     20
+#define PEAK_RELEASE    1500
+#define LEVEL_WINDOW    1000
+
+/* Target band of the averaged level, the volume is left alone within it */
+#define LEVEL_LOW       0.15
+#define LEVEL_TARGET    0.22
+#define LEVEL_HIGH      0.32
+
+/* Peaks above the limit are pulled back to the peak target */
+#define PEAK_LIMIT      0.9
+#define PEAK_TARGET     0.7
+
+/* Levels below this are treated as silence and never boosted */
+#define SILENCE         0.02
+
+/* Largest volume changes in decibels in a single write */
+#define MAX_STEP_UP     1.5
+#define MAX_STEP_DOWN   6.0
+#define MIN_STEP        0.5
+
+/* Minimum time between two volume writes in milliseconds */
+#define WRITE_INTERVAL  250
+
+/* Volume notifications arriving this long after a write are our own echo */
+#define ECHO_WINDOW     250
+
+/* Time in seconds the control is left alone after the user changes it */
+#define USER_HOLD       5
+
+struct _GvcAgcPrivate
+{
+        MateMixerStreamControl *control;
+        gboolean                enabled;
+        gdouble                 peak;
+        gdouble                 level;
+        gint64                  sample_time;
+        gint64                  write_time;
+        gint64                  hold_time;
+        guint                   written;
+};
+
+enum
+{
+        PROP_0,
+        PROP_CONTROL,
+        PROP_ENABLED,
+        N_PROPERTIES
+};
+
+static GParamSpec *properties[N_PROPERTIES] = { NULL, };
+
+static void gvc_agc_class_init (GvcAgcClass *klass);
+static void gvc_agc_init       (GvcAgc      *agc);
+static void gvc_agc_dispose    (GObject     *object);
+
+G_DEFINE_TYPE (GvcAgc, gvc_agc, G_TYPE_OBJECT)
+
+static void
+reset_state (GvcAgc *agc)
+{
+        agc->priv->peak        = 0.0;
+        agc->priv->level       = 0.0;
+        agc->priv->sample_time = 0;
+        agc->priv->write_time  = 0;
+        agc->priv->hold_time   = 0;
+}
+
+static gdouble
+smooth (gdouble current, gdouble target, gint64 elapsed, guint time_constant)
+{
+        gdouble coefficient;
+
+        coefficient = 1.0 - exp (-(gdouble) elapsed / (time_constant * 1000.0));
+
+        return current + (target - current) * coefficient;
+}
+
+static gboolean
+write_gain (GvcAgc *agc, gdouble step)
+{
+        MateMixerStreamControl     *control = agc->priv->control;
+        MateMixerStreamControlFlags flags;
+        guint                       min;
+        guint                       max;
+        guint                       volume;
+
+        flags = mate_mixer_stream_control_get_flags (control);
+
+        min = mate_mixer_stream_control_get_min_volume (control);
+        max = mate_mixer_stream_control_get_normal_volume (control);
+
+        /* Never amplify above the normal volume, that only adds noise */
+        if (flags & MATE_MIXER_STREAM_CONTROL_HAS_DECIBEL) {
+                gdouble current = mate_mixer_stream_control_get_decibel (control);
+                gdouble decibel;
+
+                if (current <= -MATE_MIXER_INFINITY)
+                        return FALSE;
+
+                decibel = MIN (current + step, 0.0);
+
+                /* Already at the limit, typically 0 dB */
+                if (decibel == current)
+                        return FALSE;
+
+                if (mate_mixer_stream_control_set_decibel (control, decibel) == FALSE)
+                        return FALSE;
+
+                volume = mate_mixer_stream_control_get_volume (control);
+        } else {
+                volume = mate_mixer_stream_control_get_volume (control);
+                volume = CLAMP (min + (volume - min) * pow (10.0, step / 20.0), min, max);
+
+                if (volume == mate_mixer_stream_control_get_volume (control))
+                        return FALSE;
+
+                if (mate_mixer_stream_control_set_volume (control, volume) == FALSE)
+                        return FALSE;
+        }
+
+        agc->priv->written = volume;
+        return TRUE;
+}
+
+static void
+on_control_volume_notify (MateMixerStreamControl *control,
+                          GParamSpec             *pspec,
+                          GvcAgc                 *agc)
+{
+        gint64 now = g_get_monotonic_time ();
+
+        if (now - agc->priv->write_time < ECHO_WINDOW * 1000)
+                return;
+
+        if (mate_mixer_stream_control_get_volume (control) == agc->priv->written)
+                return;
+
+        /* The user has moved the slider, do not fight it */
+        g_debug ("Input volume changed by the user, pausing gain control");
+
+        agc->priv->hold_time = now + USER_HOLD * G_USEC_PER_SEC;
+}
+
+/**
+ * gvc_agc_process:
+ * @agc: a #GvcAgc
+ * @peak: a peak value reported by the monitor of the stream control
+ *
+ * Feeds a peak value of the input to the gain control and adjusts the
+ * volume of the control when needed.
+ */
+void
+gvc_agc_process (GvcAgc *agc, gdouble peak)
+{
+        GvcAgcPrivate *priv;
+        gint64         now;
+        gint64         elapsed;
+        gdouble        step = 0.0;
+
+        g_return_if_fail (GVC_IS_AGC (agc));
+
+        priv = agc->priv;
+
+        if (priv->enabled == FALSE || priv->control == NULL)
+                return;
+
+        peak = CLAMP (peak, 0.0, 1.0);
+        now  = g_get_monotonic_time ();
+
+        elapsed = (priv->sample_time > 0) ? now - priv->sample_time : 0;
+
+        priv->sample_time = now;
+
+        /* The smoothing depends on the time between the samples rather than
+         * on their number, so the monitor rate does not matter */
+        if (peak > priv->peak)
+                priv->peak = smooth (priv->peak, peak, elapsed, PEAK_ATTACK);
+        else
+                priv->peak = smooth (priv->peak, peak, elapsed, PEAK_RELEASE);
+
+        priv->level = smooth (priv->level, peak * peak, elapsed, LEVEL_WINDOW);
+
+        if (now < priv->hold_time)
+                return;
+        if (now - priv->write_time < WRITE_INTERVAL * 1000)
+                return;
+
+        if (mate_mixer_stream_control_get_mute (priv->control) == TRUE)
+                return;
+
+        if (priv->peak > PEAK_LIMIT) {
+                step = MAX (20.0 * log10 (PEAK_TARGET / priv->peak), -MAX_STEP_DOWN);
+        } else {
+                gdouble level = sqrt (priv->level);
+
+                if (level < SILENCE)
+                        return;
+
+                if (level < LEVEL_LOW || level > LEVEL_HIGH) {
+                        step = 20.0 * log10 (LEVEL_TARGET / level);
+                        step = CLAMP (step, -MAX_STEP_DOWN, MAX_STEP_UP);
+
+                        /* Do not boost the peaks into the limit */
+                        if (step > 0.0 && priv->peak > 0.0)
+                                step = MIN (step, 20.0 * log10 (PEAK_LIMIT / priv->peak));
+                }
+        }
+
+        if (fabs (step) < MIN_STEP)
+                return;
+
+        priv->write_time = now;
+
+        if (write_gain (agc, step) == TRUE) {
+                gdouble ratio = pow (10.0, step / 20.0);
+
+                g_debug ("Adjusted input gain by %.1f dB", step);
+
+                /* Assume the new gain in the envelopes right away, otherwise
+                 * the next writes would overshoot before they catch up */
+                priv->peak  *= ratio;
+                priv->level *= ratio * ratio;
+        }
+}
+
+MateMixerStreamControl *
+gvc_agc_get_control (GvcAgc *agc)
+{
+        g_return_val_if_fail (GVC_IS_AGC (agc), NULL);
+
+        return agc->priv->control;
+}
+
+void
+gvc_agc_set_control (GvcAgc *agc, MateMixerStreamControl *control)
+{
+        g_return_if_fail (GVC_IS_AGC (agc));
+        g_return_if_fail (control == NULL || MATE_MIXER_IS_STREAM_CONTROL (control));
+
+        if (agc->priv->control == control)
+                return;
+
+        if (control != NULL)
+                g_object_ref (control);
+
+        if (agc->priv->control != NULL) {
+                g_signal_handlers_disconnect_by_func (G_OBJECT (agc->priv->control),
+                                                      G_CALLBACK (on_control_volume_notify),
+                                                      agc);
+                g_object_unref (agc->priv->control);
+        }
+
+        agc->priv->control = control;
+
+        if (control != NULL)
+                g_signal_connect (G_OBJECT (control),
+                                  "notify::volume",
+                                  G_CALLBACK (on_control_volume_notify),
+                                  agc);
+
+        reset_state (agc);
+
+        g_object_notify_by_pspec (G_OBJECT (agc), properties[PROP_CONTROL]);
+}
+
+gboolean
+gvc_agc_get_enabled (GvcAgc *agc)
+{
+        g_return_val_if_fail (GVC_IS_AGC (agc), FALSE);
+
+        return agc->priv->enabled;
+}
+
+void
+gvc_agc_set_enabled (GvcAgc *agc, gboolean enabled)
+{
+        g_return_if_fail (GVC_IS_AGC (agc));
+
+        enabled = !!enabled;
+
+        if (agc->priv->enabled == enabled)
+                return;
+
+        agc->priv->enabled = enabled;
+
+        reset_state (agc);
+
+        g_object_notify_by_pspec (G_OBJECT (agc), properties[PROP_ENABLED]);
+}
+
+static void
+gvc_agc_set_property (GObject       *object,
+                      guint          prop_id,
+                      const GValue  *value,
+                      GParamSpec    *pspec)
+{
+        GvcAgc *self = GVC_AGC (object);
+
+        switch (prop_id) {
+        case PROP_CONTROL:
+                gvc_agc_set_control (self, g_value_get_object (value));
+                break;
+        case PROP_ENABLED:
+                gvc_agc_set_enabled (self, g_value_get_boolean (value));
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+                break;
+        }
+}
+
+static void
+gvc_agc_get_property (GObject     *object,
+                      guint        prop_id,
+                      GValue      *value,
+                      GParamSpec  *pspec)
+{
+        GvcAgc *self = GVC_AGC (object);
+
+        switch (prop_id) {
+        case PROP_CONTROL:
+                g_value_set_object (value, self->priv->control);
+                break;
+        case PROP_ENABLED:
+                g_value_set_boolean (value, self->priv->enabled);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+                break;
+        }
+}
+
+static void
+gvc_agc_class_init (GvcAgcClass *klass)
+{
+        GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+        object_class->dispose = gvc_agc_dispose;
+        object_class->set_property = gvc_agc_set_property;
+        object_class->get_property = gvc_agc_get_property;
+
+        properties[PROP_CONTROL] =
+                g_param_spec_object ("control",
+                                     "Control",
+                                     "MateMixer stream control",
+                                     MATE_MIXER_TYPE_STREAM_CONTROL,
+                                     G_PARAM_READWRITE |
+                                     G_PARAM_STATIC_STRINGS);
+
+        properties[PROP_ENABLED] =
+                g_param_spec_boolean ("enabled",
+                                      "Enabled",
+                                      "Whether the gain is controlled automatically",
+                                      FALSE,
+                                      G_PARAM_READWRITE |
+                                      G_PARAM_STATIC_STRINGS);
+
+        g_object_class_install_properties (object_class, N_PROPERTIES, properties);
+
+        g_type_class_add_private (klass, sizeof (GvcAgcPrivate));
+}
+
+static void
+gvc_agc_init (GvcAgc *agc)
+{
+        agc->priv = GVC_AGC_GET_PRIVATE (agc);
+}
+
+static void
+gvc_agc_dispose (GObject *object)
+{
+        GvcAgc *agc = GVC_AGC (object);
+
+        if (agc->priv->control != NULL) {
+                g_signal_handlers_disconnect_by_data (G_OBJECT (agc->priv->control), agc);
+                g_clear_object (&agc->priv->control);
+        }
+
+        G_OBJECT_CLASS (gvc_agc_parent_class)->dispose (object);
+}
+
+GvcAgc *
+gvc_agc_new (void)
+{
+        return g_object_new (GVC_TYPE_AGC, NULL);
+}
@@ -0,0 +1,70 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2026 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef __GVC_AGC_H
+#define __GVC_AGC_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include <libmatemixer/matemixer.h>
+
+G_BEGIN_DECLS
+
+#define GVC_TYPE_AGC         (gvc_agc_get_type ())
+#define GVC_AGC(o)           (G_TYPE_CHECK_INSTANCE_CAST ((o), GVC_TYPE_AGC, GvcAgc))
+#define GVC_AGC_CLASS(k)     (G_TYPE_CHECK_CLASS_CAST((k), GVC_TYPE_AGC, GvcAgcClass))
+#define GVC_IS_AGC(o)        (G_TYPE_CHECK_INSTANCE_TYPE ((o), GVC_TYPE_AGC))
+#define GVC_IS_AGC_CLASS(k)  (G_TYPE_CHECK_CLASS_TYPE ((k), GVC_TYPE_AGC))
+#define GVC_AGC_GET_CLASS(o) (G_TYPE_INSTANCE_GET_CLASS ((o), GVC_TYPE_AGC, GvcAgcClass))
+
+typedef struct _GvcAgc            GvcAgc;
+typedef struct _GvcAgcClass       GvcAgcClass;
+typedef struct _GvcAgcPrivate     GvcAgcPrivate;
+
+struct _GvcAgc
+{
+        GObject                 parent;
+        GvcAgcPrivate          *priv;
+};
+
+struct _GvcAgcClass
+{
+        GObjectClass            parent_class;
+};
+
+GType                   gvc_agc_get_type        (void) G_GNUC_CONST;
+
+GvcAgc *                gvc_agc_new             (void);
+
+MateMixerStreamControl *gvc_agc_get_control     (GvcAgc                 *agc);
+void                    gvc_agc_set_control     (GvcAgc                 *agc,
+                                                 MateMixerStreamControl *control);
+
+gboolean                gvc_agc_get_enabled     (GvcAgc                 *agc);
+void                    gvc_agc_set_enabled     (GvcAgc                 *agc,
+                                                 gboolean                enabled);
+
+void                    gvc_agc_process         (GvcAgc                 *agc,
+                                                 gdouble                 peak);
+
+G_END_DECLS
+
+#endif /* __GVC_AGC_H */
@@ -0,0 +1,1729 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2026 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* A compact application volume row.
+ *
+ * The Applications page may show a large number of streams, so instead of
+ * building a GvcChannelBar out of boxes, images, a label, a scale and a mute
+ * button for each of them, this widget draws the icon, the name, the volume
+ * slider and the mute indicator itself and only uses an input window for
+ * events.
+ *
+ * Instead of a single control, the row may also be bound to a group of
+ * controls. The slider then shows the loudest member and moving it scales
+ * the volume of every member by the same ratio. */
+
+#include <glib.h>
+#include <glib/gi18n.h>
+#include <glib-object.h>
+#include <gtk/gtk.h>
+#include <gtk/gtk-a11y.h>
+
+#define MATE_DESKTOP_USE_UNSTABLE_API
+#include <libmate-desktop/mate-desktop-utils.h>
+
+#include <libmatemixer/matemixer.h>
+
+#include "gvc-app-bar.h"
+#include "gvc-icon-cache.h"
+
+#define GVC_APP_BAR_GET_PRIVATE(o) (G_TYPE_INSTANCE_GET_PRIVATE ((o), GVC_TYPE_APP_BAR, GvcAppBarPrivate))
+
+#define PADDING            6
+#define SPACING            12
+#define ICON_SIZE          32
+#define MUTE_SIZE          16
+#define NAME_WIDTH_CHARS   20
+#define SLIDER_MIN_WIDTH   128
+#define TROUGH_HEIGHT      4
+#define KNOB_RADIUS        7
+#define EXPANDER_SIZE      16
+
+typedef struct {
+        GdkRectangle  expander;
+        GdkRectangle  icon;
+        GdkRectangle  name;
+        GdkRectangle  slider;
+        GdkRectangle  mute;
+} AppBarLayout;
+
+struct _GvcAppBarPrivate
+{
+        MateMixerStreamControl     *control;
+        GPtrArray                  *group;
+        gboolean                    group_writing;
+        MateMixerStreamControlFlags control_flags;
+        gdouble                     volume;
+        gdouble                     min_volume;
+        gdouble                     max_volume;
+        gboolean                    mute;
+        gboolean                    input;
+        gchar                      *name;
+        gchar                      *icon_name;
+        guint                       indent;
+        gboolean                    expander;
+        gboolean                    expanded;
+        PangoLayout                *name_layout;
+        gint                        name_width;
+        gint                        text_height;
+        GdkWindow                  *event_window;
+        AppBarLayout                layout;
+        gboolean                    dragging;
+        AtkObject                  *accessible;
+};
+
+enum
+{
+        PROP_0,
+        PROP_CONTROL,
+        PROP_NAME,
+        PROP_ICON_NAME,
+        PROP_INDENT,
+        PROP_EXPANDER,
+        PROP_EXPANDED,
+        N_PROPERTIES
+};
+
+static GParamSpec *properties[N_PROPERTIES] = { NULL, };
+
+static void gvc_app_bar_class_init (GvcAppBarClass *klass);
+static void gvc_app_bar_init       (GvcAppBar      *bar);
+static void gvc_app_bar_dispose    (GObject        *object);
+static void gvc_app_bar_finalize   (GObject        *object);
+
+G_DEFINE_TYPE (GvcAppBar, gvc_app_bar, GTK_TYPE_WIDGET)
+
+/* Accessible object exposing the row as a slider with a mute action */
+typedef struct
+{
+        GtkWidgetAccessible parent;
+} GvcAppBarAccessible;
+
+typedef struct
+{
+        GtkWidgetAccessibleClass parent_class;
+} GvcAppBarAccessibleClass;
+
+static GType gvc_app_bar_accessible_get_type (void);
+
+static void gvc_app_bar_accessible_value_init  (AtkValueIface  *iface);
+static void gvc_app_bar_accessible_action_init (AtkActionIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (GvcAppBarAccessible,
+                         gvc_app_bar_accessible,
+                         GTK_TYPE_WIDGET_ACCESSIBLE,
+                         G_IMPLEMENT_INTERFACE (ATK_TYPE_VALUE,
+                                                gvc_app_bar_accessible_value_init)
+                         G_IMPLEMENT_INTERFACE (ATK_TYPE_ACTION,
+                                                gvc_app_bar_accessible_action_init))
+
+static gboolean
+rectangle_contains (GdkRectangle *rect, gdouble x, gdouble y)
+{
+        return x >= rect->x && x < rect->x + rect->width &&
+               y >= rect->y && y < rect->y + rect->height;
+}
+
+static void
+mirror_rectangle (GdkRectangle *rect, gint width)
+{
+        rect->x = width - rect->x - rect->width;
+}
+
+static gint
+get_leading_width (GvcAppBar *bar)
+{
+        return bar->priv->indent * (EXPANDER_SIZE + SPACING);
+}
+
+static gint
+get_name_width (GvcAppBar *bar)
+{
+        /* Indented rows take the space from the name, so that the sliders
+         * of all the rows stay aligned */
+        return MAX (0, bar->priv->name_width - get_leading_width (bar));
+}
+
+static gboolean
+has_target (GvcAppBar *bar)
+{
+        return bar->priv->control != NULL || bar->priv->group != NULL;
+}
+
+static void
+bar_calc_layout (GvcAppBar *bar)
+{
+        AppBarLayout *layout = &bar->priv->layout;
+        GtkAllocation allocation;
+        gint          x;
+
+        gtk_widget_get_allocation (GTK_WIDGET (bar), &allocation);
+
+        /* The expander occupies the last of the indentation columns */
+        layout->expander.x      = PADDING + get_leading_width (bar) - EXPANDER_SIZE - SPACING;
+        layout->expander.y      = 0;
+        layout->expander.width  = EXPANDER_SIZE;
+        layout->expander.height = allocation.height;
+
+        x = PADDING + get_leading_width (bar);
+
+        layout->icon.x      = x;
+        layout->icon.y      = (allocation.height - ICON_SIZE) / 2;
+        layout->icon.width  = ICON_SIZE;
+        layout->icon.height = ICON_SIZE;
+
+        x += ICON_SIZE + SPACING;
+
+        layout->name.x      = x;
+        layout->name.y      = 0;
+        layout->name.width  = get_name_width (bar);
+        layout->name.height = allocation.height;
+
+        x += layout->name.width + SPACING;
+
+        /* The mute indicator reacts to clicks over the whole row height */
+        layout->mute.x      = allocation.width - PADDING - MUTE_SIZE;
+        layout->mute.y      = 0;
+        layout->mute.width  = MUTE_SIZE;
+        layout->mute.height = allocation.height;
+
+        layout->slider.x      = x;
+        layout->slider.y      = 0;
+        layout->slider.width  = MAX (0, layout->mute.x - SPACING - x);
+        layout->slider.height = allocation.height;
+
+        if (gtk_widget_get_direction (GTK_WIDGET (bar)) == GTK_TEXT_DIR_RTL) {
+                mirror_rectangle (&layout->expander, allocation.width);
+                mirror_rectangle (&layout->icon, allocation.width);
+                mirror_rectangle (&layout->name, allocation.width);
+                mirror_rectangle (&layout->slider, allocation.width);
+                mirror_rectangle (&layout->mute, allocation.width);
+        }
+}
+
+static gdouble
+get_fraction (GvcAppBar *bar)
+{
+        gdouble range = bar->priv->max_volume - bar->priv->min_volume;
+
+        if (range <= 0)
+                return 0.0;
+
+        return CLAMP ((bar->priv->volume - bar->priv->min_volume) / range, 0.0, 1.0);
+}
+
+static gdouble
+get_slider_x (GvcAppBar *bar, gdouble fraction)
+{
+        GdkRectangle *slider = &bar->priv->layout.slider;
+        gdouble       width;
+
+        width = MAX (0, slider->width - 2 * KNOB_RADIUS);
+
+        if (gtk_widget_get_direction (GTK_WIDGET (bar)) == GTK_TEXT_DIR_RTL)
+                fraction = 1.0 - fraction;
+
+        return slider->x + KNOB_RADIUS + width * fraction;
+}
+
+static gdouble
+get_fraction_at_x (GvcAppBar *bar, gdouble x)
+{
+        GdkRectangle *slider = &bar->priv->layout.slider;
+        gdouble       width;
+        gdouble       fraction;
+
+        width = slider->width - 2 * KNOB_RADIUS;
+        if (width <= 0)
+                return 0.0;
+
+        fraction = CLAMP ((x - slider->x - KNOB_RADIUS) / width, 0.0, 1.0);
+
+        if (gtk_widget_get_direction (GTK_WIDGET (bar)) == GTK_TEXT_DIR_RTL)
+                fraction = 1.0 - fraction;
+
+        return fraction;
+}
+
+/* The volume of a member relative to its normal volume, above 1.0 for an
+ * amplified stream */
+static gdouble
+get_control_fraction (MateMixerStreamControl *control,
+                      guint                   volume)
+{
+        gdouble min    = mate_mixer_stream_control_get_min_volume (control);
+        gdouble normal = mate_mixer_stream_control_get_normal_volume (control);
+
+        if (normal <= min)
+                return 0.0;
+
+        return MAX (0.0, (volume - min) / (normal - min));
+}
+
+static void
+update_group_state (GvcAppBar *bar)
+{
+        guint i;
+
+        /* The group volume is a fraction of the normal volume */
+        bar->priv->control_flags = MATE_MIXER_STREAM_CONTROL_NO_FLAGS;
+        bar->priv->volume        = 0.0;
+        bar->priv->min_volume    = 0.0;
+        bar->priv->max_volume    = 1.0;
+        bar->priv->mute          = (bar->priv->group->len > 0);
+
+        for (i = 0; i < bar->priv->group->len; i++) {
+                MateMixerStreamControl *control = g_ptr_array_index (bar->priv->group, i);
+
+                bar->priv->control_flags |= mate_mixer_stream_control_get_flags (control);
+
+                bar->priv->volume =
+                        MAX (bar->priv->volume,
+                             get_control_fraction (control,
+                                                   mate_mixer_stream_control_get_volume (control)));
+
+                /* Allow the group to go as high as its loudest member can */
+                bar->priv->max_volume =
+                        MAX (bar->priv->max_volume,
+                             get_control_fraction (control,
+                                                   mate_mixer_stream_control_get_max_volume (control)));
+
+                if (mate_mixer_stream_control_get_mute (control) == FALSE)
+                        bar->priv->mute = FALSE;
+        }
+}
+
+static void
+set_group_volume (GvcAppBar *bar, gdouble value)
+{
+        gdouble ratio = 0.0;
+        guint   i;
+
+        /* Scale all the members by the same ratio to keep their balance,
+         * when the group is silent there is nothing to keep */
+        if (bar->priv->volume > 0.0)
+                ratio = value / bar->priv->volume;
+
+        /* Change notifications of the members would recompute the group
+         * state after each write, do it once at the end instead */
+        bar->priv->group_writing = TRUE;
+
+        for (i = 0; i < bar->priv->group->len; i++) {
+                MateMixerStreamControl     *control = g_ptr_array_index (bar->priv->group, i);
+                MateMixerStreamControlFlags flags;
+                gboolean                    mute = (value <= 0.0);
+
+                flags = mate_mixer_stream_control_get_flags (control);
+
+                if ((flags & MATE_MIXER_STREAM_CONTROL_MUTE_WRITABLE) &&
+                    mate_mixer_stream_control_get_mute (control) != mute)
+                        mate_mixer_stream_control_set_mute (control, mute);
+
+                if (flags & MATE_MIXER_STREAM_CONTROL_VOLUME_WRITABLE) {
+                        gdouble min     = mate_mixer_stream_control_get_min_volume (control);
+                        gdouble max     = mate_mixer_stream_control_get_max_volume (control);
+                        gdouble normal  = mate_mixer_stream_control_get_normal_volume (control);
+                        gdouble current = mate_mixer_stream_control_get_volume (control);
+                        gdouble target;
+                        guint   volume;
+
+                        /* Scale from the real volume of the member, so one
+                         * above 100% keeps its distance to the others */
+                        if (ratio > 0.0)
+                                target = min + (current - min) * ratio;
+                        else
+                                target = min + value * (normal - min);
+
+                        volume = (guint) CLAMP (target, min, max);
+
+                        if (mate_mixer_stream_control_get_volume (control) != volume)
+                                mate_mixer_stream_control_set_volume (control, volume);
+                }
+        }
+
+        bar->priv->group_writing = FALSE;
+
+        update_group_state (bar);
+}
+
+static void
+set_volume (GvcAppBar *bar, gdouble value)
+{
+        if (has_target (bar) == FALSE)
+                return;
+
+        value = CLAMP (value, bar->priv->min_volume, bar->priv->max_volume);
+
+        if (bar->priv->group != NULL) {
+                set_group_volume (bar, value);
+
+                gtk_widget_queue_draw (GTK_WIDGET (bar));
+                return;
+        }
+
+        /* Mirror GvcChannelBar, which mutes the control at the lowest volume */
+        if (bar->priv->control_flags & MATE_MIXER_STREAM_CONTROL_MUTE_WRITABLE) {
+                bar->priv->mute = (value <= bar->priv->min_volume);
+                mate_mixer_stream_control_set_mute (bar->priv->control, bar->priv->mute);
+        }
+
+        if (bar->priv->control_flags & MATE_MIXER_STREAM_CONTROL_VOLUME_WRITABLE) {
+                bar->priv->volume = value;
+                mate_mixer_stream_control_set_volume (bar->priv->control, (guint) value);
+        }
+
+        gtk_widget_queue_draw (GTK_WIDGET (bar));
+}
+
+static void
+toggle_mute (GvcAppBar *bar)
+{
+        if (has_target (bar) == FALSE)
+                return;
+
+        if (!(bar->priv->control_flags & MATE_MIXER_STREAM_CONTROL_MUTE_WRITABLE))
+                return;
+
+        bar->priv->mute = !bar->priv->mute;
+
+        if (bar->priv->group != NULL) {
+                guint i;
+
+                bar->priv->group_writing = TRUE;
+
+                for (i = 0; i < bar->priv->group->len; i++) {
+                        MateMixerStreamControl *control = g_ptr_array_index (bar->priv->group, i);
+
+                        if (!(mate_mixer_stream_control_get_flags (control) & MATE_MIXER_STREAM_CONTROL_MUTE_WRITABLE))
+                                continue;
+
+                        if (mate_mixer_stream_control_get_mute (control) != bar->priv->mute)
+                                mate_mixer_stream_control_set_mute (control, bar->priv->mute);
+                }
+
+                bar->priv->group_writing = FALSE;
+
+                update_group_state (bar);
+        } else
+                mate_mixer_stream_control_set_mute (bar->priv->control, bar->priv->mute);
+
+        gtk_widget_queue_draw (GTK_WIDGET (bar));
+}
+
+static void
+set_expanded (GvcAppBar *bar, gboolean expanded)
+{
+        if (bar->priv->expanded == expanded)
+                return;
+
+        bar->priv->expanded = expanded;
+
+        gtk_widget_queue_draw (GTK_WIDGET (bar));
+
+        g_object_notify_by_pspec (G_OBJECT (bar), properties[PROP_EXPANDED]);
+}
+
+static const gchar *
+get_mute_icon_name (GvcAppBar *bar)
+{
+        if (bar->priv->input == TRUE)
+                return (bar->priv->mute == TRUE)
+                        ? "microphone-sensitivity-muted"
+                        : "microphone-sensitivity-high";
+        else
+                return (bar->priv->mute == TRUE)
+                        ? "audio-volume-muted"
+                        : "audio-volume-high";
+}
+
+static void
+update_name_layout (GvcAppBar *bar)
+{
+        g_clear_object (&bar->priv->name_layout);
+
+        if (bar->priv->name == NULL)
+                return;
+
+        bar->priv->name_layout = gtk_widget_create_pango_layout (GTK_WIDGET (bar),
+                                                                 bar->priv->name);
+
+        pango_layout_set_ellipsize (bar->priv->name_layout, PANGO_ELLIPSIZE_END);
+        pango_layout_set_width (bar->priv->name_layout,
+                                get_name_width (bar) * PANGO_SCALE);
+}
+
+static void
+update_font_metrics (GvcAppBar *bar)
+{
+        PangoContext     *context;
+        PangoFontMetrics *metrics;
+
+        context = gtk_widget_get_pango_context (GTK_WIDGET (bar));
+        metrics = pango_context_get_metrics (context,
+                                             pango_context_get_font_description (context),
+                                             pango_context_get_language (context));
+
+        bar->priv->name_width =
+                PANGO_PIXELS (pango_font_metrics_get_approximate_char_width (metrics) * NAME_WIDTH_CHARS);
+        bar->priv->text_height =
+                PANGO_PIXELS (pango_font_metrics_get_ascent (metrics) +
+                              pango_font_metrics_get_descent (metrics));
+
+        pango_font_metrics_unref (metrics);
+}
+
+static void
+notify_accessible_value (GvcAppBar *bar)
+{
+        /* Only notify when assistive technologies created the accessible */
+        if (bar->priv->accessible != NULL)
+                g_object_notify (G_OBJECT (bar->priv->accessible), "accessible-value");
+}
+
+static void
+on_control_volume_notify (MateMixerStreamControl *control,
+                          GParamSpec             *pspec,
+                          GvcAppBar              *bar)
+{
+        bar->priv->volume = mate_mixer_stream_control_get_volume (control);
+
+        gtk_widget_queue_draw (GTK_WIDGET (bar));
+        notify_accessible_value (bar);
+}
+
+static void
+on_control_mute_notify (MateMixerStreamControl *control,
+                        GParamSpec             *pspec,
+                        GvcAppBar              *bar)
+{
+        bar->priv->mute = mate_mixer_stream_control_get_mute (control);
+
+        gtk_widget_queue_draw (GTK_WIDGET (bar));
+}
+
+static void
+on_group_member_notify (MateMixerStreamControl *control,
+                        GParamSpec             *pspec,
+                        GvcAppBar              *bar)
+{
+        if (bar->priv->group_writing == TRUE)
+                return;
+
+        update_group_state (bar);
+
+        gtk_widget_queue_draw (GTK_WIDGET (bar));
+        notify_accessible_value (bar);
+}
+
+static void
+clear_control (GvcAppBar *bar)
+{
+        if (bar->priv->control == NULL)
+                return;
+
+        g_signal_handlers_disconnect_by_data (G_OBJECT (bar->priv->control), bar);
+        g_clear_object (&bar->priv->control);
+
+        g_object_notify_by_pspec (G_OBJECT (bar), properties[PROP_CONTROL]);
+}
+
+static void
+clear_group (GvcAppBar *bar)
+{
+        guint i;
+
+        if (bar->priv->group == NULL)
+                return;
+
+        for (i = 0; i < bar->priv->group->len; i++)
+                g_signal_handlers_disconnect_by_data (g_ptr_array_index (bar->priv->group, i),
+                                                      bar);
+
+        g_ptr_array_unref (bar->priv->group);
+        bar->priv->group = NULL;
+}
+
+static void
+reset_state (GvcAppBar *bar)
+{
+        bar->priv->control_flags = MATE_MIXER_STREAM_CONTROL_NO_FLAGS;
+        bar->priv->volume        = 0;
+        bar->priv->min_volume    = 0;
+        bar->priv->max_volume    = 0;
+        bar->priv->mute          = FALSE;
+        bar->priv->input         = FALSE;
+}
+
+static gboolean
+is_input_control (MateMixerStreamControl *control)
+{
+        MateMixerStream *stream;
+
+        stream = mate_mixer_stream_control_get_stream (control);
+
+        return stream != NULL &&
+               mate_mixer_stream_get_direction (stream) == MATE_MIXER_DIRECTION_INPUT;
+}
+
+MateMixerStreamControl *
+gvc_app_bar_get_control (GvcAppBar *bar)
+{
+        g_return_val_if_fail (GVC_IS_APP_BAR (bar), NULL);
+
+        return bar->priv->control;
+}
+
+void
+gvc_app_bar_set_control (GvcAppBar *bar, MateMixerStreamControl *control)
+{
+        g_return_if_fail (GVC_IS_APP_BAR (bar));
+
+        if (bar->priv->control == control)
+                return;
+
+        if (control != NULL)
+                g_object_ref (control);
+
+        if (bar->priv->control != NULL) {
+                g_signal_handlers_disconnect_by_data (G_OBJECT (bar->priv->control), bar);
+                g_object_unref (bar->priv->control);
+        }
+
+        /* A bar shows either a single control or a group */
+        if (control != NULL)
+                clear_group (bar);
+
+        bar->priv->control = control;
+        bar->priv->dragging = FALSE;
+
+        if (control != NULL) {
+                bar->priv->control_flags = mate_mixer_stream_control_get_flags (control);
+                bar->priv->min_volume    = mate_mixer_stream_control_get_min_volume (control);
+                bar->priv->max_volume    = mate_mixer_stream_control_get_normal_volume (control);
+                bar->priv->volume        = mate_mixer_stream_control_get_volume (control);
+                bar->priv->mute          = mate_mixer_stream_control_get_mute (control);
+                bar->priv->input         = is_input_control (control);
+
+                g_signal_connect (G_OBJECT (control),
+                                  "notify::volume",
+                                  G_CALLBACK (on_control_volume_notify),
+                                  bar);
+                g_signal_connect (G_OBJECT (control),
+                                  "notify::mute",
+                                  G_CALLBACK (on_control_mute_notify),
+                                  bar);
+        } else if (bar->priv->group == NULL)
+                reset_state (bar);
+
+        gtk_widget_queue_draw (GTK_WIDGET (bar));
+        notify_accessible_value (bar);
+
+        g_object_notify_by_pspec (G_OBJECT (bar), properties[PROP_CONTROL]);
+}
+
+GPtrArray *
+gvc_app_bar_get_group (GvcAppBar *bar)
+{
+        g_return_val_if_fail (GVC_IS_APP_BAR (bar), NULL);
+
+        return bar->priv->group;
+}
+
+/**
+ * gvc_app_bar_set_group:
+ * @bar: a #GvcAppBar
+ * @controls: (element-type MateMixerStreamControl) (allow-none): array of
+ *            stream controls
+ *
+ * Binds the bar to a group of stream controls. The array is referenced and
+ * must not be modified afterwards, pass a new array when the members of the
+ * group change.
+ */
+void
+gvc_app_bar_set_group (GvcAppBar *bar, GPtrArray *controls)
+{
+        guint i;
+
+        g_return_if_fail (GVC_IS_APP_BAR (bar));
+
+        if (bar->priv->group == controls)
+                return;
+
+        clear_group (bar);
+        clear_control (bar);
+
+        bar->priv->dragging = FALSE;
+
+        if (controls != NULL) {
+                bar->priv->group = g_ptr_array_ref (controls);
+
+                for (i = 0; i < controls->len; i++) {
+                        MateMixerStreamControl *control = g_ptr_array_index (controls, i);
+
+                        g_signal_connect (G_OBJECT (control),
+                                          "notify::volume",
+                                          G_CALLBACK (on_group_member_notify),
+                                          bar);
+                        g_signal_connect (G_OBJECT (control),
+                                          "notify::mute",
+                                          G_CALLBACK (on_group_member_notify),
+                                          bar);
+                }
+
+                update_group_state (bar);
+
+                bar->priv->input = (controls->len > 0 &&
+                                    is_input_control (g_ptr_array_index (controls, 0)));
+        } else
+                reset_state (bar);
+
+        gtk_widget_queue_draw (GTK_WIDGET (bar));
+        notify_accessible_value (bar);
+}
+
+const gchar *
+gvc_app_bar_get_name (GvcAppBar *bar)
+{
+        g_return_val_if_fail (GVC_IS_APP_BAR (bar), NULL);
+
+        return bar->priv->name;
+}
+
+void
+gvc_app_bar_set_name (GvcAppBar *bar, const gchar *name)
+{
+        g_return_if_fail (GVC_IS_APP_BAR (bar));
+
+        if (g_strcmp0 (name, bar->priv->name) == 0)
+                return;
+
+        g_free (bar->priv->name);
+        bar->priv->name = g_strdup (name);
+
+        update_name_layout (bar);
+
+        gtk_widget_queue_draw (GTK_WIDGET (bar));
+
+        if (bar->priv->accessible != NULL)
+                g_object_notify (G_OBJECT (bar->priv->accessible), "accessible-name");
+
+        g_object_notify_by_pspec (G_OBJECT (bar), properties[PROP_NAME]);
+}
+
+const gchar *
+gvc_app_bar_get_icon_name (GvcAppBar *bar)
+{
+        g_return_val_if_fail (GVC_IS_APP_BAR (bar), NULL);
+
+        return bar->priv->icon_name;
+}
+
+void
+gvc_app_bar_set_icon_name (GvcAppBar *bar, const gchar *icon_name)
+{
+        g_return_if_fail (GVC_IS_APP_BAR (bar));
+
+        if (g_strcmp0 (icon_name, bar->priv->icon_name) == 0)
+                return;
+
+        g_free (bar->priv->icon_name);
+        bar->priv->icon_name = g_strdup (icon_name);
+
+        gtk_widget_queue_draw (GTK_WIDGET (bar));
+
+        g_object_notify_by_pspec (G_OBJECT (bar), properties[PROP_ICON_NAME]);
+}
+
+guint
+gvc_app_bar_get_indent (GvcAppBar *bar)
+{
+        g_return_val_if_fail (GVC_IS_APP_BAR (bar), 0);
+
+        return bar->priv->indent;
+}
+
+void
+gvc_app_bar_set_indent (GvcAppBar *bar, guint indent)
+{
+        g_return_if_fail (GVC_IS_APP_BAR (bar));
+
+        if (bar->priv->indent == indent)
+                return;
+
+        bar->priv->indent = indent;
+
+        update_name_layout (bar);
+        bar_calc_layout (bar);
+
+        gtk_widget_queue_draw (GTK_WIDGET (bar));
+
+        g_object_notify_by_pspec (G_OBJECT (bar), properties[PROP_INDENT]);
+}
+
+gboolean
+gvc_app_bar_get_expander (GvcAppBar *bar)
+{
+        g_return_val_if_fail (GVC_IS_APP_BAR (bar), FALSE);
+
+        return bar->priv->expander;
+}
+
+void
+gvc_app_bar_set_expander (GvcAppBar *bar, gboolean expander)
+{
+        g_return_if_fail (GVC_IS_APP_BAR (bar));
+
+        expander = !!expander;
+
+        if (bar->priv->expander == expander)
+                return;
+
+        bar->priv->expander = expander;
+
+        gtk_widget_queue_draw (GTK_WIDGET (bar));
+
+        g_object_notify_by_pspec (G_OBJECT (bar), properties[PROP_EXPANDER]);
+}
+
+gboolean
+gvc_app_bar_get_expanded (GvcAppBar *bar)
+{
+        g_return_val_if_fail (GVC_IS_APP_BAR (bar), FALSE);
+
+        return bar->priv->expanded;
+}
+
+void
+gvc_app_bar_set_expanded (GvcAppBar *bar, gboolean expanded)
+{
+        g_return_if_fail (GVC_IS_APP_BAR (bar));
+
+        set_expanded (bar, !!expanded);
+}
+
+static void
+gvc_app_bar_set_property (GObject       *object,
+                          guint          prop_id,
+                          const GValue  *value,
+                          GParamSpec    *pspec)
+{
+        GvcAppBar *self = GVC_APP_BAR (object);
+
+        switch (prop_id) {
+        case PROP_CONTROL:
+                gvc_app_bar_set_control (self, g_value_get_object (value));
+                break;
+        case PROP_NAME:
+                gvc_app_bar_set_name (self, g_value_get_string (value));
+                break;
+        case PROP_ICON_NAME:
+                gvc_app_bar_set_icon_name (self, g_value_get_string (value));
+                break;
+        case PROP_INDENT:
+                gvc_app_bar_set_indent (self, g_value_get_uint (value));
+                break;
+        case PROP_EXPANDER:
+                gvc_app_bar_set_expander (self, g_value_get_boolean (value));
+                break;
+        case PROP_EXPANDED:
+                gvc_app_bar_set_expanded (self, g_value_get_boolean (value));
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+                break;
+        }
+}
+
+static void
+gvc_app_bar_get_property (GObject     *object,
+                          guint        prop_id,
+                          GValue      *value,
+                          GParamSpec  *pspec)
+{
+        GvcAppBar *self = GVC_APP_BAR (object);
+
+        switch (prop_id) {
+        case PROP_CONTROL:
+                g_value_set_object (value, self->priv->control);
+                break;
+        case PROP_NAME:
+                g_value_set_string (value, self->priv->name);
+                break;
+        case PROP_ICON_NAME:
+                g_value_set_string (value, self->priv->icon_name);
+                break;
+        case PROP_INDENT:
+                g_value_set_uint (value, self->priv->indent);
+                break;
+        case PROP_EXPANDER:
+                g_value_set_boolean (value, self->priv->expander);
+                break;
+        case PROP_EXPANDED:
+                g_value_set_boolean (value, self->priv->expanded);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+                break;
+        }
+}
+
+static void
+gvc_app_bar_get_preferred_width (GtkWidget *widget,
+                                 gint      *minimum,
+                                 gint      *natural)
+{
+        GvcAppBar *bar = GVC_APP_BAR (widget);
+        gint       width;
+
+        width = PADDING + ICON_SIZE + SPACING +
+                bar->priv->name_width + SPACING +
+                SLIDER_MIN_WIDTH + SPACING +
+                MUTE_SIZE + PADDING;
+
+        if (minimum != NULL)
+                *minimum = width;
+        if (natural != NULL)
+                *natural = width;
+}
+
+static void
+gvc_app_bar_get_preferred_height (GtkWidget *widget,
+                                  gint      *minimum,
+                                  gint      *natural)
+{
+        GvcAppBar *bar = GVC_APP_BAR (widget);
+        gint       height;
+
+        height = MAX (ICON_SIZE, bar->priv->text_height);
+        height = MAX (height, 2 * KNOB_RADIUS) + 2 * PADDING;
+
+        if (minimum != NULL)
+                *minimum = height;
+        if (natural != NULL)
+                *natural = height;
+}
+
+static void
+gvc_app_bar_size_allocate (GtkWidget *widget, GtkAllocation *allocation)
+{
+        GvcAppBar *bar = GVC_APP_BAR (widget);
+
+        gtk_widget_set_allocation (widget, allocation);
+
+        if (gtk_widget_get_realized (widget) == TRUE)
+                gdk_window_move_resize (bar->priv->event_window,
+                                        allocation->x,
+                                        allocation->y,
+                                        allocation->width,
+                                        allocation->height);
+
+        bar_calc_layout (bar);
+}
+
+static void
+gvc_app_bar_realize (GtkWidget *widget)
+{
+        GvcAppBar     *bar = GVC_APP_BAR (widget);
+        GtkAllocation  allocation;
+        GdkWindowAttr  attributes;
+        GdkWindow     *window;
+
+        gtk_widget_set_realized (widget, TRUE);
+        gtk_widget_get_allocation (widget, &allocation);
+
+        window = gtk_widget_get_parent_window (widget);
+        gtk_widget_set_window (widget, g_object_ref (window));
+
+        attributes.window_type = GDK_WINDOW_CHILD;
+        attributes.wclass      = GDK_INPUT_ONLY;
+        attributes.x           = allocation.x;
+        attributes.y           = allocation.y;
+        attributes.width       = allocation.width;
+        attributes.height      = allocation.height;
+        attributes.event_mask  = gtk_widget_get_events (widget) |
+                                 GDK_BUTTON_PRESS_MASK |
+                                 GDK_BUTTON_RELEASE_MASK |
+                                 GDK_POINTER_MOTION_MASK |
+                                 GDK_SCROLL_MASK;
+
+        bar->priv->event_window = gdk_window_new (window,
+                                                  &attributes,
+                                                  GDK_WA_X | GDK_WA_Y);
+
+        gtk_widget_register_window (widget, bar->priv->event_window);
+}
+
+static void
+gvc_app_bar_unrealize (GtkWidget *widget)
+{
+        GvcAppBar *bar = GVC_APP_BAR (widget);
+
+        if (bar->priv->event_window != NULL) {
+                gtk_widget_unregister_window (widget, bar->priv->event_window);
+                gdk_window_destroy (bar->priv->event_window);
+                bar->priv->event_window = NULL;
+        }
+
+        GTK_WIDGET_CLASS (gvc_app_bar_parent_class)->unrealize (widget);
+}
+
+static void
+gvc_app_bar_map (GtkWidget *widget)
+{
+        GvcAppBar *bar = GVC_APP_BAR (widget);
+
+        GTK_WIDGET_CLASS (gvc_app_bar_parent_class)->map (widget);
+
+        gdk_window_show (bar->priv->event_window);
+}
+
+static void
+gvc_app_bar_unmap (GtkWidget *widget)
+{
+        GvcAppBar *bar = GVC_APP_BAR (widget);
+
+        bar->priv->dragging = FALSE;
+
+        gdk_window_hide (bar->priv->event_window);
+
+        GTK_WIDGET_CLASS (gvc_app_bar_parent_class)->unmap (widget);
+}
+
+static void
+gvc_app_bar_style_updated (GtkWidget *widget)
+{
+        GvcAppBar *bar = GVC_APP_BAR (widget);
+
+        GTK_WIDGET_CLASS (gvc_app_bar_parent_class)->style_updated (widget);
+
+        /* The font may have changed, icons are refreshed by the icon cache */
+        update_font_metrics (bar);
+        update_name_layout (bar);
+
+        gtk_widget_queue_resize (widget);
+}
+
+static void
+gvc_app_bar_direction_changed (GtkWidget *widget, GtkTextDirection previous)
+{
+        GTK_WIDGET_CLASS (gvc_app_bar_parent_class)->direction_changed (widget, previous);
+
+        bar_calc_layout (GVC_APP_BAR (widget));
+}
+
+static void
+rounded_rectangle (cairo_t *cr,
+                   gdouble  x,
+                   gdouble  y,
+                   gdouble  width,
+                   gdouble  height)
+{
+        gdouble radius = height / 2;
+
+        cairo_new_sub_path (cr);
+        cairo_arc (cr, x + width - radius, y + radius, radius, -G_PI_2, G_PI_2);
+        cairo_arc (cr, x + radius, y + radius, radius, G_PI_2, 3 * G_PI_2);
+        cairo_close_path (cr);
+}
+
+static gboolean
+gvc_app_bar_draw (GtkWidget *widget, cairo_t *cr)
+{
+        GvcAppBar       *bar = GVC_APP_BAR (widget);
+        AppBarLayout    *layout = &bar->priv->layout;
+        GtkStyleContext *context;
+        GdkRGBA          color_bg;
+        GdkRGBA          color_fg;
+        GdkRGBA          color_dark;
+        cairo_surface_t *surface;
+        gdouble          trough_x;
+        gdouble          trough_y;
+        gdouble          trough_width;
+        gdouble          knob_x;
+        gdouble          fill_x;
+        gdouble          fill_width;
+
+        context = gtk_widget_get_style_context (widget);
+
+        /* Same colors as GvcLevelBar */
+        gtk_style_context_save (context);
+        gtk_style_context_set_state (context, GTK_STATE_FLAG_NORMAL);
+        gtk_style_context_get_background_color (context,
+                                                gtk_style_context_get_state (context),
+                                                &color_bg);
+        mate_desktop_gtk_style_get_dark_color (context,
+                                               gtk_style_context_get_state (context),
+                                               &color_dark);
+
+        gtk_style_context_set_state (context, GTK_STATE_FLAG_SELECTED);
+        gtk_style_context_get_background_color (context,
+                                                gtk_style_context_get_state (context),
+                                                &color_fg);
+        gtk_style_context_restore (context);
+
+        if (bar->priv->expander == TRUE && bar->priv->indent > 0) {
+                gtk_style_context_save (context);
+                gtk_style_context_add_class (context, GTK_STYLE_CLASS_EXPANDER);
+
+                if (bar->priv->expanded == TRUE)
+                        gtk_style_context_set_state (context, GTK_STATE_FLAG_CHECKED);
+                else
+                        gtk_style_context_set_state (context, GTK_STATE_FLAG_NORMAL);
+
+                gtk_render_expander (context, cr,
+                                     layout->expander.x,
+                                     layout->expander.y + (layout->expander.height - EXPANDER_SIZE) / 2,
+                                     EXPANDER_SIZE,
+                                     EXPANDER_SIZE);
+
+                gtk_style_context_restore (context);
+        }
+
+        /* Application icon, the icon is loaded in the background and the
+         * bar is redrawn when it is ready */
+        surface = gvc_icon_cache_get_surface (widget, bar->priv->icon_name, ICON_SIZE);
+        if (surface != NULL)
+                gtk_render_icon_surface (context, cr,
+                                         surface,
+                                         layout->icon.x,
+                                         layout->icon.y);
+        else if (bar->priv->icon_name != NULL) {
+                /* Keep the place of the icon until it is loaded */
+                cairo_save (cr);
+                cairo_rectangle (cr,
+                                 layout->icon.x + 0.5,
+                                 layout->icon.y + 0.5,
+                                 ICON_SIZE - 1,
+                                 ICON_SIZE - 1);
+                gdk_cairo_set_source_rgba (cr, &color_bg);
+                cairo_fill (cr);
+                cairo_restore (cr);
+        }
+
+        /* Application name */
+        if (bar->priv->name_layout != NULL) {
+                gint height;
+
+                pango_layout_get_pixel_size (bar->priv->name_layout, NULL, &height);
+
+                gtk_render_layout (context, cr,
+                                   layout->name.x,
+                                   layout->name.y + (layout->name.height - height) / 2,
+                                   bar->priv->name_layout);
+        }
+
+        /* Volume slider */
+        trough_x     = layout->slider.x + KNOB_RADIUS;
+        trough_y     = layout->slider.y + (layout->slider.height - TROUGH_HEIGHT) / 2;
+        trough_width = MAX (0, layout->slider.width - 2 * KNOB_RADIUS);
+        knob_x       = get_slider_x (bar, get_fraction (bar));
+
+        cairo_save (cr);
+        cairo_set_line_width (cr, 1);
+
+        rounded_rectangle (cr, trough_x + 0.5, trough_y + 0.5, trough_width - 1, TROUGH_HEIGHT);
+        gdk_cairo_set_source_rgba (cr, &color_bg);
+        cairo_fill_preserve (cr);
+        gdk_cairo_set_source_rgba (cr, &color_dark);
+        cairo_stroke (cr);
+
+        /* The filled part always starts at the low end of the trough */
+        if (bar->priv->mute == FALSE) {
+                if (gtk_widget_get_direction (widget) == GTK_TEXT_DIR_RTL) {
+                        fill_x     = knob_x;
+                        fill_width = trough_x + trough_width - knob_x;
+                } else {
+                        fill_x     = trough_x;
+                        fill_width = knob_x - trough_x;
+                }
+
+                rounded_rectangle (cr,
+                                   fill_x + 0.5,
+                                   trough_y + 0.5,
+                                   MAX (0, fill_width - 1),
+                                   TROUGH_HEIGHT);
+                gdk_cairo_set_source_rgba (cr, &color_fg);
+                cairo_fill (cr);
+        }
+
+        cairo_arc (cr,
+                   knob_x,
+                   layout->slider.y + layout->slider.height / 2.0,
+                   KNOB_RADIUS - 0.5,
+                   0,
+                   2 * G_PI);
+        gdk_cairo_set_source_rgba (cr, (bar->priv->mute == TRUE) ? &color_bg : &color_fg);
+        cairo_fill_preserve (cr);
+        gdk_cairo_set_source_rgba (cr, &color_dark);
+        cairo_stroke (cr);
+
+        cairo_restore (cr);
+
+        if (gtk_widget_has_visible_focus (widget) == TRUE)
+                gtk_render_focus (context, cr,
+                                  layout->slider.x,
+                                  layout->slider.y + PADDING / 2,
+                                  layout->slider.width,
+                                  layout->slider.height - PADDING);
+
+        /* Mute indicator, shared by all the bars through the icon cache */
+        surface = gvc_icon_cache_get_surface (widget, get_mute_icon_name (bar), MUTE_SIZE);
+        if (surface != NULL)
+                gtk_render_icon_surface (context, cr,
+                                         surface,
+                                         layout->mute.x,
+                                         layout->mute.y + (layout->mute.height - MUTE_SIZE) / 2);
+
+        return FALSE;
+}
+
+static gboolean
+gvc_app_bar_button_press_event (GtkWidget *widget, GdkEventButton *event)
+{
+        GvcAppBar *bar = GVC_APP_BAR (widget);
+
+        if (event->type != GDK_BUTTON_PRESS || event->button != GDK_BUTTON_PRIMARY)
+                return FALSE;
+
+        if (has_target (bar) == FALSE)
+                return FALSE;
+
+        gtk_widget_grab_focus (widget);
+
+        if (bar->priv->expander == TRUE &&
+            bar->priv->indent > 0 &&
+            rectangle_contains (&bar->priv->layout.expander, event->x, event->y)) {
+                set_expanded (bar, !bar->priv->expanded);
+                return TRUE;
+        }
+
+        if (rectangle_contains (&bar->priv->layout.mute, event->x, event->y)) {
+                toggle_mute (bar);
+                return TRUE;
+        }
+
+        if (rectangle_contains (&bar->priv->layout.slider, event->x, event->y)) {
+                gdouble fraction = get_fraction_at_x (bar, event->x);
+
+                bar->priv->dragging = TRUE;
+
+                set_volume (bar,
+                            bar->priv->min_volume +
+                            fraction * (bar->priv->max_volume - bar->priv->min_volume));
+                return TRUE;
+        }
+
+        return FALSE;
+}
+
+static gboolean
+gvc_app_bar_motion_notify_event (GtkWidget *widget, GdkEventMotion *event)
+{
+        GvcAppBar *bar = GVC_APP_BAR (widget);
+        gdouble    fraction;
+
+        if (bar->priv->dragging == FALSE)
+                return FALSE;
+
+        fraction = get_fraction_at_x (bar, event->x);
+
+        set_volume (bar,
+                    bar->priv->min_volume +
+                    fraction * (bar->priv->max_volume - bar->priv->min_volume));
+        return TRUE;
+}
+
+static gboolean
+gvc_app_bar_button_release_event (GtkWidget *widget, GdkEventButton *event)
+{
+        GvcAppBar *bar = GVC_APP_BAR (widget);
+
+        if (bar->priv->dragging == FALSE || event->button != GDK_BUTTON_PRIMARY)
+                return FALSE;
+
+        bar->priv->dragging = FALSE;
+        return TRUE;
+}
+
+static gboolean
+gvc_app_bar_grab_broken_event (GtkWidget *widget, GdkEventGrabBroken *event)
+{
+        GVC_APP_BAR (widget)->priv->dragging = FALSE;
+
+        return FALSE;
+}
+
+static void
+step_volume (GvcAppBar *bar, gdouble fraction)
+{
+        set_volume (bar,
+                    bar->priv->volume +
+                    fraction * (bar->priv->max_volume - bar->priv->min_volume));
+}
+
+static gboolean
+gvc_app_bar_scroll_event (GtkWidget *widget, GdkEventScroll *event)
+{
+        GvcAppBar         *bar = GVC_APP_BAR (widget);
+        GdkScrollDirection direction = event->direction;
+
+        if (has_target (bar) == FALSE)
+                return FALSE;
+
+        /* Switch direction for RTL */
+        if (gtk_widget_get_direction (widget) == GTK_TEXT_DIR_RTL) {
+                if (direction == GDK_SCROLL_RIGHT)
+                        direction = GDK_SCROLL_LEFT;
+                else if (direction == GDK_SCROLL_LEFT)
+                        direction = GDK_SCROLL_RIGHT;
+        }
+
+        /* Use the same 5 % step as GvcChannelBar */
+        if (direction == GDK_SCROLL_UP || direction == GDK_SCROLL_RIGHT)
+                step_volume (bar, 0.05);
+        else if (direction == GDK_SCROLL_DOWN || direction == GDK_SCROLL_LEFT)
+                step_volume (bar, -0.05);
+        else
+                return FALSE;
+
+        return TRUE;
+}
+
+static gboolean
+gvc_app_bar_key_press_event (GtkWidget *widget, GdkEventKey *event)
+{
+        GvcAppBar *bar = GVC_APP_BAR (widget);
+        gboolean   rtl;
+
+        if (has_target (bar) == FALSE)
+                return FALSE;
+
+        rtl = (gtk_widget_get_direction (widget) == GTK_TEXT_DIR_RTL);
+
+        /* Steps match the adjustment increments of GvcChannelBar */
+        switch (event->keyval) {
+        case GDK_KEY_Up:
+        case GDK_KEY_KP_Up:
+                step_volume (bar, 0.01);
+                return TRUE;
+        case GDK_KEY_Down:
+        case GDK_KEY_KP_Down:
+                step_volume (bar, -0.01);
+                return TRUE;
+        case GDK_KEY_Right:
+        case GDK_KEY_KP_Right:
+                step_volume (bar, rtl ? -0.01 : 0.01);
+                return TRUE;
+        case GDK_KEY_Left:
+        case GDK_KEY_KP_Left:
+                step_volume (bar, rtl ? 0.01 : -0.01);
+                return TRUE;
+        case GDK_KEY_Page_Up:
+        case GDK_KEY_KP_Page_Up:
+                step_volume (bar, 1.0 / 15.0);
+                return TRUE;
+        case GDK_KEY_Page_Down:
+        case GDK_KEY_KP_Page_Down:
+                step_volume (bar, -1.0 / 15.0);
+                return TRUE;
+        case GDK_KEY_Home:
+        case GDK_KEY_KP_Home:
+                set_volume (bar, bar->priv->min_volume);
+                return TRUE;
+        case GDK_KEY_End:
+        case GDK_KEY_KP_End:
+                set_volume (bar, bar->priv->max_volume);
+                return TRUE;
+        case GDK_KEY_space:
+        case GDK_KEY_KP_Space:
+        case GDK_KEY_m:
+        case GDK_KEY_M:
+                toggle_mute (bar);
+                return TRUE;
+        /* Same keys as GtkTreeView uses for expanding rows */
+        case GDK_KEY_plus:
+        case GDK_KEY_KP_Add:
+        case GDK_KEY_asterisk:
+        case GDK_KEY_KP_Multiply:
+                if (bar->priv->expander == FALSE)
+                        break;
+                set_expanded (bar, TRUE);
+                return TRUE;
+        case GDK_KEY_minus:
+        case GDK_KEY_KP_Subtract:
+                if (bar->priv->expander == FALSE)
+                        break;
+                set_expanded (bar, FALSE);
+                return TRUE;
+        default:
+                break;
+        }
+
+        return GTK_WIDGET_CLASS (gvc_app_bar_parent_class)->key_press_event (widget, event);
+}
+
+static void
+on_scale_factor_notify (GvcAppBar *bar)
+{
+        /* Icons are cached per scale, so this only needs a redraw */
+        gtk_widget_queue_draw (GTK_WIDGET (bar));
+}
+
+static void
+gvc_app_bar_class_init (GvcAppBarClass *klass)
+{
+        GObjectClass   *object_class = G_OBJECT_CLASS (klass);
+        GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
+
+        object_class->dispose = gvc_app_bar_dispose;
+        object_class->finalize = gvc_app_bar_finalize;
+        object_class->set_property = gvc_app_bar_set_property;
+        object_class->get_property = gvc_app_bar_get_property;
+
+        widget_class->draw = gvc_app_bar_draw;
+        widget_class->get_preferred_width = gvc_app_bar_get_preferred_width;
+        widget_class->get_preferred_height = gvc_app_bar_get_preferred_height;
+        widget_class->size_allocate = gvc_app_bar_size_allocate;
+        widget_class->realize = gvc_app_bar_realize;
+        widget_class->unrealize = gvc_app_bar_unrealize;
+        widget_class->map = gvc_app_bar_map;
+        widget_class->unmap = gvc_app_bar_unmap;
+        widget_class->style_updated = gvc_app_bar_style_updated;
+        widget_class->direction_changed = gvc_app_bar_direction_changed;
+        widget_class->button_press_event = gvc_app_bar_button_press_event;
+        widget_class->button_release_event = gvc_app_bar_button_release_event;
+        widget_class->motion_notify_event = gvc_app_bar_motion_notify_event;
+        widget_class->grab_broken_event = gvc_app_bar_grab_broken_event;
+        widget_class->scroll_event = gvc_app_bar_scroll_event;
+        widget_class->key_press_event = gvc_app_bar_key_press_event;
+
+        gtk_widget_class_set_accessible_type (widget_class, gvc_app_bar_accessible_get_type ());
+#if GTK_CHECK_VERSION (3, 20, 0)
+        gtk_widget_class_set_css_name (widget_class, "gvc-app-bar");
+#endif
+
+        properties[PROP_CONTROL] =
+                g_param_spec_object ("control",
+                                     "Control",
+                                     "MateMixer stream control",
+                                     MATE_MIXER_TYPE_STREAM_CONTROL,
+                                     G_PARAM_READWRITE |
+                                     G_PARAM_STATIC_STRINGS);
+
+        properties[PROP_NAME] =
+                g_param_spec_string ("name",
+                                     "Name",
+                                     "Name to display for this application",
+                                     NULL,
+                                     G_PARAM_READWRITE |
+                                     G_PARAM_STATIC_STRINGS);
+
+        properties[PROP_ICON_NAME] =
+                g_param_spec_string ("icon-name",
+                                     "Icon name",
+                                     "Name of the icon to display for this application",
+                                     NULL,
+                                     G_PARAM_READWRITE |
+                                     G_PARAM_STATIC_STRINGS);
+
+        properties[PROP_INDENT] =
+                g_param_spec_uint ("indent",
+                                   "Indent",
+                                   "Number of indentation columns in front of the icon",
+                                   0,
+                                   G_MAXUINT,
+                                   0,
+                                   G_PARAM_READWRITE |
+                                   G_PARAM_STATIC_STRINGS);
+
+        properties[PROP_EXPANDER] =
+                g_param_spec_boolean ("expander",
+                                      "Expander",
+                                      "Whether to show an expander in the last indentation column",
+                                      FALSE,
+                                      G_PARAM_READWRITE |
+                                      G_PARAM_STATIC_STRINGS);
+
+        properties[PROP_EXPANDED] =
+                g_param_spec_boolean ("expanded",
+                                      "Expanded",
+                                      "Whether the expander is expanded",
+                                      FALSE,
+                                      G_PARAM_READWRITE |
+                                      G_PARAM_STATIC_STRINGS);
+
+        g_object_class_install_properties (object_class, N_PROPERTIES, properties);
+
+        g_type_class_add_private (klass, sizeof (GvcAppBarPrivate));
+}
+
+static void
+gvc_app_bar_init (GvcAppBar *bar)
+{
+        bar->priv = GVC_APP_BAR_GET_PRIVATE (bar);
+
+        gtk_widget_set_has_window (GTK_WIDGET (bar), FALSE);
+        gtk_widget_set_can_focus (GTK_WIDGET (bar), TRUE);
+
+        update_font_metrics (bar);
+
+        g_signal_connect (G_OBJECT (bar),
+                          "notify::scale-factor",
+                          G_CALLBACK (on_scale_factor_notify),
+                          NULL);
+}
+
+static void
+gvc_app_bar_dispose (GObject *object)
+{
+        GvcAppBar *bar = GVC_APP_BAR (object);
+
+        if (bar->priv->control != NULL) {
+                g_signal_handlers_disconnect_by_data (G_OBJECT (bar->priv->control), bar);
+                g_clear_object (&bar->priv->control);
+        }
+
+        clear_group (bar);
+
+        g_clear_object (&bar->priv->name_layout);
+
+        G_OBJECT_CLASS (gvc_app_bar_parent_class)->dispose (object);
+}
+
+static void
+gvc_app_bar_finalize (GObject *object)
+{
+        GvcAppBar *bar = GVC_APP_BAR (object);
+
+        g_free (bar->priv->name);
+        g_free (bar->priv->icon_name);
+
+        G_OBJECT_CLASS (gvc_app_bar_parent_class)->finalize (object);
+}
+
+GtkWidget *
+gvc_app_bar_new (MateMixerStreamControl *control)
+{
+        return g_object_new (GVC_TYPE_APP_BAR,
+                             "control", control,
+                             NULL);
+}
+
+/* Accessible implementation */
+static GvcAppBar *
+accessible_get_bar (gpointer accessible)
+{
+        GtkWidget *widget;
+
+        widget = gtk_accessible_get_widget (GTK_ACCESSIBLE (accessible));
+        if (widget == NULL)
+                return NULL;
+
+        return GVC_APP_BAR (widget);
+}
+
+static void
+gvc_app_bar_accessible_initialize (AtkObject *object, gpointer data)
+{
+        ATK_OBJECT_CLASS (gvc_app_bar_accessible_parent_class)->initialize (object, data);
+
+        GVC_APP_BAR (data)->priv->accessible = object;
+
+        atk_object_set_role (object, ATK_ROLE_SLIDER);
+}
+
+static const gchar *
+gvc_app_bar_accessible_get_name (AtkObject *object)
+{
+        const gchar *name;
+        GvcAppBar   *bar;
+
+        name = ATK_OBJECT_CLASS (gvc_app_bar_accessible_parent_class)->get_name (object);
+        if (name != NULL)
+                return name;
+
+        bar = accessible_get_bar (object);
+        if (bar == NULL)
+                return NULL;
+
+        return bar->priv->name;
+}
+
+static AtkStateSet *
+gvc_app_bar_accessible_ref_state_set (AtkObject *object)
+{
+        AtkStateSet *state_set;
+        GvcAppBar   *bar;
+
+        state_set = ATK_OBJECT_CLASS (gvc_app_bar_accessible_parent_class)->ref_state_set (object);
+
+        bar = accessible_get_bar (object);
+        if (bar != NULL && bar->priv->expander == TRUE) {
+                atk_state_set_add_state (state_set, ATK_STATE_EXPANDABLE);
+
+                if (bar->priv->expanded == TRUE)
+                        atk_state_set_add_state (state_set, ATK_STATE_EXPANDED);
+        }
+
+        return state_set;
+}
+
+static void
+gvc_app_bar_accessible_class_init (GvcAppBarAccessibleClass *klass)
+{
+        AtkObjectClass *atk_class = ATK_OBJECT_CLASS (klass);
+
+        atk_class->initialize = gvc_app_bar_accessible_initialize;
+        atk_class->get_name = gvc_app_bar_accessible_get_name;
+        atk_class->ref_state_set = gvc_app_bar_accessible_ref_state_set;
+}
+
+static void
+gvc_app_bar_accessible_init (GvcAppBarAccessible *accessible)
+{
+}
+
+static void
+gvc_app_bar_accessible_get_current_value (AtkValue *value, GValue *result)
+{
+        GvcAppBar *bar = accessible_get_bar (value);
+
+        g_value_init (result, G_TYPE_DOUBLE);
+        g_value_set_double (result, (bar != NULL) ? bar->priv->volume : 0.0);
+}
+
+static void
+gvc_app_bar_accessible_get_minimum_value (AtkValue *value, GValue *result)
+{
+        GvcAppBar *bar = accessible_get_bar (value);
+
+        g_value_init (result, G_TYPE_DOUBLE);
+        g_value_set_double (result, (bar != NULL) ? bar->priv->min_volume : 0.0);
+}
+
+static void
+gvc_app_bar_accessible_get_maximum_value (AtkValue *value, GValue *result)
+{
+        GvcAppBar *bar = accessible_get_bar (value);
+
+        g_value_init (result, G_TYPE_DOUBLE);
+        g_value_set_double (result, (bar != NULL) ? bar->priv->max_volume : 0.0);
+}
+
+static void
+gvc_app_bar_accessible_get_minimum_increment (AtkValue *value, GValue *result)
+{
+        GvcAppBar *bar = accessible_get_bar (value);
+
+        g_value_init (result, G_TYPE_DOUBLE);
+        g_value_set_double (result,
+                            (bar != NULL)
+                            ? (bar->priv->max_volume - bar->priv->min_volume) / 100.0
+                            : 0.0);
+}
+
+static gboolean
+gvc_app_bar_accessible_set_current_value (AtkValue *value, const GValue *new_value)
+{
+        GvcAppBar *bar = accessible_get_bar (value);
+
+        if (bar == NULL || has_target (bar) == FALSE)
+                return FALSE;
+        if (G_VALUE_HOLDS_DOUBLE (new_value) == FALSE)
+                return FALSE;
+
+        set_volume (bar, g_value_get_double (new_value));
+        return TRUE;
+}
+
+static void
+gvc_app_bar_accessible_value_init (AtkValueIface *iface)
+{
+        iface->get_current_value = gvc_app_bar_accessible_get_current_value;
+        iface->get_minimum_value = gvc_app_bar_accessible_get_minimum_value;
+        iface->get_maximum_value = gvc_app_bar_accessible_get_maximum_value;
+        iface->get_minimum_increment = gvc_app_bar_accessible_get_minimum_increment;
+        iface->set_current_value = gvc_app_bar_accessible_set_current_value;
+}
+
+static gint
+gvc_app_bar_accessible_get_n_actions (AtkAction *action)
+{
+        GvcAppBar *bar = accessible_get_bar (action);
+
+        if (bar != NULL && bar->priv->expander == TRUE)
+                return 2;
+
+        return 1;
+}
+
+static gboolean
+gvc_app_bar_accessible_do_action (AtkAction *action, gint i)
+{
+        GvcAppBar *bar = accessible_get_bar (action);
+
+        if (bar == NULL)
+                return FALSE;
+
+        if (i == 0) {
+                toggle_mute (bar);
+                return TRUE;
+        }
+        if (i == 1 && bar->priv->expander == TRUE) {
+                set_expanded (bar, !bar->priv->expanded);
+                return TRUE;
+        }
+        return FALSE;
+}
+
+static const gchar *
+gvc_app_bar_accessible_get_action_name (AtkAction *action, gint i)
+{
+        switch (i) {
+        case 0:
+                return "toggle-mute";
+        case 1:
+                return "expand-or-collapse";
+        default:
+                return NULL;
+        }
+}
+
+static const gchar *
+gvc_app_bar_accessible_get_localized_name (AtkAction *action, gint i)
+{
+        switch (i) {
+        case 0:
+                return _("Toggle mute");
+        case 1:
+                return _("Expand or collapse");
+        default:
+                return NULL;
+        }
+}
+
+static void
+gvc_app_bar_accessible_action_init (AtkActionIface *iface)
+{
+        iface->get_n_actions = gvc_app_bar_accessible_get_n_actions;
+        iface->do_action = gvc_app_bar_accessible_do_action;
+        iface->get_name = gvc_app_bar_accessible_get_action_name;
+        iface->get_localized_name = gvc_app_bar_accessible_get_localized_name;
+}
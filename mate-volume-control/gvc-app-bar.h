@@ -0,0 +1,88 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2026 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef __GVC_APP_BAR_H
+#define __GVC_APP_BAR_H
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gtk/gtk.h>
+
+#include <libmatemixer/matemixer.h>
+
+G_BEGIN_DECLS
+
+#define GVC_TYPE_APP_BAR         (gvc_app_bar_get_type ())
+#define GVC_APP_BAR(o)           (G_TYPE_CHECK_INSTANCE_CAST ((o), GVC_TYPE_APP_BAR, GvcAppBar))
+#define GVC_APP_BAR_CLASS(k)     (G_TYPE_CHECK_CLASS_CAST((k), GVC_TYPE_APP_BAR, GvcAppBarClass))
+#define GVC_IS_APP_BAR(o)        (G_TYPE_CHECK_INSTANCE_TYPE ((o), GVC_TYPE_APP_BAR))
+#define GVC_IS_APP_BAR_CLASS(k)  (G_TYPE_CHECK_CLASS_TYPE ((k), GVC_TYPE_APP_BAR))
+#define GVC_APP_BAR_GET_CLASS(o) (G_TYPE_INSTANCE_GET_CLASS ((o), GVC_TYPE_APP_BAR, GvcAppBarClass))
+
+typedef struct _GvcAppBar         GvcAppBar;
+typedef struct _GvcAppBarClass    GvcAppBarClass;
+typedef struct _GvcAppBarPrivate  GvcAppBarPrivate;
+
+struct _GvcAppBar
+{
+        GtkWidget              parent;
+        GvcAppBarPrivate      *priv;
+};
+
+struct _GvcAppBarClass
+{
+        GtkWidgetClass         parent_class;
+};
+
+GType                   gvc_app_bar_get_type            (void) G_GNUC_CONST;
+
+GtkWidget *             gvc_app_bar_new                 (MateMixerStreamControl *control);
+
+MateMixerStreamControl *gvc_app_bar_get_control         (GvcAppBar              *bar);
+void                    gvc_app_bar_set_control         (GvcAppBar              *bar,
+                                                         MateMixerStreamControl *control);
+
+const gchar *           gvc_app_bar_get_name            (GvcAppBar              *bar);
+void                    gvc_app_bar_set_name            (GvcAppBar              *bar,
+                                                         const gchar            *name);
+
+const gchar *           gvc_app_bar_get_icon_name       (GvcAppBar              *bar);
+void                    gvc_app_bar_set_icon_name       (GvcAppBar              *bar,
+                                                         const gchar            *icon_name);
+
+GPtrArray *             gvc_app_bar_get_group           (GvcAppBar              *bar);
+void                    gvc_app_bar_set_group           (GvcAppBar              *bar,
+                                                         GPtrArray              *controls);
+
+guint                   gvc_app_bar_get_indent          (GvcAppBar              *bar);
+void                    gvc_app_bar_set_indent          (GvcAppBar              *bar,
+                                                         guint                   indent);
+
+gboolean                gvc_app_bar_get_expander        (GvcAppBar              *bar);
+void                    gvc_app_bar_set_expander        (GvcAppBar              *bar,
+                                                         gboolean                expander);
+
+gboolean                gvc_app_bar_get_expanded        (GvcAppBar              *bar);
+void                    gvc_app_bar_set_expanded        (GvcAppBar              *bar,
+                                                         gboolean                expanded);
+
+G_END_DECLS
+
+#endif /* __GVC_APP_BAR_H */
@@ -0,0 +1,1495 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2026 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* A scrollable list of application streams.
+ *
+ * The list keeps a plain array of entries and only creates GvcAppBar rows
+ * for the entries inside the visible part of the list. When the list is
+ * scrolled, the existing rows are bound to the newly visible entries instead
+ * of creating new widgets. Rows which are no longer needed are kept aside
+ * for a while and released when the list stays idle.
+ *
+ * Each entry carries a normalized search key built once when it is added,
+ * filtering the list is then a plain substring scan over these keys. Only
+ * the entries matching the filter are laid out.
+ *
+ * In the grouped mode, entries sharing an application id are shown under a
+ * single row controlling all of them, which can be expanded to show the
+ * individual streams.
+ *
+ * GListModel and gtk_list_box_bind_model() would need GLib 2.44 and GTK 3.16
+ * and GtkListBox creates a row for every item anyway, so the list implements
+ * GtkScrollable itself. */
+
+#include <string.h>
+#include <glib.h>
+#include <glib-object.h>
+#include <gtk/gtk.h>
+
+#include <libmatemixer/matemixer.h>
+
+#include "gvc-app-bar.h"
+#include "gvc-app-list.h"
+#include "gvc-utils.h"
+
+#define GVC_APP_LIST_GET_PRIVATE(o) (G_TYPE_INSTANCE_GET_PRIVATE ((o), GVC_TYPE_APP_LIST, GvcAppListPrivate))
+
+#define BORDER_WIDTH      12
+#define ROW_SPACING       12
+
+/* Unused rows kept for reuse and how long they are kept */
+#define SPARE_ROWS_SIZE   8
+#define SPARE_ROWS_IDLE   30
+
+/* Index of the visible item a row is bound to */
+#define ROW_INDEX_KEY     "gvc-app-list-index"
+
+typedef struct _AppListGroup AppListGroup;
+
+typedef struct {
+        MateMixerStreamControl *control;
+        gchar                  *name;
+        gchar                  *icon_name;
+        gchar                  *label;
+        gchar                  *key;
+        AppListGroup           *group;
+} AppListEntry;
+
+struct _AppListGroup {
+        gchar                  *app_id;
+        GPtrArray              *entries;
+        GPtrArray              *controls;
+        gboolean                expanded;
+        guint                   serial;
+};
+
+/* A row of the list: a plain entry, a group or an entry inside a group */
+typedef struct {
+        AppListEntry           *entry;
+        AppListGroup           *group;
+} AppListItem;
+
+struct _GvcAppListPrivate
+{
+        GPtrArray     *entries;
+        GHashTable    *entries_by_name;
+        GHashTable    *groups;
+        GArray        *visible;
+        gchar         *filter;
+        gboolean       grouped;
+        guint          serial;
+        gchar         *focus_name;
+        GPtrArray     *rows;
+        gint           row_height;
+        gint           row_width;
+        GSList        *spare_rows;
+        guint          spare_rows_size;
+        guint          spare_rows_id;
+        GtkAdjustment *hadjustment;
+        GtkAdjustment *vadjustment;
+        guint          hscroll_policy : 1;
+        guint          vscroll_policy : 1;
+};
+
+enum
+{
+        PROP_0,
+        PROP_HADJUSTMENT,
+        PROP_VADJUSTMENT,
+        PROP_HSCROLL_POLICY,
+        PROP_VSCROLL_POLICY,
+        PROP_GROUPED
+};
+
+static void gvc_app_list_class_init (GvcAppListClass *klass);
+static void gvc_app_list_init       (GvcAppList      *list);
+static void gvc_app_list_dispose    (GObject         *object);
+static void gvc_app_list_finalize   (GObject         *object);
+
+static void layout_rows             (GvcAppList      *list);
+static gchar *get_row_control_name  (GtkWidget       *row);
+
+static void on_row_expanded_notify  (GvcAppBar       *bar,
+                                     GParamSpec      *pspec,
+                                     GvcAppList      *list);
+
+G_DEFINE_TYPE_WITH_CODE (GvcAppList, gvc_app_list, GTK_TYPE_CONTAINER,
+                         G_IMPLEMENT_INTERFACE (GTK_TYPE_SCROLLABLE, NULL))
+
+static void
+free_entry (AppListEntry *entry)
+{
+        g_object_unref (entry->control);
+        g_free (entry->name);
+        g_free (entry->icon_name);
+        g_free (entry->label);
+        g_free (entry->key);
+        g_slice_free (AppListEntry, entry);
+}
+
+static void
+free_group (AppListGroup *group)
+{
+        g_free (group->app_id);
+        g_ptr_array_unref (group->entries);
+        g_ptr_array_unref (group->controls);
+        g_slice_free (AppListGroup, group);
+}
+
+static void
+update_group_controls (AppListGroup *group)
+{
+        guint i;
+
+        /* Rows keep a reference to the array they are bound to, so it is
+         * replaced rather than modified and the rows notice the change */
+        if (group->controls != NULL)
+                g_ptr_array_unref (group->controls);
+
+        group->controls = g_ptr_array_new_full (group->entries->len, g_object_unref);
+
+        for (i = 0; i < group->entries->len; i++) {
+                AppListEntry *entry = g_ptr_array_index (group->entries, i);
+
+                g_ptr_array_add (group->controls, g_object_ref (entry->control));
+        }
+}
+
+static gboolean
+is_group_shown (AppListGroup *group)
+{
+        /* Applications with a single stream are shown as plain rows */
+        return group != NULL && group->entries->len > 1;
+}
+
+static void
+clear_spare_rows (GvcAppList *list)
+{
+        g_slist_free_full (list->priv->spare_rows, g_object_unref);
+
+        list->priv->spare_rows = NULL;
+        list->priv->spare_rows_size = 0;
+}
+
+static gboolean
+on_spare_rows_idle (GvcAppList *list)
+{
+        g_debug ("Releasing %u unused application rows", list->priv->spare_rows_size);
+
+        clear_spare_rows (list);
+
+        list->priv->spare_rows_id = 0;
+        return G_SOURCE_REMOVE;
+}
+
+static void
+touch_spare_rows (GvcAppList *list)
+{
+        /* The spare rows are released once they have not been used for a while */
+        if (list->priv->spare_rows_id != 0)
+                g_source_remove (list->priv->spare_rows_id);
+
+        if (list->priv->spare_rows != NULL)
+                list->priv->spare_rows_id =
+                        g_timeout_add_seconds (SPARE_ROWS_IDLE,
+                                               (GSourceFunc) on_spare_rows_idle,
+                                               list);
+        else
+                list->priv->spare_rows_id = 0;
+}
+
+/* Every row is created here, including the one used for measuring, so all
+ * of them report the expander */
+static GtkWidget *
+new_row (GvcAppList *list)
+{
+        GtkWidget *row;
+
+        row = g_object_ref_sink (gvc_app_bar_new (NULL));
+
+        g_signal_connect (G_OBJECT (row),
+                          "notify::expanded",
+                          G_CALLBACK (on_row_expanded_notify),
+                          list);
+        return row;
+}
+
+static GtkWidget *
+take_row (GvcAppList *list)
+{
+        GtkWidget *row;
+
+        if (list->priv->spare_rows != NULL) {
+                row = list->priv->spare_rows->data;
+
+                list->priv->spare_rows =
+                        g_slist_delete_link (list->priv->spare_rows,
+                                             list->priv->spare_rows);
+                list->priv->spare_rows_size--;
+
+                touch_spare_rows (list);
+        } else
+                row = new_row (list);
+
+        gtk_widget_show (row);
+        gtk_widget_set_parent (row, GTK_WIDGET (list));
+
+        /* The parent holds its own reference now */
+        g_object_unref (row);
+
+        return row;
+}
+
+static void
+release_row (GvcAppList *list, GtkWidget *row)
+{
+        g_object_ref (row);
+
+        gtk_widget_unparent (row);
+
+        /* Do not keep the controls alive while the row waits for reuse */
+        gvc_app_bar_set_control (GVC_APP_BAR (row), NULL);
+        gvc_app_bar_set_group (GVC_APP_BAR (row), NULL);
+
+        if (list->priv->spare_rows_size >= SPARE_ROWS_SIZE) {
+                g_object_unref (row);
+                return;
+        }
+
+        list->priv->spare_rows = g_slist_prepend (list->priv->spare_rows, row);
+        list->priv->spare_rows_size++;
+
+        touch_spare_rows (list);
+}
+
+static void
+bind_row (GvcAppList *list, GtkWidget *row, AppListItem *item)
+{
+        GvcAppBar *bar = GVC_APP_BAR (row);
+
+        g_signal_handlers_block_by_func (G_OBJECT (row), on_row_expanded_notify, list);
+
+        /* The setters return early when the row already shows the item */
+        if (item->entry == NULL) {
+                AppListEntry *first = g_ptr_array_index (item->group->entries, 0);
+
+                gvc_app_bar_set_name (bar, first->name);
+                gvc_app_bar_set_icon_name (bar, first->icon_name);
+                gvc_app_bar_set_group (bar, item->group->controls);
+                gvc_app_bar_set_indent (bar, 1);
+                gvc_app_bar_set_expander (bar, TRUE);
+                gvc_app_bar_set_expanded (bar, item->group->expanded);
+        } else {
+                AppListEntry *entry = item->entry;
+
+                /* Streams of a group are told apart by their labels */
+                if (item->group != NULL && entry->label != NULL)
+                        gvc_app_bar_set_name (bar, entry->label);
+                else
+                        gvc_app_bar_set_name (bar, entry->name);
+
+                gvc_app_bar_set_icon_name (bar, entry->icon_name);
+                gvc_app_bar_set_control (bar, entry->control);
+                gvc_app_bar_set_expander (bar, FALSE);
+
+                if (item->group != NULL)
+                        gvc_app_bar_set_indent (bar, 2);
+                else if (list->priv->grouped == TRUE)
+                        gvc_app_bar_set_indent (bar, 1);
+                else
+                        gvc_app_bar_set_indent (bar, 0);
+        }
+
+        g_signal_handlers_unblock_by_func (G_OBJECT (row), on_row_expanded_notify, list);
+}
+
+static void
+measure_rows (GvcAppList *list)
+{
+        GtkWidget *row;
+        gboolean   temporary = FALSE;
+
+        if (list->priv->rows->len > 0)
+                row = g_ptr_array_index (list->priv->rows, 0);
+        else if (list->priv->spare_rows != NULL)
+                row = list->priv->spare_rows->data;
+        else {
+                row = new_row (list);
+                temporary = TRUE;
+        }
+
+        /* All the rows have the same size */
+        gtk_widget_get_preferred_height (row, &list->priv->row_height, NULL);
+        gtk_widget_get_preferred_width (row, &list->priv->row_width, NULL);
+
+        if (temporary == TRUE) {
+                /* Keep it for the first row to be shown */
+                list->priv->spare_rows = g_slist_prepend (list->priv->spare_rows, row);
+                list->priv->spare_rows_size++;
+
+                touch_spare_rows (list);
+        }
+}
+
+static gint
+get_total_height (GvcAppList *list)
+{
+        guint n = list->priv->visible->len;
+
+        if (n == 0)
+                return 0;
+
+        return 2 * BORDER_WIDTH +
+               n * list->priv->row_height +
+               (n - 1) * ROW_SPACING;
+}
+
+static guint
+get_row_index (GtkWidget *row)
+{
+        return GPOINTER_TO_UINT (g_object_get_data (G_OBJECT (row), ROW_INDEX_KEY));
+}
+
+static gboolean
+row_shows_item (GtkWidget *row, AppListItem *item)
+{
+        GvcAppBar *bar = GVC_APP_BAR (row);
+
+        if (item->entry == NULL)
+                return gvc_app_bar_get_control (bar) == NULL &&
+                       gvc_app_bar_get_group (bar) == item->group->controls;
+
+        return gvc_app_bar_get_control (bar) == item->entry->control;
+}
+
+/* Returns the index of the visible item shown by @row, or -1 when the item
+ * is no longer visible */
+static gint
+find_row_item (GvcAppList *list, GtkWidget *row)
+{
+        guint index;
+        guint i;
+
+        /* Unless the visible items have changed the row is still bound to
+         * the same index */
+        index = get_row_index (row);
+        if (index < list->priv->visible->len &&
+            row_shows_item (row, &g_array_index (list->priv->visible, AppListItem, index)) == TRUE)
+                return index;
+
+        for (i = 0; i < list->priv->visible->len; i++)
+                if (row_shows_item (row, &g_array_index (list->priv->visible, AppListItem, i)) == TRUE)
+                        return i;
+
+        return -1;
+}
+
+static GtkWidget *
+find_item_row (GvcAppList *list, guint index)
+{
+        guint i;
+
+        for (i = 0; i < list->priv->rows->len; i++) {
+                GtkWidget *row = g_ptr_array_index (list->priv->rows, i);
+
+                if (get_row_index (row) == index)
+                        return row;
+        }
+        return NULL;
+}
+
+static void
+layout_rows (GvcAppList *list)
+{
+        GtkAllocation allocation;
+        GtkWidget    *focus_row;
+        GPtrArray    *unused;
+        gint          focus_index = -1;
+        gint          stride;
+        gdouble       offset;
+        guint         first;
+        guint         count;
+        guint         i;
+
+        gtk_widget_get_allocation (GTK_WIDGET (list), &allocation);
+
+        if (list->priv->row_height <= 0)
+                return;
+
+        stride = list->priv->row_height + ROW_SPACING;
+        offset = gtk_adjustment_get_value (list->priv->vadjustment);
+
+        /* Find the range of entries which intersect the viewport */
+        first = MAX (0, offset - BORDER_WIDTH) / stride;
+        count = allocation.height / stride + 2;
+
+        if (first >= list->priv->visible->len)
+                count = 0;
+        else
+                count = MIN (count, list->priv->visible->len - first);
+
+        /* The focused row stays bound to its entry even when it is scrolled
+         * out, otherwise the keyboard would silently move to another stream */
+        focus_row = gtk_container_get_focus_child (GTK_CONTAINER (list));
+        if (focus_row != NULL)
+                focus_index = find_row_item (list, focus_row);
+
+        unused = list->priv->rows;
+        list->priv->rows = g_ptr_array_sized_new (count + 1);
+
+        if (focus_index >= 0)
+                g_ptr_array_remove (unused, focus_row);
+
+        for (i = 0; i < count; i++) {
+                GtkWidget *row;
+
+                if ((gint) (first + i) == focus_index) {
+                        row = focus_row;
+                } else if (unused->len > 0) {
+                        row = g_ptr_array_index (unused, 0);
+                        g_ptr_array_remove_index (unused, 0);
+                } else {
+                        row = take_row (list);
+                }
+
+                g_object_set_data (G_OBJECT (row), ROW_INDEX_KEY, GUINT_TO_POINTER (first + i));
+                g_ptr_array_add (list->priv->rows, row);
+        }
+
+        if (focus_index >= 0 &&
+            ((guint) focus_index < first || (guint) focus_index >= first + count)) {
+                g_object_set_data (G_OBJECT (focus_row), ROW_INDEX_KEY, GUINT_TO_POINTER (focus_index));
+                g_ptr_array_add (list->priv->rows, focus_row);
+        }
+
+        for (i = 0; i < unused->len; i++)
+                release_row (list, g_ptr_array_index (unused, i));
+
+        g_ptr_array_free (unused, TRUE);
+
+        for (i = 0; i < list->priv->rows->len; i++) {
+                GtkWidget     *row   = g_ptr_array_index (list->priv->rows, i);
+                guint          index = get_row_index (row);
+                AppListItem   *item  = &g_array_index (list->priv->visible, AppListItem, index);
+                GtkAllocation  child;
+
+                bind_row (list, row, item);
+
+                /* The entry of the focused row is gone and the row shows
+                 * another one now */
+                if (row == focus_row && focus_index < 0) {
+                        g_free (list->priv->focus_name);
+                        list->priv->focus_name = get_row_control_name (row);
+                }
+
+                child.x      = BORDER_WIDTH;
+                child.y      = BORDER_WIDTH + index * stride - (gint) offset;
+                child.width  = MAX (1, allocation.width - 2 * BORDER_WIDTH);
+                child.height = list->priv->row_height;
+
+                gtk_widget_size_allocate (row, &child);
+        }
+}
+
+/* Scrolls the item at @index fully into view and returns its row */
+static GtkWidget *
+show_item (GvcAppList *list, guint index)
+{
+        GtkAllocation allocation;
+        GtkWidget    *row;
+        gdouble       value;
+        gint          y;
+
+        gtk_widget_get_allocation (GTK_WIDGET (list), &allocation);
+
+        y     = BORDER_WIDTH + index * (list->priv->row_height + ROW_SPACING);
+        value = gtk_adjustment_get_value (list->priv->vadjustment);
+
+        if (y - BORDER_WIDTH < value)
+                gtk_adjustment_set_value (list->priv->vadjustment, y - BORDER_WIDTH);
+        else if (y + list->priv->row_height + BORDER_WIDTH > value + allocation.height)
+                gtk_adjustment_set_value (list->priv->vadjustment,
+                                          y + list->priv->row_height + BORDER_WIDTH - allocation.height);
+
+        row = find_item_row (list, index);
+        if (row == NULL) {
+                layout_rows (list);
+                row = find_item_row (list, index);
+        }
+        return row;
+}
+
+static void
+configure_adjustments (GvcAppList *list)
+{
+        GtkAllocation allocation;
+        gdouble       upper;
+        gdouble       value;
+
+        gtk_widget_get_allocation (GTK_WIDGET (list), &allocation);
+
+        upper = MAX (get_total_height (list), allocation.height);
+        value = CLAMP (gtk_adjustment_get_value (list->priv->vadjustment),
+                       0,
+                       upper - allocation.height);
+
+        gtk_adjustment_configure (list->priv->vadjustment,
+                                  value,
+                                  0,
+                                  upper,
+                                  list->priv->row_height + ROW_SPACING,
+                                  allocation.height * 0.9,
+                                  allocation.height);
+
+        gtk_adjustment_configure (list->priv->hadjustment,
+                                  0,
+                                  0,
+                                  allocation.width,
+                                  allocation.width * 0.1,
+                                  allocation.width * 0.9,
+                                  allocation.width);
+}
+
+static void
+on_adjustment_value_changed (GtkAdjustment *adjustment, GvcAppList *list)
+{
+        if (gtk_widget_get_realized (GTK_WIDGET (list)) == FALSE)
+                return;
+
+        layout_rows (list);
+
+        gtk_widget_queue_draw (GTK_WIDGET (list));
+}
+
+static void
+set_adjustment (GvcAppList     *list,
+                GtkAdjustment **target,
+                GtkAdjustment  *adjustment)
+{
+        if (adjustment != NULL && *target == adjustment)
+                return;
+
+        if (*target != NULL) {
+                g_signal_handlers_disconnect_by_func (G_OBJECT (*target),
+                                                      on_adjustment_value_changed,
+                                                      list);
+                g_object_unref (*target);
+        }
+
+        if (adjustment == NULL)
+                adjustment = gtk_adjustment_new (0.0, 0.0, 0.0, 0.0, 0.0, 0.0);
+
+        *target = g_object_ref_sink (adjustment);
+
+        g_signal_connect (G_OBJECT (adjustment),
+                          "value-changed",
+                          G_CALLBACK (on_adjustment_value_changed),
+                          list);
+
+        gtk_widget_queue_resize (GTK_WIDGET (list));
+}
+
+static gboolean
+entry_matches (AppListEntry *entry, const gchar *filter)
+{
+        if (filter == NULL)
+                return TRUE;
+
+        return strstr (entry->key, filter) != NULL;
+}
+
+static void
+append_item (GArray *items, AppListEntry *entry, AppListGroup *group)
+{
+        AppListItem item;
+
+        item.entry = entry;
+        item.group = group;
+
+        g_array_append_val (items, item);
+}
+
+static void
+rebuild_visible (GvcAppList *list, gboolean refine)
+{
+        GArray *visible;
+        guint   i;
+
+        if (refine == TRUE && list->priv->grouped == FALSE) {
+                /* When the filter only gets longer, the entries which did
+                 * not match before cannot match now, so only the visible
+                 * ones are scanned */
+                visible = g_array_sized_new (FALSE, FALSE,
+                                             sizeof (AppListItem),
+                                             list->priv->visible->len);
+
+                for (i = 0; i < list->priv->visible->len; i++) {
+                        AppListItem *item = &g_array_index (list->priv->visible, AppListItem, i);
+
+                        if (entry_matches (item->entry, list->priv->filter) == TRUE)
+                                append_item (visible, item->entry, NULL);
+                }
+
+                g_array_free (list->priv->visible, TRUE);
+                list->priv->visible = visible;
+                return;
+        }
+
+        g_array_set_size (list->priv->visible, 0);
+
+        /* Groups are placed at the position of their first matching entry,
+         * the serial marks the groups which have already been placed */
+        list->priv->serial++;
+
+        for (i = 0; i < list->priv->entries->len; i++) {
+                AppListEntry *entry = g_ptr_array_index (list->priv->entries, i);
+                AppListGroup *group = entry->group;
+                guint         j;
+
+                if (entry_matches (entry, list->priv->filter) == FALSE)
+                        continue;
+
+                if (list->priv->grouped == FALSE || is_group_shown (group) == FALSE) {
+                        append_item (list->priv->visible, entry, NULL);
+                        continue;
+                }
+
+                if (group->serial == list->priv->serial)
+                        continue;
+
+                group->serial = list->priv->serial;
+
+                append_item (list->priv->visible, NULL, group);
+
+                if (group->expanded == FALSE)
+                        continue;
+
+                for (j = 0; j < group->entries->len; j++) {
+                        AppListEntry *member = g_ptr_array_index (group->entries, j);
+
+                        if (entry_matches (member, list->priv->filter) == TRUE)
+                                append_item (list->priv->visible, member, group);
+                }
+        }
+}
+
+static void
+on_row_expanded_notify (GvcAppBar *bar, GParamSpec *pspec, GvcAppList *list)
+{
+        AppListItem *item;
+        guint        index;
+
+        index = get_row_index (GTK_WIDGET (bar));
+        if (index >= list->priv->visible->len)
+                return;
+
+        item = &g_array_index (list->priv->visible, AppListItem, index);
+
+        if (item->entry != NULL ||
+            item->group->expanded == gvc_app_bar_get_expanded (bar))
+                return;
+
+        item->group->expanded = gvc_app_bar_get_expanded (bar);
+
+        /* The item is gone after this */
+        rebuild_visible (list, FALSE);
+
+        gtk_widget_queue_resize (GTK_WIDGET (list));
+}
+
+static gchar *
+create_entry_key (MateMixerStreamControl *control, const gchar *name)
+{
+        MateMixerAppInfo *info;
+        const gchar      *fields[3];
+
+        info = mate_mixer_stream_control_get_app_info (control);
+
+        fields[0] = name;
+        fields[1] = (info != NULL) ? mate_mixer_app_info_get_id (info) : NULL;
+        fields[2] = mate_mixer_stream_control_get_label (control);
+
+        return gvc_search_key_new (fields, G_N_ELEMENTS (fields));
+}
+
+static void
+add_entry_to_group (GvcAppList *list, AppListEntry *entry)
+{
+        MateMixerAppInfo *info;
+        AppListGroup     *group;
+        const gchar      *app_id;
+
+        info = mate_mixer_stream_control_get_app_info (entry->control);
+        if (info == NULL)
+                return;
+
+        app_id = mate_mixer_app_info_get_id (info);
+        if (app_id == NULL)
+                return;
+
+        group = g_hash_table_lookup (list->priv->groups, app_id);
+        if (group == NULL) {
+                group = g_slice_new0 (AppListGroup);
+                group->app_id  = g_strdup (app_id);
+                group->entries = g_ptr_array_new ();
+
+                g_hash_table_insert (list->priv->groups, group->app_id, group);
+        }
+
+        g_ptr_array_add (group->entries, entry);
+        update_group_controls (group);
+
+        entry->group = group;
+}
+
+static void
+remove_entry_from_group (GvcAppList *list, AppListEntry *entry)
+{
+        AppListGroup *group = entry->group;
+
+        if (group == NULL)
+                return;
+
+        g_ptr_array_remove (group->entries, entry);
+
+        if (group->entries->len == 0)
+                g_hash_table_remove (list->priv->groups, group->app_id);
+        else
+                update_group_controls (group);
+
+        entry->group = NULL;
+}
+
+void
+gvc_app_list_add (GvcAppList             *list,
+                  MateMixerStreamControl *control,
+                  const gchar            *name,
+                  const gchar            *icon_name)
+{
+        AppListEntry *entry;
+
+        g_return_if_fail (GVC_IS_APP_LIST (list));
+        g_return_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control));
+
+        if (g_hash_table_contains (list->priv->entries_by_name,
+                                   mate_mixer_stream_control_get_name (control)) == TRUE)
+                return;
+
+        entry = g_slice_new0 (AppListEntry);
+        entry->control   = g_object_ref (control);
+        entry->name      = g_strdup (name);
+        entry->icon_name = g_strdup (icon_name);
+        entry->label     = g_strdup (mate_mixer_stream_control_get_label (control));
+        entry->key       = create_entry_key (control, name);
+
+        g_ptr_array_add (list->priv->entries, entry);
+
+        add_entry_to_group (list, entry);
+
+        if (list->priv->grouped == TRUE)
+                rebuild_visible (list, FALSE);
+        else if (entry_matches (entry, list->priv->filter) == TRUE)
+                append_item (list->priv->visible, entry, NULL);
+
+        /* The key is owned by the control, which the entry keeps */
+        g_hash_table_insert (list->priv->entries_by_name,
+                             (gpointer) mate_mixer_stream_control_get_name (control),
+                             entry);
+
+        gtk_widget_queue_resize (GTK_WIDGET (list));
+}
+
+gboolean
+gvc_app_list_remove (GvcAppList *list, const gchar *control_name)
+{
+        AppListEntry *entry;
+
+        g_return_val_if_fail (GVC_IS_APP_LIST (list), FALSE);
+        g_return_val_if_fail (control_name != NULL, FALSE);
+
+        entry = g_hash_table_lookup (list->priv->entries_by_name, control_name);
+        if (entry == NULL)
+                return FALSE;
+
+        g_hash_table_remove (list->priv->entries_by_name, control_name);
+
+        remove_entry_from_group (list, entry);
+
+        /* The entries array frees the entry */
+        g_ptr_array_remove (list->priv->entries, entry);
+
+        rebuild_visible (list, FALSE);
+
+        gtk_widget_queue_resize (GTK_WIDGET (list));
+        return TRUE;
+}
+
+gboolean
+gvc_app_list_contains (GvcAppList *list, const gchar *control_name)
+{
+        g_return_val_if_fail (GVC_IS_APP_LIST (list), FALSE);
+        g_return_val_if_fail (control_name != NULL, FALSE);
+
+        return g_hash_table_contains (list->priv->entries_by_name, control_name);
+}
+
+guint
+gvc_app_list_get_n_items (GvcAppList *list)
+{
+        g_return_val_if_fail (GVC_IS_APP_LIST (list), 0);
+
+        return list->priv->entries->len;
+}
+
+guint
+gvc_app_list_get_n_visible (GvcAppList *list)
+{
+        g_return_val_if_fail (GVC_IS_APP_LIST (list), 0);
+
+        return list->priv->visible->len;
+}
+
+void
+gvc_app_list_set_filter (GvcAppList *list, const gchar *text)
+{
+        gchar    *filter = NULL;
+        gboolean  refine;
+
+        g_return_if_fail (GVC_IS_APP_LIST (list));
+
+        if (text != NULL && *text != '\0')
+                filter = gvc_search_text_normalize (text);
+
+        if (g_strcmp0 (filter, list->priv->filter) == 0) {
+                g_free (filter);
+                return;
+        }
+
+        refine = filter != NULL &&
+                 list->priv->filter != NULL &&
+                 strstr (filter, list->priv->filter) != NULL;
+
+        g_free (list->priv->filter);
+        list->priv->filter = filter;
+
+        rebuild_visible (list, refine);
+
+        g_debug ("Application filter matches %u of %u entries",
+                 list->priv->visible->len,
+                 list->priv->entries->len);
+
+        /* Start from the top of the filtered list */
+        gtk_adjustment_set_value (list->priv->vadjustment, 0);
+
+        gtk_widget_queue_resize (GTK_WIDGET (list));
+}
+
+static AppListEntry *
+get_focus_entry (GvcAppList *list)
+{
+        if (list->priv->focus_name == NULL)
+                return NULL;
+
+        return g_hash_table_lookup (list->priv->entries_by_name, list->priv->focus_name);
+}
+
+static void
+begin_batch (GvcAppList *list)
+{
+        guint i;
+
+        /* Queue the change notifications of the controls, so that the rows
+         * are updated once when the whole batch has been written */
+        for (i = 0; i < list->priv->entries->len; i++) {
+                AppListEntry *entry = g_ptr_array_index (list->priv->entries, i);
+
+                g_object_freeze_notify (G_OBJECT (entry->control));
+        }
+}
+
+static void
+end_batch (GvcAppList *list)
+{
+        guint i;
+
+        for (i = 0; i < list->priv->entries->len; i++) {
+                AppListEntry *entry = g_ptr_array_index (list->priv->entries, i);
+
+                g_object_thaw_notify (G_OBJECT (entry->control));
+        }
+}
+
+/**
+ * gvc_app_list_set_all_mute:
+ * @list: a #GvcAppList
+ * @mute: whether to mute or unmute the streams
+ * @except_focus: whether to skip the application of the last focused row
+ *
+ * Changes the mute state of all the application streams in a single batch.
+ */
+void
+gvc_app_list_set_all_mute (GvcAppList *list, gboolean mute, gboolean except_focus)
+{
+        AppListEntry *focus = NULL;
+        guint         i;
+        guint         count = 0;
+
+        g_return_if_fail (GVC_IS_APP_LIST (list));
+
+        if (except_focus == TRUE) {
+                focus = get_focus_entry (list);
+
+                /* Do not mute everything when there is nothing to keep */
+                if (focus == NULL) {
+                        g_debug ("No focused application stream to keep unmuted");
+                        return;
+                }
+        }
+
+        begin_batch (list);
+
+        for (i = 0; i < list->priv->entries->len; i++) {
+                AppListEntry *entry = g_ptr_array_index (list->priv->entries, i);
+
+                if (focus != NULL) {
+                        /* When grouped all the streams of the focused
+                         * application are skipped */
+                        if (entry == focus ||
+                            (list->priv->grouped == TRUE &&
+                             entry->group != NULL &&
+                             entry->group == focus->group))
+                                continue;
+                }
+
+                if (!(mate_mixer_stream_control_get_flags (entry->control) & MATE_MIXER_STREAM_CONTROL_MUTE_WRITABLE))
+                        continue;
+
+                if (mate_mixer_stream_control_get_mute (entry->control) == mute)
+                        continue;
+
+                mate_mixer_stream_control_set_mute (entry->control, mute);
+                count++;
+        }
+
+        end_batch (list);
+
+        g_debug ("%s %u application streams", mute ? "Muted" : "Unmuted", count);
+}
+
+/**
+ * gvc_app_list_set_all_volume:
+ * @list: a #GvcAppList
+ * @fraction: volume as a fraction of the normal volume
+ *
+ * Sets the volume of all the application streams in a single batch. Like
+ * the rows of the list, a zero volume mutes the streams and other values
+ * unmute them.
+ */
+void
+gvc_app_list_set_all_volume (GvcAppList *list, gdouble fraction)
+{
+        guint i;
+        guint count = 0;
+
+        g_return_if_fail (GVC_IS_APP_LIST (list));
+
+        fraction = CLAMP (fraction, 0.0, 1.0);
+
+        begin_batch (list);
+
+        for (i = 0; i < list->priv->entries->len; i++) {
+                AppListEntry               *entry = g_ptr_array_index (list->priv->entries, i);
+                MateMixerStreamControlFlags flags;
+                gboolean                    mute = (fraction <= 0.0);
+                gboolean                    changed = FALSE;
+
+                flags = mate_mixer_stream_control_get_flags (entry->control);
+
+                if ((flags & MATE_MIXER_STREAM_CONTROL_MUTE_WRITABLE) &&
+                    mate_mixer_stream_control_get_mute (entry->control) != mute) {
+                        mate_mixer_stream_control_set_mute (entry->control, mute);
+                        changed = TRUE;
+                }
+
+                if (flags & MATE_MIXER_STREAM_CONTROL_VOLUME_WRITABLE) {
+                        guint min    = mate_mixer_stream_control_get_min_volume (entry->control);
+                        guint normal = mate_mixer_stream_control_get_normal_volume (entry->control);
+                        guint volume;
+
+                        volume = min + (guint) (fraction * (normal - min));
+
+                        if (mate_mixer_stream_control_get_volume (entry->control) != volume) {
+                                mate_mixer_stream_control_set_volume (entry->control, volume);
+                                changed = TRUE;
+                        }
+                }
+
+                if (changed == TRUE)
+                        count++;
+        }
+
+        end_batch (list);
+
+        g_debug ("Changed volume of %u application streams to %.0f %%",
+                 count,
+                 fraction * 100);
+}
+
+gboolean
+gvc_app_list_get_grouped (GvcAppList *list)
+{
+        g_return_val_if_fail (GVC_IS_APP_LIST (list), FALSE);
+
+        return list->priv->grouped;
+}
+
+void
+gvc_app_list_set_grouped (GvcAppList *list, gboolean grouped)
+{
+        g_return_if_fail (GVC_IS_APP_LIST (list));
+
+        grouped = !!grouped;
+
+        if (list->priv->grouped == grouped)
+                return;
+
+        list->priv->grouped = grouped;
+
+        rebuild_visible (list, FALSE);
+
+        gtk_adjustment_set_value (list->priv->vadjustment, 0);
+        gtk_widget_queue_resize (GTK_WIDGET (list));
+
+        g_object_notify (G_OBJECT (list), "grouped");
+}
+
+static void
+gvc_app_list_set_property (GObject       *object,
+                           guint          prop_id,
+                           const GValue  *value,
+                           GParamSpec    *pspec)
+{
+        GvcAppList *self = GVC_APP_LIST (object);
+
+        switch (prop_id) {
+        case PROP_HADJUSTMENT:
+                set_adjustment (self, &self->priv->hadjustment, g_value_get_object (value));
+                break;
+        case PROP_VADJUSTMENT:
+                set_adjustment (self, &self->priv->vadjustment, g_value_get_object (value));
+                break;
+        case PROP_HSCROLL_POLICY:
+                self->priv->hscroll_policy = g_value_get_enum (value);
+                gtk_widget_queue_resize (GTK_WIDGET (self));
+                break;
+        case PROP_VSCROLL_POLICY:
+                self->priv->vscroll_policy = g_value_get_enum (value);
+                gtk_widget_queue_resize (GTK_WIDGET (self));
+                break;
+        case PROP_GROUPED:
+                gvc_app_list_set_grouped (self, g_value_get_boolean (value));
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+                break;
+        }
+}
+
+static void
+gvc_app_list_get_property (GObject     *object,
+                           guint        prop_id,
+                           GValue      *value,
+                           GParamSpec  *pspec)
+{
+        GvcAppList *self = GVC_APP_LIST (object);
+
+        switch (prop_id) {
+        case PROP_HADJUSTMENT:
+                g_value_set_object (value, self->priv->hadjustment);
+                break;
+        case PROP_VADJUSTMENT:
+                g_value_set_object (value, self->priv->vadjustment);
+                break;
+        case PROP_HSCROLL_POLICY:
+                g_value_set_enum (value, self->priv->hscroll_policy);
+                break;
+        case PROP_VSCROLL_POLICY:
+                g_value_set_enum (value, self->priv->vscroll_policy);
+                break;
+        case PROP_GROUPED:
+                g_value_set_boolean (value, self->priv->grouped);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+                break;
+        }
+}
+
+static void
+gvc_app_list_get_preferred_width (GtkWidget *widget,
+                                  gint      *minimum,
+                                  gint      *natural)
+{
+        GvcAppList *list = GVC_APP_LIST (widget);
+        gint        width;
+
+        measure_rows (list);
+
+        width = list->priv->row_width + 2 * BORDER_WIDTH;
+
+        if (minimum != NULL)
+                *minimum = width;
+        if (natural != NULL)
+                *natural = width;
+}
+
+static void
+gvc_app_list_get_preferred_height (GtkWidget *widget,
+                                   gint      *minimum,
+                                   gint      *natural)
+{
+        GvcAppList *list = GVC_APP_LIST (widget);
+
+        measure_rows (list);
+
+        /* The list is meant to be scrolled, so it only asks for one row */
+        if (minimum != NULL)
+                *minimum = list->priv->row_height + 2 * BORDER_WIDTH;
+        if (natural != NULL)
+                *natural = get_total_height (list);
+}
+
+static void
+gvc_app_list_size_allocate (GtkWidget *widget, GtkAllocation *allocation)
+{
+        GvcAppList *list = GVC_APP_LIST (widget);
+
+        gtk_widget_set_allocation (widget, allocation);
+
+        if (gtk_widget_get_realized (widget) == TRUE)
+                gdk_window_move_resize (gtk_widget_get_window (widget),
+                                        allocation->x,
+                                        allocation->y,
+                                        allocation->width,
+                                        allocation->height);
+
+        measure_rows (list);
+
+        /* Changing the adjustment value lays out the rows by itself, make
+         * sure it is only done once */
+        g_signal_handlers_block_by_func (G_OBJECT (list->priv->vadjustment),
+                                         on_adjustment_value_changed,
+                                         list);
+
+        configure_adjustments (list);
+
+        g_signal_handlers_unblock_by_func (G_OBJECT (list->priv->vadjustment),
+                                           on_adjustment_value_changed,
+                                           list);
+
+        layout_rows (list);
+}
+
+static void
+gvc_app_list_realize (GtkWidget *widget)
+{
+        GtkAllocation  allocation;
+        GdkWindowAttr  attributes;
+        GdkWindow     *window;
+
+        gtk_widget_set_realized (widget, TRUE);
+        gtk_widget_get_allocation (widget, &allocation);
+
+        attributes.window_type = GDK_WINDOW_CHILD;
+        attributes.wclass      = GDK_INPUT_OUTPUT;
+        attributes.visual      = gtk_widget_get_visual (widget);
+        attributes.x           = allocation.x;
+        attributes.y           = allocation.y;
+        attributes.width       = allocation.width;
+        attributes.height      = allocation.height;
+        attributes.event_mask  = gtk_widget_get_events (widget) | GDK_EXPOSURE_MASK;
+
+        /* Rows partially scrolled out are clipped by the window */
+        window = gdk_window_new (gtk_widget_get_parent_window (widget),
+                                 &attributes,
+                                 GDK_WA_X | GDK_WA_Y | GDK_WA_VISUAL);
+
+        gtk_widget_set_window (widget, window);
+        gtk_widget_register_window (widget, window);
+}
+
+static gboolean
+gvc_app_list_draw (GtkWidget *widget, cairo_t *cr)
+{
+        if (gtk_cairo_should_draw_window (cr, gtk_widget_get_window (widget)) == TRUE)
+                gtk_render_background (gtk_widget_get_style_context (widget),
+                                       cr,
+                                       0, 0,
+                                       gtk_widget_get_allocated_width (widget),
+                                       gtk_widget_get_allocated_height (widget));
+
+        return GTK_WIDGET_CLASS (gvc_app_list_parent_class)->draw (widget, cr);
+}
+
+static void
+gvc_app_list_add_widget (GtkContainer *container, GtkWidget *widget)
+{
+        g_warning ("Rows of GvcAppList are managed by the list itself");
+}
+
+static void
+gvc_app_list_remove_widget (GtkContainer *container, GtkWidget *widget)
+{
+        GvcAppList *list = GVC_APP_LIST (container);
+
+        if (g_ptr_array_remove (list->priv->rows, widget) == FALSE)
+                return;
+
+        gtk_widget_unparent (widget);
+}
+
+static void
+gvc_app_list_forall (GtkContainer *container,
+                     gboolean      include_internals,
+                     GtkCallback   callback,
+                     gpointer      callback_data)
+{
+        GvcAppList *list = GVC_APP_LIST (container);
+        guint       i;
+
+        /* The callback may remove the row */
+        for (i = list->priv->rows->len; i > 0; i--)
+                callback (g_ptr_array_index (list->priv->rows, i - 1), callback_data);
+}
+
+static gchar *
+get_row_control_name (GtkWidget *row)
+{
+        MateMixerStreamControl *control;
+        GPtrArray              *group;
+
+        control = gvc_app_bar_get_control (GVC_APP_BAR (row));
+        if (control == NULL) {
+                group = gvc_app_bar_get_group (GVC_APP_BAR (row));
+
+                if (group != NULL && group->len > 0)
+                        control = g_ptr_array_index (group, 0);
+        }
+
+        if (control == NULL)
+                return NULL;
+
+        return g_strdup (mate_mixer_stream_control_get_name (control));
+}
+
+static void
+gvc_app_list_set_focus_child (GtkContainer *container, GtkWidget *child)
+{
+        GvcAppList   *list = GVC_APP_LIST (container);
+        GtkAllocation allocation;
+        GtkAllocation child_allocation;
+        gdouble       value;
+
+        GTK_CONTAINER_CLASS (gvc_app_list_parent_class)->set_focus_child (container, child);
+
+        if (child == NULL)
+                return;
+
+        /* Remember the application of the row, the focus moves away from
+         * the list when a bulk action is chosen */
+        g_free (list->priv->focus_name);
+        list->priv->focus_name = get_row_control_name (child);
+
+        gtk_widget_get_allocation (GTK_WIDGET (list), &allocation);
+        gtk_widget_get_allocation (child, &child_allocation);
+
+        /* Scroll the focused row fully into view */
+        value = gtk_adjustment_get_value (list->priv->vadjustment);
+
+        if (child_allocation.y < 0)
+                gtk_adjustment_set_value (list->priv->vadjustment,
+                                          value + child_allocation.y - BORDER_WIDTH);
+        else if (child_allocation.y + child_allocation.height > allocation.height)
+                gtk_adjustment_set_value (list->priv->vadjustment,
+                                          value +
+                                          child_allocation.y + child_allocation.height -
+                                          allocation.height + BORDER_WIDTH);
+}
+
+static gboolean
+gvc_app_list_focus (GtkWidget *widget, GtkDirectionType direction)
+{
+        GvcAppList *list = GVC_APP_LIST (widget);
+        GtkWidget  *focus_row;
+        GtkWidget  *row;
+        gint        target;
+
+        /* Only the rows near the viewport exist, Tab is handled here so it
+         * walks through all the entries instead of leaving the list */
+        if (direction != GTK_DIR_TAB_FORWARD && direction != GTK_DIR_TAB_BACKWARD)
+                return GTK_WIDGET_CLASS (gvc_app_list_parent_class)->focus (widget, direction);
+
+        if (list->priv->visible->len == 0)
+                return FALSE;
+
+        focus_row = gtk_container_get_focus_child (GTK_CONTAINER (list));
+        if (focus_row != NULL) {
+                gint index;
+
+                if (gtk_widget_child_focus (focus_row, direction) == TRUE)
+                        return TRUE;
+
+                index = find_row_item (list, focus_row);
+                if (index < 0)
+                        return FALSE;
+
+                target = (direction == GTK_DIR_TAB_FORWARD) ? index + 1 : index - 1;
+
+                if (target < 0 || target >= (gint) list->priv->visible->len)
+                        return FALSE;
+        } else {
+                target = (direction == GTK_DIR_TAB_FORWARD) ? 0 : list->priv->visible->len - 1;
+        }
+
+        row = show_item (list, target);
+        if (row == NULL)
+                return FALSE;
+
+        return gtk_widget_child_focus (row, direction);
+}
+
+static GType
+gvc_app_list_child_type (GtkContainer *container)
+{
+        return G_TYPE_NONE;
+}
+
+static void
+gvc_app_list_class_init (GvcAppListClass *klass)
+{
+        GObjectClass      *object_class = G_OBJECT_CLASS (klass);
+        GtkWidgetClass    *widget_class = GTK_WIDGET_CLASS (klass);
+        GtkContainerClass *container_class = GTK_CONTAINER_CLASS (klass);
+
+        object_class->dispose = gvc_app_list_dispose;
+        object_class->finalize = gvc_app_list_finalize;
+        object_class->set_property = gvc_app_list_set_property;
+        object_class->get_property = gvc_app_list_get_property;
+
+        widget_class->draw = gvc_app_list_draw;
+        widget_class->get_preferred_width = gvc_app_list_get_preferred_width;
+        widget_class->get_preferred_height = gvc_app_list_get_preferred_height;
+        widget_class->size_allocate = gvc_app_list_size_allocate;
+        widget_class->realize = gvc_app_list_realize;
+        widget_class->focus = gvc_app_list_focus;
+
+        container_class->add = gvc_app_list_add_widget;
+        container_class->remove = gvc_app_list_remove_widget;
+        container_class->forall = gvc_app_list_forall;
+        container_class->set_focus_child = gvc_app_list_set_focus_child;
+        container_class->child_type = gvc_app_list_child_type;
+
+#if GTK_CHECK_VERSION (3, 20, 0)
+        gtk_widget_class_set_css_name (widget_class, "gvc-app-list");
+#endif
+
+        g_object_class_override_property (object_class, PROP_HADJUSTMENT, "hadjustment");
+        g_object_class_override_property (object_class, PROP_VADJUSTMENT, "vadjustment");
+        g_object_class_override_property (object_class, PROP_HSCROLL_POLICY, "hscroll-policy");
+        g_object_class_override_property (object_class, PROP_VSCROLL_POLICY, "vscroll-policy");
+
+        g_object_class_install_property (object_class,
+                                         PROP_GROUPED,
+                                         g_param_spec_boolean ("grouped",
+                                                               "Grouped",
+                                                               "Whether streams of the same application are grouped",
+                                                               FALSE,
+                                                               G_PARAM_READWRITE |
+                                                               G_PARAM_STATIC_STRINGS));
+
+        g_type_class_add_private (klass, sizeof (GvcAppListPrivate));
+}
+
+static void
+gvc_app_list_init (GvcAppList *list)
+{
+        list->priv = GVC_APP_LIST_GET_PRIVATE (list);
+
+        list->priv->entries = g_ptr_array_new_with_free_func ((GDestroyNotify) free_entry);
+        list->priv->entries_by_name = g_hash_table_new (g_str_hash, g_str_equal);
+        list->priv->groups = g_hash_table_new_full (g_str_hash,
+                                                    g_str_equal,
+                                                    NULL,
+                                                    (GDestroyNotify) free_group);
+        list->priv->visible = g_array_new (FALSE, FALSE, sizeof (AppListItem));
+        list->priv->rows = g_ptr_array_new ();
+
+        set_adjustment (list, &list->priv->hadjustment, NULL);
+        set_adjustment (list, &list->priv->vadjustment, NULL);
+
+        gtk_widget_set_has_window (GTK_WIDGET (list), TRUE);
+}
+
+static void
+gvc_app_list_dispose (GObject *object)
+{
+        GvcAppList *list = GVC_APP_LIST (object);
+
+        if (list->priv->spare_rows_id != 0) {
+                g_source_remove (list->priv->spare_rows_id);
+                list->priv->spare_rows_id = 0;
+        }
+
+        clear_spare_rows (list);
+
+        if (list->priv->hadjustment != NULL) {
+                g_signal_handlers_disconnect_by_data (G_OBJECT (list->priv->hadjustment), list);
+                g_clear_object (&list->priv->hadjustment);
+        }
+        if (list->priv->vadjustment != NULL) {
+                g_signal_handlers_disconnect_by_data (G_OBJECT (list->priv->vadjustment), list);
+                g_clear_object (&list->priv->vadjustment);
+        }
+
+        G_OBJECT_CLASS (gvc_app_list_parent_class)->dispose (object);
+}
+
+static void
+gvc_app_list_finalize (GObject *object)
+{
+        GvcAppList *list = GVC_APP_LIST (object);
+
+        g_hash_table_destroy (list->priv->entries_by_name);
+        g_array_free (list->priv->visible, TRUE);
+        g_hash_table_destroy (list->priv->groups);
+        g_ptr_array_free (list->priv->entries, TRUE);
+        g_ptr_array_free (list->priv->rows, TRUE);
+
+        g_free (list->priv->filter);
+        g_free (list->priv->focus_name);
+
+        G_OBJECT_CLASS (gvc_app_list_parent_class)->finalize (object);
+}
+
+GtkWidget *
+gvc_app_list_new (void)
+{
+        return g_object_new (GVC_TYPE_APP_LIST, NULL);
+}
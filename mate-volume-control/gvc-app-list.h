@@ -0,0 +1,85 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2026 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef __GVC_APP_LIST_H
+#define __GVC_APP_LIST_H
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gtk/gtk.h>
+
+#include <libmatemixer/matemixer.h>
+
+G_BEGIN_DECLS
+
+#define GVC_TYPE_APP_LIST         (gvc_app_list_get_type ())
+#define GVC_APP_LIST(o)           (G_TYPE_CHECK_INSTANCE_CAST ((o), GVC_TYPE_APP_LIST, GvcAppList))
+#define GVC_APP_LIST_CLASS(k)     (G_TYPE_CHECK_CLASS_CAST((k), GVC_TYPE_APP_LIST, GvcAppListClass))
+#define GVC_IS_APP_LIST(o)        (G_TYPE_CHECK_INSTANCE_TYPE ((o), GVC_TYPE_APP_LIST))
+#define GVC_IS_APP_LIST_CLASS(k)  (G_TYPE_CHECK_CLASS_TYPE ((k), GVC_TYPE_APP_LIST))
+#define GVC_APP_LIST_GET_CLASS(o) (G_TYPE_INSTANCE_GET_CLASS ((o), GVC_TYPE_APP_LIST, GvcAppListClass))
+
+typedef struct _GvcAppList         GvcAppList;
+typedef struct _GvcAppListClass    GvcAppListClass;
+typedef struct _GvcAppListPrivate  GvcAppListPrivate;
+
+struct _GvcAppList
+{
+        GtkContainer           parent;
+        GvcAppListPrivate     *priv;
+};
+
+struct _GvcAppListClass
+{
+        GtkContainerClass      parent_class;
+};
+
+GType               gvc_app_list_get_type            (void) G_GNUC_CONST;
+
+GtkWidget *         gvc_app_list_new                 (void);
+
+void                gvc_app_list_add                 (GvcAppList             *list,
+                                                      MateMixerStreamControl *control,
+                                                      const gchar            *name,
+                                                      const gchar            *icon_name);
+gboolean            gvc_app_list_remove              (GvcAppList             *list,
+                                                      const gchar            *control_name);
+gboolean            gvc_app_list_contains            (GvcAppList             *list,
+                                                      const gchar            *control_name);
+
+guint               gvc_app_list_get_n_items         (GvcAppList             *list);
+guint               gvc_app_list_get_n_visible       (GvcAppList             *list);
+
+void                gvc_app_list_set_filter          (GvcAppList             *list,
+                                                      const gchar            *text);
+
+void                gvc_app_list_set_all_mute        (GvcAppList             *list,
+                                                      gboolean                mute,
+                                                      gboolean                except_focus);
+void                gvc_app_list_set_all_volume      (GvcAppList             *list,
+                                                      gdouble                 fraction);
+
+gboolean            gvc_app_list_get_grouped         (GvcAppList             *list);
+void                gvc_app_list_set_grouped         (GvcAppList             *list,
+                                                      gboolean                grouped);
+
+G_END_DECLS
+
+#endif /* __GVC_APP_LIST_H */
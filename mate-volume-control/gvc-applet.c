@@ -30,6 +30,7 @@
 #include <libmatemixer/matemixer.h>
 
 #include "gvc-applet.h"
+#include "gvc-ducker.h"
 #include "gvc-stream-status-icon.h"
 
 #define GVC_APPLET_GET_PRIVATE(o) (G_TYPE_INSTANCE_GET_PRIVATE ((o), GVC_TYPE_APPLET, GvcAppletPrivate))
@@ -57,6 +58,7 @@ struct _GvcAppletPrivate
         gboolean             running;
         MateMixerContext    *context;
         MateMixerStream     *input;
+        GvcDucker           *ducker;
 };
 
 static void gvc_applet_class_init (GvcAppletClass *klass);
@@ -283,6 +285,26 @@ gvc_applet_start (GvcApplet *applet)
         applet->priv->running = TRUE;
 }
 
+/**
+ * gvc_applet_set_duck_level:
+ * @applet: a #GvcApplet
+ * @level: volume of ducked applications in percent of their own volume
+ *
+ * Enables lowering the volume of music and video applications while a phone
+ * stream is active. A level of 100 or more disables ducking.
+ */
+void
+gvc_applet_set_duck_level (GvcApplet *applet, guint level)
+{
+        g_return_if_fail (GVC_IS_APPLET (applet));
+
+        if (level < 100) {
+                gvc_ducker_set_level (applet->priv->ducker, level / 100.0);
+                gvc_ducker_set_enabled (applet->priv->ducker, TRUE);
+        } else
+                gvc_ducker_set_enabled (applet->priv->ducker, FALSE);
+}
+
 static void
 gvc_applet_dispose (GObject *object)
 {
@@ -294,6 +316,9 @@ gvc_applet_dispose (GObject *object)
                 g_clear_object (&applet->priv->input);
         }
 
+        /* The ducker restores the applications it has ducked, so it must go
+         * away while the context is still around */
+        g_clear_object (&applet->priv->ducker);
         g_clear_object (&applet->priv->context);
         g_clear_object (&applet->priv->icon_input);
         g_clear_object (&applet->priv->icon_output);
@@ -348,6 +373,8 @@ gvc_applet_init (GvcApplet *applet)
                           "notify::default-output-stream",
                           G_CALLBACK (on_context_default_output_stream_notify),
                           applet);
+
+        applet->priv->ducker = gvc_ducker_new (applet->priv->context);
 }
 
 GvcApplet *
@@ -55,6 +55,8 @@ GType               gvc_applet_get_type            (void) G_GNUC_CONST;
 
 GvcApplet *         gvc_applet_new                 (void);
 void                gvc_applet_start               (GvcApplet *applet);
+void                gvc_applet_set_duck_level      (GvcApplet *applet,
+                                                    guint      level);
 
 G_END_DECLS
 
@@ -28,6 +28,7 @@
 #include <libmatemixer/matemixer.h>
 
 #include "gvc-balance-bar.h"
+#include "gvc-utils.h"
 
 #define BALANCE_BAR_STYLE                                       \
         "style \"balance-bar-scale-style\" {\n"                 \
@@ -36,6 +37,10 @@
         "widget \"*.balance-bar-scale\" style : rc \"balance-bar-scale-style\"\n"
 
 #define SCALE_SIZE 128
+
+/* Notifications arriving this soon after our own write are treated as its echo */
+#define ECHO_WINDOW 250
+
 #define GVC_BALANCE_BAR_GET_PRIVATE(o) (G_TYPE_INSTANCE_GET_PRIVATE ((o), GVC_TYPE_BALANCE_BAR, GvcBalanceBarPrivate))
 
 struct _GvcBalanceBarPrivate
@@ -51,6 +56,10 @@ struct _GvcBalanceBarPrivate
         gboolean         symmetric;
         MateMixerStreamControl *control;
         gint             lfe_channel;
+        gdouble          write_value;
+        guint            write_id;
+        guint            echo_id;
+        gboolean         stale;
 };
 
 enum
@@ -66,6 +75,7 @@ static GParamSpec *properties[N_PROPERTIES] = { NULL, };
 static void     gvc_balance_bar_class_init  (GvcBalanceBarClass *klass);
 static void     gvc_balance_bar_init        (GvcBalanceBar      *balance_bar);
 static void     gvc_balance_bar_dispose     (GObject            *object);
+static void     gvc_balance_bar_map         (GtkWidget          *widget);
 
 static gboolean on_scale_scroll_event       (GtkWidget          *widget,
                                              GdkEventScroll     *event,
@@ -74,6 +84,8 @@ static gboolean on_scale_scroll_event       (GtkWidget          *widget,
 static void     on_adjustment_value_changed (GtkAdjustment      *adjustment,
                                              GvcBalanceBar      *bar);
 
+static void     flush_pending_write         (GvcBalanceBar      *bar);
+
 G_DEFINE_TYPE (GvcBalanceBar, gvc_balance_bar, GTK_TYPE_BOX)
 
 static void
@@ -207,6 +219,9 @@ update_balance_value (GvcBalanceBar *bar)
                 g_debug ("Fade value changed to %.2f", value);
                 break;
         case BALANCE_TYPE_LFE:
+                if (G_UNLIKELY (bar->priv->lfe_channel < 0))
+                        return;
+
                 value = mate_mixer_stream_control_get_channel_volume (bar->priv->control,
                                                                       bar->priv->lfe_channel);
 
@@ -214,7 +229,29 @@ update_balance_value (GvcBalanceBar *bar)
                 break;
         }
 
+        /* Do not write back a value which has just been read from the control */
+        g_signal_handlers_block_by_func (G_OBJECT (bar->priv->adjustment),
+                                         on_adjustment_value_changed,
+                                         bar);
+
         gtk_adjustment_set_value (bar->priv->adjustment, value);
+
+        g_signal_handlers_unblock_by_func (G_OBJECT (bar->priv->adjustment),
+                                           on_adjustment_value_changed,
+                                           bar);
+}
+
+static gboolean
+on_echo_window_timeout (GvcBalanceBar *bar)
+{
+        bar->priv->echo_id = 0;
+
+        /* Pick up any change made by someone else while the notifications
+         * were ignored */
+        if (bar->priv->write_id == 0)
+                update_balance_value (bar);
+
+        return G_SOURCE_REMOVE;
 }
 
 static void
@@ -222,23 +259,20 @@ on_balance_value_changed (MateMixerStream *stream,
                           GParamSpec      *pspec,
                           GvcBalanceBar   *bar)
 {
-        update_balance_value (bar);
-}
-
-static gint
-find_stream_lfe_channel (MateMixerStreamControl *control)
-{
-        guint i;
-
-        for (i = 0; i < mate_mixer_stream_control_get_num_channels (control); i++) {
-                MateMixerChannelPosition position;
+        /* The adjustment is ahead of the control while a write is pending or
+         * its notifications are still arriving, following them would make the
+         * scale jump back to older values while being dragged */
+        if (bar->priv->write_id != 0 || bar->priv->echo_id != 0)
+                return;
 
-                position = mate_mixer_stream_control_get_channel_position (control, i);
-                if (position == MATE_MIXER_CHANNEL_LFE)
-                        return i;
+        /* The subwoofer bar is notified about every volume change of the
+         * stream, only read the channel volume once the bar is shown */
+        if (gtk_widget_get_mapped (GTK_WIDGET (bar)) == FALSE) {
+                bar->priv->stale = TRUE;
+                return;
         }
 
-        return -1;
+        update_balance_value (bar);
 }
 
 static void
@@ -248,6 +282,8 @@ gvc_balance_bar_set_control (GvcBalanceBar *bar, MateMixerStreamControl *control
         g_return_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control));
 
         if (bar->priv->control != NULL) {
+                flush_pending_write (bar);
+
                 g_signal_handlers_disconnect_by_func (G_OBJECT (bar->priv->control),
                                                       on_balance_value_changed,
                                                       bar);
@@ -276,7 +312,9 @@ gvc_balance_bar_set_control (GvcBalanceBar *bar, MateMixerStreamControl *control
                                           (maximum - minimum) / 10.0,
                                           0.0);
 
-                bar->priv->lfe_channel = find_stream_lfe_channel (bar->priv->control);
+                bar->priv->lfe_channel =
+                        gvc_channel_table_get_index (gvc_channel_table_get (bar->priv->control),
+                                                     MATE_MIXER_CHANNEL_LFE);
 
                 if (G_LIKELY (bar->priv->lfe_channel > -1))
                         g_debug ("Found LFE channel at position %d", bar->priv->lfe_channel);
@@ -306,6 +344,8 @@ gvc_balance_bar_set_control (GvcBalanceBar *bar, MateMixerStreamControl *control
                 break;
         }
 
+        bar->priv->stale = FALSE;
+
         update_balance_value (bar);
         update_scale_marks (bar);
 
@@ -408,15 +448,31 @@ gvc_balance_bar_get_property (GObject     *object,
         }
 }
 
+static void
+gvc_balance_bar_map (GtkWidget *widget)
+{
+        GvcBalanceBar *bar = GVC_BALANCE_BAR (widget);
+
+        GTK_WIDGET_CLASS (gvc_balance_bar_parent_class)->map (widget);
+
+        if (bar->priv->stale == TRUE) {
+                bar->priv->stale = FALSE;
+                update_balance_value (bar);
+        }
+}
+
 static void
 gvc_balance_bar_class_init (GvcBalanceBarClass *klass)
 {
-        GObjectClass *object_class = G_OBJECT_CLASS (klass);
+        GObjectClass   *object_class = G_OBJECT_CLASS (klass);
+        GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
 
         object_class->dispose = gvc_balance_bar_dispose;
         object_class->set_property = gvc_balance_bar_set_property;
         object_class->get_property = gvc_balance_bar_get_property;
 
+        widget_class->map = gvc_balance_bar_map;
+
         properties[PROP_CONTROL] =
                 g_param_spec_object ("control",
                                      "Control",
@@ -479,15 +535,8 @@ on_scale_scroll_event (GtkWidget      *widget,
 }
 
 static void
-on_adjustment_value_changed (GtkAdjustment *adjustment, GvcBalanceBar *bar)
+write_value (GvcBalanceBar *bar, gdouble value)
 {
-        gdouble value;
-
-        if (bar->priv->control == NULL)
-                return;
-
-        value = gtk_adjustment_get_value (adjustment);
-
         switch (bar->priv->btype) {
         case BALANCE_TYPE_RL:
                 mate_mixer_stream_control_set_balance (bar->priv->control, value);
@@ -501,6 +550,64 @@ on_adjustment_value_changed (GtkAdjustment *adjustment, GvcBalanceBar *bar)
                                                       value);
                 break;
         }
+
+        /* Restart the echo window with every write */
+        if (bar->priv->echo_id != 0)
+                g_source_remove (bar->priv->echo_id);
+
+        bar->priv->echo_id = g_timeout_add (ECHO_WINDOW,
+                                            (GSourceFunc) on_echo_window_timeout,
+                                            bar);
+}
+
+static gboolean
+on_write_tick (GtkWidget     *widget,
+               GdkFrameClock *clock,
+               gpointer       user_data)
+{
+        GvcBalanceBar *bar = GVC_BALANCE_BAR (widget);
+
+        bar->priv->write_id = 0;
+
+        write_value (bar, bar->priv->write_value);
+        return G_SOURCE_REMOVE;
+}
+
+static void
+flush_pending_write (GvcBalanceBar *bar)
+{
+        if (bar->priv->write_id != 0) {
+                gtk_widget_remove_tick_callback (GTK_WIDGET (bar), bar->priv->write_id);
+                bar->priv->write_id = 0;
+
+                write_value (bar, bar->priv->write_value);
+        }
+
+        if (bar->priv->echo_id != 0) {
+                g_source_remove (bar->priv->echo_id);
+                bar->priv->echo_id = 0;
+        }
+}
+
+static void
+on_adjustment_value_changed (GtkAdjustment *adjustment, GvcBalanceBar *bar)
+{
+        if (bar->priv->control == NULL)
+                return;
+
+        bar->priv->write_value = gtk_adjustment_get_value (adjustment);
+
+        /* Coalesce all the changes made within a single frame into one write */
+        if (bar->priv->write_id != 0)
+                return;
+
+        if (gtk_widget_get_mapped (GTK_WIDGET (bar)) == TRUE)
+                bar->priv->write_id = gtk_widget_add_tick_callback (GTK_WIDGET (bar),
+                                                                    on_write_tick,
+                                                                    NULL,
+                                                                    NULL);
+        else
+                write_value (bar, bar->priv->write_value);
 }
 
 static void
@@ -517,6 +624,8 @@ gvc_balance_bar_dispose (GObject *object)
         bar = GVC_BALANCE_BAR (object);
 
         if (bar->priv->control != NULL) {
+                flush_pending_write (bar);
+
                 g_signal_handlers_disconnect_by_func (G_OBJECT (bar->priv->control),
                                                       on_balance_value_changed,
                                                       bar);
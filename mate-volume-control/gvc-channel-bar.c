@@ -32,8 +32,27 @@
 #include "gvc-channel-bar.h"
 
 #define SCALE_SIZE 128
+
+/* Volume ramps never write to the backend more often than this */
+#define RAMP_WRITE_INTERVAL (G_USEC_PER_SEC / 60)
+
+/* Only changes larger than this fraction of the scale range are ramped */
+#define RAMP_JUMP_FRACTION  0.1
+
 #define GVC_CHANNEL_BAR_GET_PRIVATE(o) (G_TYPE_INSTANCE_GET_PRIVATE ((o), GVC_TYPE_CHANNEL_BAR, GvcChannelBarPrivate))
 
+/* Inputs the scale marks were last built from */
+typedef struct {
+        gboolean        valid;
+        gboolean        shown;
+        guint           min;
+        guint           base;
+        guint           normal;
+        guint           max;
+        gboolean        extended;
+        GtkOrientation  orientation;
+} ChannelBarMarks;
+
 struct _GvcChannelBarPrivate
 {
         GtkOrientation              orientation;
@@ -57,6 +76,15 @@ struct _GvcChannelBarPrivate
         gboolean                    click_lock;
         MateMixerStreamControl     *control;
         MateMixerStreamControlFlags control_flags;
+        ChannelBarMarks             marks;
+        guint                       ramp_duration;
+        guint                       ramp_id;
+        gint64                      ramp_start_time;
+        gint64                      ramp_write_time;
+        gdouble                     ramp_from;
+        gdouble                     ramp_to;
+        gdouble                     ramp_restore;
+        gboolean                    ramp_mute;
 };
 
 enum {
@@ -71,6 +99,7 @@ enum {
         PROP_ICON_NAME,
         PROP_LOW_ICON_NAME,
         PROP_HIGH_ICON_NAME,
+        PROP_RAMP_DURATION,
         N_PROPERTIES
 };
 
@@ -78,6 +107,10 @@ static GParamSpec *properties[N_PROPERTIES] = { NULL, };
 
 static void     gvc_channel_bar_class_init    (GvcChannelBarClass *klass);
 static void     gvc_channel_bar_init          (GvcChannelBar      *bar);
+static void     gvc_channel_bar_dispose       (GObject            *object);
+
+static void     update_marks                  (GvcChannelBar      *bar);
+static void     update_adjustment_value       (GvcChannelBar      *bar);
 
 static gboolean on_scale_button_press_event   (GtkWidget          *widget,
                                                GdkEventButton     *event,
@@ -201,18 +234,184 @@ create_scale_box (GvcChannelBar *bar)
         gtk_scale_set_draw_value (GTK_SCALE (bar->priv->scale), FALSE);
 }
 
+static gdouble
+get_audible_volume (GvcChannelBar *bar)
+{
+        if (bar->priv->control_flags & MATE_MIXER_STREAM_CONTROL_MUTE_READABLE &&
+            mate_mixer_stream_control_get_mute (bar->priv->control) == TRUE)
+                return gtk_adjustment_get_lower (bar->priv->adjustment);
+
+        return mate_mixer_stream_control_get_volume (bar->priv->control);
+}
+
+static gboolean
+ramp_is_possible (GvcChannelBar *bar)
+{
+        if (bar->priv->ramp_duration == 0 || bar->priv->control == NULL)
+                return FALSE;
+
+        /* The ramp is driven by the frame clock, which only ticks for
+         * widgets on screen */
+        if (gtk_widget_get_mapped (GTK_WIDGET (bar)) == FALSE)
+                return FALSE;
+
+        if (!(bar->priv->control_flags & MATE_MIXER_STREAM_CONTROL_VOLUME_READABLE) ||
+            !(bar->priv->control_flags & MATE_MIXER_STREAM_CONTROL_VOLUME_WRITABLE))
+                return FALSE;
+
+        return TRUE;
+}
+
+static void
+ramp_stop (GvcChannelBar *bar)
+{
+        if (bar->priv->ramp_id == 0)
+                return;
+
+        gtk_widget_remove_tick_callback (GTK_WIDGET (bar), bar->priv->ramp_id);
+        bar->priv->ramp_id = 0;
+}
+
+static void
+ramp_apply_final (GvcChannelBar *bar)
+{
+        mate_mixer_stream_control_set_volume (bar->priv->control,
+                                              (guint) bar->priv->ramp_to);
+
+        if (bar->priv->ramp_mute == TRUE) {
+                if (bar->priv->control_flags & MATE_MIXER_STREAM_CONTROL_MUTE_WRITABLE)
+                        mate_mixer_stream_control_set_mute (bar->priv->control, TRUE);
+
+                /* Muted controls keep their volume, put back the volume the
+                 * ramp started from once the control is silent */
+                if (bar->priv->ramp_restore != bar->priv->ramp_to)
+                        mate_mixer_stream_control_set_volume (bar->priv->control,
+                                                              (guint) bar->priv->ramp_restore);
+        }
+
+        /* Volume and mute notifications are ignored while ramping */
+        update_adjustment_value (bar);
+}
+
+static void
+ramp_finish (GvcChannelBar *bar)
+{
+        if (bar->priv->ramp_id == 0)
+                return;
+
+        ramp_stop (bar);
+        ramp_apply_final (bar);
+}
+
+static gboolean
+on_ramp_tick (GtkWidget     *widget,
+              GdkFrameClock *clock,
+              gpointer       user_data)
+{
+        GvcChannelBar *bar = GVC_CHANNEL_BAR (widget);
+        gint64         now;
+        gint64         elapsed;
+        gdouble        value;
+
+        now     = gdk_frame_clock_get_frame_time (clock);
+        elapsed = now - bar->priv->ramp_start_time;
+
+        if (elapsed >= (gint64) bar->priv->ramp_duration * 1000) {
+                bar->priv->ramp_id = 0;
+
+                ramp_apply_final (bar);
+                return G_SOURCE_REMOVE;
+        }
+
+        /* Frames may come faster than the backend should be written to */
+        if (bar->priv->ramp_write_time > 0 &&
+            now - bar->priv->ramp_write_time < RAMP_WRITE_INTERVAL)
+                return G_SOURCE_CONTINUE;
+
+        value = bar->priv->ramp_from +
+                (bar->priv->ramp_to - bar->priv->ramp_from) *
+                ((gdouble) elapsed / (bar->priv->ramp_duration * 1000.0));
+
+        mate_mixer_stream_control_set_volume (bar->priv->control, (guint) value);
+
+        bar->priv->ramp_write_time = now;
+        return G_SOURCE_CONTINUE;
+}
+
+static void
+ramp_start (GvcChannelBar *bar,
+            gdouble        from,
+            gdouble        to,
+            gboolean       mute,
+            gdouble        restore)
+{
+        GdkFrameClock *clock;
+
+        ramp_stop (bar);
+
+        bar->priv->ramp_from    = from;
+        bar->priv->ramp_to      = to;
+        bar->priv->ramp_mute    = mute;
+        bar->priv->ramp_restore = restore;
+
+        clock = gtk_widget_get_frame_clock (GTK_WIDGET (bar));
+        if (G_UNLIKELY (clock == NULL)) {
+                ramp_apply_final (bar);
+                return;
+        }
+
+        bar->priv->ramp_start_time = gdk_frame_clock_get_frame_time (clock);
+        bar->priv->ramp_write_time = 0;
+
+        bar->priv->ramp_id = gtk_widget_add_tick_callback (GTK_WIDGET (bar),
+                                                           on_ramp_tick,
+                                                           NULL,
+                                                           NULL);
+}
+
+static void
+ramp_unmute (GvcChannelBar *bar, gdouble lower)
+{
+        if (!(bar->priv->control_flags & MATE_MIXER_STREAM_CONTROL_MUTE_READABLE) ||
+            !(bar->priv->control_flags & MATE_MIXER_STREAM_CONTROL_MUTE_WRITABLE))
+                return;
+
+        /* Start the ramp from silence rather than from the stored volume */
+        if (mate_mixer_stream_control_get_mute (bar->priv->control) == TRUE) {
+                mate_mixer_stream_control_set_volume (bar->priv->control, (guint) lower);
+                mate_mixer_stream_control_set_mute (bar->priv->control, FALSE);
+        }
+}
+
 static void
 on_adjustment_value_changed (GtkAdjustment *adjustment,
                              GvcChannelBar *bar)
 {
         gdouble value;
         gdouble lower;
+        gdouble upper;
 
         if (bar->priv->control == NULL || bar->priv->click_lock == TRUE)
                 return;
 
+        /* New input always takes over from a running ramp */
+        ramp_stop (bar);
+
         value = gtk_adjustment_get_value (bar->priv->adjustment);
         lower = gtk_adjustment_get_lower (bar->priv->adjustment);
+        upper = gtk_adjustment_get_upper (bar->priv->adjustment);
+
+        if (ramp_is_possible (bar) == TRUE) {
+                gdouble from = get_audible_volume (bar);
+
+                if (ABS (value - from) > (upper - lower) * RAMP_JUMP_FRACTION) {
+                        if (value > lower)
+                                ramp_unmute (bar, lower);
+
+                        ramp_start (bar, from, value, (value <= lower), value);
+                        return;
+                }
+        }
 
         if (bar->priv->control_flags & MATE_MIXER_STREAM_CONTROL_MUTE_WRITABLE)
                 mate_mixer_stream_control_set_mute (bar->priv->control, (value <= lower));
@@ -228,6 +427,25 @@ on_mute_button_toggled (GtkToggleButton *button, GvcChannelBar *bar)
 
         mute = gtk_toggle_button_get_active (button);
 
+        ramp_stop (bar);
+
+        if (ramp_is_possible (bar) == TRUE &&
+            bar->priv->control_flags & MATE_MIXER_STREAM_CONTROL_MUTE_WRITABLE) {
+                gdouble lower  = gtk_adjustment_get_lower (bar->priv->adjustment);
+                gdouble volume = mate_mixer_stream_control_get_volume (bar->priv->control);
+                gdouble from   = get_audible_volume (bar);
+
+                if (mute == TRUE && from > lower) {
+                        ramp_start (bar, from, lower, TRUE, volume);
+                        return;
+                }
+                if (mute == FALSE && volume > lower) {
+                        ramp_unmute (bar, lower);
+                        ramp_start (bar, lower, volume, FALSE, volume);
+                        return;
+                }
+        }
+
         mate_mixer_stream_control_set_mute (bar->priv->control, mute);
 }
 
@@ -279,6 +497,10 @@ update_layout (GvcChannelBar *bar)
         create_scale_box (bar);
         gtk_container_add (GTK_CONTAINER (frame), bar->priv->scale_box);
 
+        /* The new scale has no marks yet, the orientation change invalidates
+         * the cached ones */
+        update_marks (bar);
+
         g_object_unref (bar->priv->image);
         g_object_unref (bar->priv->label);
         g_object_unref (bar->priv->mute_button);
@@ -288,24 +510,74 @@ update_layout (GvcChannelBar *bar)
         gtk_widget_show_all (frame);
 }
 
+static gboolean
+marks_changed (ChannelBarMarks *marks1, ChannelBarMarks *marks2)
+{
+        if (marks1->valid != marks2->valid)
+                return TRUE;
+        if (marks1->shown != marks2->shown)
+                return TRUE;
+        if (marks1->orientation != marks2->orientation)
+                return TRUE;
+
+        /* Volume limits only matter when the marks are displayed */
+        if (marks1->shown == FALSE)
+                return FALSE;
+
+        if (marks1->min != marks2->min)
+                return TRUE;
+        if (marks1->base != marks2->base)
+                return TRUE;
+        if (marks1->normal != marks2->normal)
+                return TRUE;
+        if (marks1->max != marks2->max)
+                return TRUE;
+        if (marks1->extended != marks2->extended)
+                return TRUE;
+
+        return FALSE;
+}
+
 static void
 update_marks (GvcChannelBar *bar)
 {
-        gdouble  base;
-        gdouble  normal;
-        gboolean has_mark = FALSE;
+        ChannelBarMarks marks = { 0, };
+        gdouble         base;
+        gdouble         normal;
+        gboolean        has_mark = FALSE;
+
+        marks.valid       = TRUE;
+        marks.orientation = bar->priv->orientation;
+
+        if (bar->priv->control != NULL && bar->priv->show_marks == TRUE) {
+                marks.shown    = TRUE;
+                marks.min      = mate_mixer_stream_control_get_min_volume (bar->priv->control);
+                marks.base     = mate_mixer_stream_control_get_base_volume (bar->priv->control);
+                marks.normal   = mate_mixer_stream_control_get_normal_volume (bar->priv->control);
+                marks.max      = mate_mixer_stream_control_get_max_volume (bar->priv->control);
+                marks.extended = bar->priv->extended;
+        }
+
+        /* Rebuilding the marks re-lays out all the mark labels, skip it when
+         * the bar is switched to a control with the same volume limits */
+        if (marks_changed (&marks, &bar->priv->marks) == FALSE)
+                return;
+
+        bar->priv->marks = marks;
 
         gtk_scale_clear_marks (GTK_SCALE (bar->priv->scale));
 
-        if (bar->priv->control == NULL || bar->priv->show_marks == FALSE)
+        if (marks.shown == FALSE)
                 return;
 
         /* Base volume represents unamplified volume, normal volume is the 100%
          * volume, in many cases they are the same as unamplified volume is unknown */
-        base   = mate_mixer_stream_control_get_base_volume (bar->priv->control);
-        normal = mate_mixer_stream_control_get_normal_volume (bar->priv->control);
+        base   = marks.base;
+        normal = marks.normal;
 
-        if (normal <= gtk_adjustment_get_lower (bar->priv->adjustment))
+        /* Use the control limit rather than the adjustment, which may not have
+         * been configured for the control yet */
+        if (normal <= marks.min)
                 return;
 
         if (base < normal) {
@@ -519,6 +791,11 @@ on_control_volume_notify (MateMixerStreamControl *control,
                           GParamSpec             *pspec,
                           GvcChannelBar          *bar)
 {
+        /* Keep the slider at the ramp target rather than following the
+         * intermediate volumes written by the ramp */
+        if (bar->priv->ramp_id != 0)
+                return;
+
         update_adjustment_value (bar);
 }
 
@@ -540,7 +817,9 @@ on_control_mute_notify (MateMixerStreamControl *control,
                                                    on_mute_button_toggled,
                                                    bar);
         }
-        update_adjustment_value (bar);
+
+        if (bar->priv->ramp_id == 0)
+                update_adjustment_value (bar);
 }
 
 MateMixerStreamControl *
@@ -559,6 +838,9 @@ gvc_channel_bar_set_control (GvcChannelBar *bar, MateMixerStreamControl *control
         if (bar->priv->control == control)
                 return;
 
+        /* Leave the previous control in the state the ramp was heading to */
+        ramp_finish (bar);
+
         if (control != NULL)
                 g_object_ref (control);
 
@@ -718,6 +1000,31 @@ gvc_channel_bar_set_extended (GvcChannelBar *bar, gboolean extended)
         g_object_notify_by_pspec (G_OBJECT (bar), properties[PROP_EXTENDED]);
 }
 
+guint
+gvc_channel_bar_get_ramp_duration (GvcChannelBar *bar)
+{
+        g_return_val_if_fail (GVC_IS_CHANNEL_BAR (bar), 0);
+
+        return bar->priv->ramp_duration;
+}
+
+void
+gvc_channel_bar_set_ramp_duration (GvcChannelBar *bar, guint duration)
+{
+        g_return_if_fail (GVC_IS_CHANNEL_BAR (bar));
+
+        if (duration == bar->priv->ramp_duration)
+                return;
+
+        /* A running ramp keeps its original timing unless ramps are disabled */
+        if (duration == 0)
+                ramp_finish (bar);
+
+        bar->priv->ramp_duration = duration;
+
+        g_object_notify_by_pspec (G_OBJECT (bar), properties[PROP_RAMP_DURATION]);
+}
+
 const gchar *
 gvc_channel_bar_get_name (GvcChannelBar *bar)
 {
@@ -931,6 +1238,9 @@ gvc_channel_bar_set_property (GObject       *object,
         case PROP_HIGH_ICON_NAME:
                 gvc_channel_bar_set_high_icon_name (self, g_value_get_string (value));
                 break;
+        case PROP_RAMP_DURATION:
+                gvc_channel_bar_set_ramp_duration (self, g_value_get_uint (value));
+                break;
         default:
                 G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
                 break;
@@ -967,6 +1277,9 @@ gvc_channel_bar_get_property (GObject     *object,
         case PROP_NAME:
                 g_value_set_string (value, gtk_label_get_text (GTK_LABEL (self->priv->label)));
                 break;
+        case PROP_RAMP_DURATION:
+                g_value_set_uint (value, self->priv->ramp_duration);
+                break;
         default:
                 G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
                 break;
@@ -978,6 +1291,7 @@ gvc_channel_bar_class_init (GvcChannelBarClass *klass)
 {
         GObjectClass *object_class = G_OBJECT_CLASS (klass);
 
+        object_class->dispose = gvc_channel_bar_dispose;
         object_class->set_property = gvc_channel_bar_set_property;
         object_class->get_property = gvc_channel_bar_get_property;
 
@@ -1070,6 +1384,16 @@ gvc_channel_bar_class_init (GvcChannelBarClass *klass)
                                      G_PARAM_CONSTRUCT |
                                      G_PARAM_STATIC_STRINGS);
 
+        properties[PROP_RAMP_DURATION] =
+                g_param_spec_uint ("ramp-duration",
+                                   "Ramp duration",
+                                   "Duration of volume ramps for mute changes and large jumps in milliseconds, 0 to disable",
+                                   0,
+                                   G_MAXUINT,
+                                   0,
+                                   G_PARAM_READWRITE |
+                                   G_PARAM_STATIC_STRINGS);
+
         g_object_class_install_properties (object_class, N_PROPERTIES, properties);
 
         g_type_class_add_private (klass, sizeof (GvcChannelBarPrivate));
@@ -1135,6 +1459,21 @@ gvc_channel_bar_init (GvcChannelBar *bar)
         gtk_container_add (GTK_CONTAINER (frame), bar->priv->scale_box);
 }
 
+static void
+gvc_channel_bar_dispose (GObject *object)
+{
+        GvcChannelBar *bar = GVC_CHANNEL_BAR (object);
+
+        if (bar->priv->control != NULL) {
+                ramp_finish (bar);
+
+                g_signal_handlers_disconnect_by_data (G_OBJECT (bar->priv->control), bar);
+                g_clear_object (&bar->priv->control);
+        }
+
+        G_OBJECT_CLASS (gvc_channel_bar_parent_class)->dispose (object);
+}
+
 GtkWidget *
 gvc_channel_bar_new (MateMixerStreamControl *control)
 {
@@ -98,6 +98,10 @@ gboolean            gvc_channel_bar_get_extended        (GvcChannelBar      *bar
 void                gvc_channel_bar_set_extended        (GvcChannelBar      *bar,
                                                          gboolean            extended);
 
+guint               gvc_channel_bar_get_ramp_duration   (GvcChannelBar      *bar);
+void                gvc_channel_bar_set_ramp_duration   (GvcChannelBar      *bar,
+                                                         guint               duration);
+
 void                gvc_channel_bar_set_size_group      (GvcChannelBar      *bar,
                                                          GtkSizeGroup       *group,
                                                          gboolean            symmetric);
@@ -0,0 +1,827 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2026 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* Lowers the volume of music and video applications while a phone stream
+ * exists and restores it when the last phone stream goes away.
+ *
+ * The ducker only reacts to controls being added to and removed from the
+ * streams of the context. The volume changes are ramped by a timer which
+ * only runs while a ramp is in progress and which limits the rate of the
+ * volume writes. When the user changes the volume of a ducked application,
+ * the application is left alone and its volume is not restored.
+ *
+ * Moving an application to another device removes its control from one
+ * stream and adds it to another one under the same name. The volume of the
+ * application is remembered across the move, so it is not ducked twice. */
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include <libmatemixer/matemixer.h>
+
+#include "gvc-ducker.h"
+
+#define GVC_DUCKER_GET_PRIVATE(o) (G_TYPE_INSTANCE_GET_PRIVATE ((o), GVC_TYPE_DUCKER, GvcDuckerPrivate))
+
+/* Default volume of the ducked applications relative to their own volume */
+#define DUCK_LEVEL      0.3
+
+/* Length of the volume ramps and the minimum interval between two writes */
+#define RAMP_DURATION   400
+#define RAMP_INTERVAL   50
+
+/* Volume notifications arriving this long after a write are our own echo */
+#define ECHO_WINDOW     250
+
+typedef struct {
+        GvcDucker              *ducker;
+        MateMixerStreamControl *control;
+        MateMixerStream        *stream;
+        guint                   original;
+        guint                   from;
+        guint                   to;
+        guint                   written;
+        gint64                  start_time;
+        gint64                  write_time;
+        gboolean                ramping;
+        gboolean                restoring;
+} DuckedControl;
+
+struct _GvcDuckerPrivate
+{
+        MateMixerContext *context;
+        gboolean          enabled;
+        gdouble           level;
+        gboolean          ducking;
+        GHashTable       *streams;
+        GHashTable       *triggers;
+        GHashTable       *ducked;
+        GHashTable       *detached;
+        guint             ramp_id;
+};
+
+enum
+{
+        PROP_0,
+        PROP_CONTEXT,
+        PROP_ENABLED,
+        PROP_LEVEL,
+        N_PROPERTIES
+};
+
+static GParamSpec *properties[N_PROPERTIES] = { NULL, };
+
+static void gvc_ducker_class_init (GvcDuckerClass *klass);
+static void gvc_ducker_init       (GvcDucker      *ducker);
+static void gvc_ducker_dispose    (GObject        *object);
+static void gvc_ducker_finalize   (GObject        *object);
+
+G_DEFINE_TYPE (GvcDucker, gvc_ducker, G_TYPE_OBJECT)
+
+static gboolean
+is_trigger_control (MateMixerStreamControl *control)
+{
+        return mate_mixer_stream_control_get_media_role (control) ==
+               MATE_MIXER_STREAM_CONTROL_MEDIA_ROLE_PHONE;
+}
+
+static gboolean
+is_duckable_control (MateMixerStreamControl *control)
+{
+        MateMixerStreamControlMediaRole media_role;
+
+        if (mate_mixer_stream_control_get_role (control) != MATE_MIXER_STREAM_CONTROL_ROLE_APPLICATION)
+                return FALSE;
+
+        if (!(mate_mixer_stream_control_get_flags (control) & MATE_MIXER_STREAM_CONTROL_VOLUME_WRITABLE))
+                return FALSE;
+
+        media_role = mate_mixer_stream_control_get_media_role (control);
+
+        return media_role == MATE_MIXER_STREAM_CONTROL_MEDIA_ROLE_MUSIC ||
+               media_role == MATE_MIXER_STREAM_CONTROL_MEDIA_ROLE_VIDEO;
+}
+
+static void
+write_volume (DuckedControl *ducked, guint volume)
+{
+        if (ducked->written == volume)
+                return;
+
+        ducked->written    = volume;
+        ducked->write_time = g_get_monotonic_time ();
+
+        mate_mixer_stream_control_set_volume (ducked->control, volume);
+}
+
+static gboolean
+on_ramp_timeout (GvcDucker *ducker)
+{
+        GHashTableIter iter;
+        DuckedControl *ducked;
+        gint64         now;
+        gboolean       ramping = FALSE;
+
+        now = g_get_monotonic_time ();
+
+        g_hash_table_iter_init (&iter, ducker->priv->ducked);
+
+        while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &ducked) == TRUE) {
+                gdouble progress;
+
+                if (ducked->ramping == FALSE)
+                        continue;
+
+                progress = (gdouble) (now - ducked->start_time) / (RAMP_DURATION * 1000);
+
+                if (progress >= 1.0) {
+                        write_volume (ducked, ducked->to);
+
+                        ducked->ramping = FALSE;
+
+                        /* The application is back at its own volume */
+                        if (ducked->restoring == TRUE)
+                                g_hash_table_iter_remove (&iter);
+                        continue;
+                }
+
+                write_volume (ducked,
+                              ducked->from + ((gdouble) ducked->to - ducked->from) * progress);
+
+                ramping = TRUE;
+        }
+
+        if (ramping == FALSE) {
+                ducker->priv->ramp_id = 0;
+                return G_SOURCE_REMOVE;
+        }
+        return G_SOURCE_CONTINUE;
+}
+
+static void
+ramp_to (GvcDucker *ducker, DuckedControl *ducked, guint volume)
+{
+        ducked->from       = mate_mixer_stream_control_get_volume (ducked->control);
+        ducked->to         = volume;
+        ducked->start_time = g_get_monotonic_time ();
+        ducked->ramping    = TRUE;
+
+        /* All the ramps share a single timer, which stops by itself once
+         * there is nothing left to ramp */
+        if (ducker->priv->ramp_id == 0)
+                ducker->priv->ramp_id = g_timeout_add (RAMP_INTERVAL,
+                                                       (GSourceFunc) on_ramp_timeout,
+                                                       ducker);
+}
+
+static guint
+get_ducked_volume (GvcDucker *ducker, DuckedControl *ducked)
+{
+        guint min = mate_mixer_stream_control_get_min_volume (ducked->control);
+
+        if (ducked->original <= min)
+                return ducked->original;
+
+        return min + (ducked->original - min) * ducker->priv->level;
+}
+
+static void
+on_ducked_control_volume_notify (MateMixerStreamControl *control,
+                                 GParamSpec             *pspec,
+                                 DuckedControl          *ducked)
+{
+        guint volume;
+
+        if (ducked->ramping == TRUE)
+                return;
+
+        if (g_get_monotonic_time () - ducked->write_time < ECHO_WINDOW * 1000)
+                return;
+
+        volume = mate_mixer_stream_control_get_volume (control);
+        if (volume == ducked->written)
+                return;
+
+        /* The volume has been changed by the user, respect it */
+        g_debug ("Volume of %s changed while ducked, it will not be restored",
+                 mate_mixer_stream_control_get_name (control));
+
+        g_hash_table_remove (ducked->ducker->priv->ducked,
+                             mate_mixer_stream_control_get_name (control));
+}
+
+static void
+free_ducked_control (DuckedControl *ducked)
+{
+        g_signal_handlers_disconnect_by_data (G_OBJECT (ducked->control), ducked);
+        g_object_unref (ducked->control);
+        g_slice_free (DuckedControl, ducked);
+}
+
+static void
+attach_control (DuckedControl *ducked, MateMixerStreamControl *control)
+{
+        ducked->control = g_object_ref (control);
+        ducked->stream  = mate_mixer_stream_control_get_stream (control);
+        ducked->written = mate_mixer_stream_control_get_volume (control);
+
+        g_signal_connect (G_OBJECT (control),
+                          "notify::volume",
+                          G_CALLBACK (on_ducked_control_volume_notify),
+                          ducked);
+}
+
+static void
+duck_control (GvcDucker *ducker, MateMixerStreamControl *control)
+{
+        DuckedControl *ducked;
+        const gchar   *name;
+        gpointer       original;
+
+        name = mate_mixer_stream_control_get_name (control);
+
+        ducked = g_hash_table_lookup (ducker->priv->ducked, name);
+        if (ducked == NULL) {
+                ducked = g_slice_new0 (DuckedControl);
+                ducked->ducker = ducker;
+
+                attach_control (ducked, control);
+
+                /* A moved application is already ducked, its own volume
+                 * was remembered when it left the previous stream */
+                if (g_hash_table_lookup_extended (ducker->priv->detached,
+                                                  name,
+                                                  NULL,
+                                                  &original) == TRUE) {
+                        ducked->original = GPOINTER_TO_UINT (original);
+
+                        g_hash_table_remove (ducker->priv->detached, name);
+                } else
+                        ducked->original = ducked->written;
+
+                /* The key is owned by the control, which the entry keeps */
+                g_hash_table_insert (ducker->priv->ducked,
+                                     (gpointer) mate_mixer_stream_control_get_name (control),
+                                     ducked);
+
+                g_debug ("Ducking %s", name);
+        } else if (ducked->control != control) {
+                /* The application has been added to another stream before
+                 * being removed from the previous one */
+                g_hash_table_steal (ducker->priv->ducked, name);
+
+                g_signal_handlers_disconnect_by_data (G_OBJECT (ducked->control), ducked);
+                g_object_unref (ducked->control);
+
+                attach_control (ducked, control);
+
+                g_hash_table_insert (ducker->priv->ducked,
+                                     (gpointer) mate_mixer_stream_control_get_name (control),
+                                     ducked);
+        }
+
+        /* A control which is being restored is simply turned back */
+        ducked->restoring = FALSE;
+
+        ramp_to (ducker, ducked, get_ducked_volume (ducker, ducked));
+}
+
+static void
+duck_stream_controls (GvcDucker *ducker, MateMixerStream *stream)
+{
+        const GList *controls;
+
+        controls = mate_mixer_stream_list_controls (stream);
+        while (controls != NULL) {
+                MateMixerStreamControl *control = MATE_MIXER_STREAM_CONTROL (controls->data);
+
+                if (is_duckable_control (control) == TRUE)
+                        duck_control (ducker, control);
+
+                controls = controls->next;
+        }
+}
+
+static void
+start_ducking (GvcDucker *ducker)
+{
+        const GList *streams;
+
+        if (ducker->priv->ducking == TRUE)
+                return;
+
+        g_debug ("Phone stream active, ducking applications");
+
+        ducker->priv->ducking = TRUE;
+
+        streams = mate_mixer_context_list_streams (ducker->priv->context);
+        while (streams != NULL) {
+                duck_stream_controls (ducker, MATE_MIXER_STREAM (streams->data));
+                streams = streams->next;
+        }
+}
+
+static void
+stop_ducking (GvcDucker *ducker)
+{
+        GHashTableIter iter;
+        DuckedControl *ducked;
+
+        if (ducker->priv->ducking == FALSE)
+                return;
+
+        g_debug ("No phone stream active, restoring applications");
+
+        ducker->priv->ducking = FALSE;
+
+        /* The moved applications have been restored when they left */
+        g_hash_table_remove_all (ducker->priv->detached);
+
+        g_hash_table_iter_init (&iter, ducker->priv->ducked);
+
+        while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &ducked) == TRUE) {
+                ducked->restoring = TRUE;
+
+                ramp_to (ducker, ducked, ducked->original);
+        }
+}
+
+static void
+update_ducking (GvcDucker *ducker)
+{
+        if (ducker->priv->enabled == TRUE && g_hash_table_size (ducker->priv->triggers) > 0)
+                start_ducking (ducker);
+        else
+                stop_ducking (ducker);
+}
+
+static void
+add_control (GvcDucker *ducker, MateMixerStreamControl *control)
+{
+        if (is_trigger_control (control) == TRUE) {
+                /* The stream is only used to find the triggers of a removed
+                 * stream, it is not referenced */
+                g_hash_table_insert (ducker->priv->triggers,
+                                     g_strdup (mate_mixer_stream_control_get_name (control)),
+                                     mate_mixer_stream_control_get_stream (control));
+
+                update_ducking (ducker);
+        } else if (ducker->priv->ducking == TRUE && is_duckable_control (control) == TRUE)
+                duck_control (ducker, control);
+}
+
+/* Drops a ducked control which is going away with its stream, the volume is
+ * restored in case the control is only moving to another stream */
+static void
+detach_control (GvcDucker *ducker, DuckedControl *ducked)
+{
+        const gchar *name;
+
+        name = mate_mixer_stream_control_get_name (ducked->control);
+
+        if (ducker->priv->ducking == TRUE && ducked->restoring == FALSE)
+                g_hash_table_insert (ducker->priv->detached,
+                                     g_strdup (name),
+                                     GUINT_TO_POINTER (ducked->original));
+
+        write_volume (ducked, ducked->original);
+
+        g_hash_table_remove (ducker->priv->ducked, name);
+}
+
+static void
+on_stream_control_added (MateMixerStream *stream,
+                         const gchar     *name,
+                         GvcDucker       *ducker)
+{
+        MateMixerStreamControl *control;
+
+        control = mate_mixer_stream_get_control (stream, name);
+        if (G_UNLIKELY (control == NULL))
+                return;
+
+        add_control (ducker, control);
+}
+
+static void
+on_stream_control_removed (MateMixerStream *stream,
+                           const gchar     *name,
+                           GvcDucker       *ducker)
+{
+        DuckedControl *ducked;
+        gpointer       owner;
+
+        /* The entry may already belong to the stream the control moved to */
+        ducked = g_hash_table_lookup (ducker->priv->ducked, name);
+        if (ducked != NULL && (ducked->stream == NULL || ducked->stream == stream))
+                detach_control (ducker, ducked);
+
+        if (g_hash_table_lookup_extended (ducker->priv->triggers, name, NULL, &owner) == TRUE &&
+            (owner == NULL || owner == stream)) {
+                g_hash_table_remove (ducker->priv->triggers, name);
+
+                update_ducking (ducker);
+        }
+}
+
+static void
+add_stream (GvcDucker *ducker, MateMixerStream *stream)
+{
+        const gchar *name;
+        const GList *controls;
+
+        name = mate_mixer_stream_get_name (stream);
+
+        if (g_hash_table_contains (ducker->priv->streams, name) == TRUE)
+                return;
+
+        g_signal_connect (G_OBJECT (stream),
+                          "control-added",
+                          G_CALLBACK (on_stream_control_added),
+                          ducker);
+        g_signal_connect (G_OBJECT (stream),
+                          "control-removed",
+                          G_CALLBACK (on_stream_control_removed),
+                          ducker);
+
+        g_hash_table_insert (ducker->priv->streams,
+                             g_strdup (name),
+                             g_object_ref (stream));
+
+        controls = mate_mixer_stream_list_controls (stream);
+        while (controls != NULL) {
+                add_control (ducker, MATE_MIXER_STREAM_CONTROL (controls->data));
+                controls = controls->next;
+        }
+}
+
+static void
+free_stream (MateMixerStream *stream)
+{
+        g_signal_handlers_disconnect_matched (G_OBJECT (stream),
+                                              G_SIGNAL_MATCH_FUNC,
+                                              0, 0, NULL,
+                                              on_stream_control_added,
+                                              NULL);
+        g_signal_handlers_disconnect_matched (G_OBJECT (stream),
+                                              G_SIGNAL_MATCH_FUNC,
+                                              0, 0, NULL,
+                                              on_stream_control_removed,
+                                              NULL);
+        g_object_unref (stream);
+}
+
+static void
+on_context_stream_added (MateMixerContext *context,
+                         const gchar      *name,
+                         GvcDucker        *ducker)
+{
+        MateMixerStream *stream;
+
+        stream = mate_mixer_context_get_stream (context, name);
+        if (G_UNLIKELY (stream == NULL))
+                return;
+
+        add_stream (ducker, stream);
+}
+
+static gboolean
+is_trigger_of_stream (gpointer key, gpointer value, gpointer stream)
+{
+        return value == stream;
+}
+
+static void
+on_context_stream_removed (MateMixerContext *context,
+                           const gchar      *name,
+                           GvcDucker        *ducker)
+{
+        MateMixerStream *stream;
+        GHashTableIter   iter;
+        DuckedControl   *ducked;
+        GSList          *list = NULL;
+        GSList          *item;
+
+        stream = g_hash_table_lookup (ducker->priv->streams, name);
+        if (stream == NULL)
+                return;
+
+        /* The controls of the stream are not removed one by one, so forget
+         * about the phone streams and the ducked applications of the stream
+         * here, otherwise the applications would stay ducked forever */
+        g_hash_table_foreach_remove (ducker->priv->triggers, is_trigger_of_stream, stream);
+
+        g_hash_table_iter_init (&iter, ducker->priv->ducked);
+
+        while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &ducked) == TRUE)
+                if (ducked->stream == stream)
+                        list = g_slist_prepend (list, ducked);
+
+        for (item = list; item != NULL; item = item->next)
+                detach_control (ducker, item->data);
+
+        g_slist_free (list);
+
+        g_hash_table_remove (ducker->priv->streams, name);
+
+        update_ducking (ducker);
+}
+
+static void
+add_all_streams (GvcDucker *ducker)
+{
+        const GList *streams;
+
+        streams = mate_mixer_context_list_streams (ducker->priv->context);
+        while (streams != NULL) {
+                add_stream (ducker, MATE_MIXER_STREAM (streams->data));
+                streams = streams->next;
+        }
+}
+
+static void
+on_context_state_notify (MateMixerContext *context,
+                         GParamSpec       *pspec,
+                         GvcDucker        *ducker)
+{
+        MateMixerState state = mate_mixer_context_get_state (context);
+
+        if (state == MATE_MIXER_STATE_READY) {
+                add_all_streams (ducker);
+                return;
+        }
+
+        /* The streams and controls are gone with the connection, there is
+         * nothing left to restore */
+        g_hash_table_remove_all (ducker->priv->ducked);
+        g_hash_table_remove_all (ducker->priv->detached);
+        g_hash_table_remove_all (ducker->priv->triggers);
+        g_hash_table_remove_all (ducker->priv->streams);
+
+        ducker->priv->ducking = FALSE;
+}
+
+static void
+gvc_ducker_set_context (GvcDucker *ducker, MateMixerContext *context)
+{
+        ducker->priv->context = g_object_ref (context);
+
+        g_signal_connect (G_OBJECT (context),
+                          "notify::state",
+                          G_CALLBACK (on_context_state_notify),
+                          ducker);
+        g_signal_connect (G_OBJECT (context),
+                          "stream-added",
+                          G_CALLBACK (on_context_stream_added),
+                          ducker);
+        g_signal_connect (G_OBJECT (context),
+                          "stream-removed",
+                          G_CALLBACK (on_context_stream_removed),
+                          ducker);
+
+        if (mate_mixer_context_get_state (context) == MATE_MIXER_STATE_READY)
+                add_all_streams (ducker);
+}
+
+gboolean
+gvc_ducker_get_enabled (GvcDucker *ducker)
+{
+        g_return_val_if_fail (GVC_IS_DUCKER (ducker), FALSE);
+
+        return ducker->priv->enabled;
+}
+
+void
+gvc_ducker_set_enabled (GvcDucker *ducker, gboolean enabled)
+{
+        g_return_if_fail (GVC_IS_DUCKER (ducker));
+
+        enabled = !!enabled;
+
+        if (ducker->priv->enabled == enabled)
+                return;
+
+        ducker->priv->enabled = enabled;
+
+        update_ducking (ducker);
+
+        g_object_notify_by_pspec (G_OBJECT (ducker), properties[PROP_ENABLED]);
+}
+
+gdouble
+gvc_ducker_get_level (GvcDucker *ducker)
+{
+        g_return_val_if_fail (GVC_IS_DUCKER (ducker), 1.0);
+
+        return ducker->priv->level;
+}
+
+void
+gvc_ducker_set_level (GvcDucker *ducker, gdouble level)
+{
+        GHashTableIter iter;
+        DuckedControl *ducked;
+
+        g_return_if_fail (GVC_IS_DUCKER (ducker));
+
+        level = CLAMP (level, 0.0, 1.0);
+
+        if (ducker->priv->level == level)
+                return;
+
+        ducker->priv->level = level;
+
+        /* Move the applications which are currently ducked to the new level */
+        if (ducker->priv->ducking == TRUE) {
+                g_hash_table_iter_init (&iter, ducker->priv->ducked);
+
+                while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &ducked) == TRUE)
+                        ramp_to (ducker, ducked, get_ducked_volume (ducker, ducked));
+        }
+
+        g_object_notify_by_pspec (G_OBJECT (ducker), properties[PROP_LEVEL]);
+}
+
+static void
+gvc_ducker_set_property (GObject       *object,
+                         guint          prop_id,
+                         const GValue  *value,
+                         GParamSpec    *pspec)
+{
+        GvcDucker *self = GVC_DUCKER (object);
+
+        switch (prop_id) {
+        case PROP_CONTEXT:
+                gvc_ducker_set_context (self, g_value_get_object (value));
+                break;
+        case PROP_ENABLED:
+                gvc_ducker_set_enabled (self, g_value_get_boolean (value));
+                break;
+        case PROP_LEVEL:
+                gvc_ducker_set_level (self, g_value_get_double (value));
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+                break;
+        }
+}
+
+static void
+gvc_ducker_get_property (GObject     *object,
+                         guint        prop_id,
+                         GValue      *value,
+                         GParamSpec  *pspec)
+{
+        GvcDucker *self = GVC_DUCKER (object);
+
+        switch (prop_id) {
+        case PROP_CONTEXT:
+                g_value_set_object (value, self->priv->context);
+                break;
+        case PROP_ENABLED:
+                g_value_set_boolean (value, self->priv->enabled);
+                break;
+        case PROP_LEVEL:
+                g_value_set_double (value, self->priv->level);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+                break;
+        }
+}
+
+static void
+gvc_ducker_class_init (GvcDuckerClass *klass)
+{
+        GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+        object_class->dispose = gvc_ducker_dispose;
+        object_class->finalize = gvc_ducker_finalize;
+        object_class->set_property = gvc_ducker_set_property;
+        object_class->get_property = gvc_ducker_get_property;
+
+        properties[PROP_CONTEXT] =
+                g_param_spec_object ("context",
+                                     "Context",
+                                     "MateMixer context",
+                                     MATE_MIXER_TYPE_CONTEXT,
+                                     G_PARAM_READWRITE |
+                                     G_PARAM_CONSTRUCT_ONLY |
+                                     G_PARAM_STATIC_STRINGS);
+
+        properties[PROP_ENABLED] =
+                g_param_spec_boolean ("enabled",
+                                      "Enabled",
+                                      "Whether applications are ducked while a phone stream is active",
+                                      FALSE,
+                                      G_PARAM_READWRITE |
+                                      G_PARAM_STATIC_STRINGS);
+
+        properties[PROP_LEVEL] =
+                g_param_spec_double ("level",
+                                     "Level",
+                                     "Volume of ducked applications relative to their own volume",
+                                     0.0,
+                                     1.0,
+                                     DUCK_LEVEL,
+                                     G_PARAM_READWRITE |
+                                     G_PARAM_CONSTRUCT |
+                                     G_PARAM_STATIC_STRINGS);
+
+        g_object_class_install_properties (object_class, N_PROPERTIES, properties);
+
+        g_type_class_add_private (klass, sizeof (GvcDuckerPrivate));
+}
+
+static void
+gvc_ducker_init (GvcDucker *ducker)
+{
+        ducker->priv = GVC_DUCKER_GET_PRIVATE (ducker);
+
+        ducker->priv->streams = g_hash_table_new_full (g_str_hash,
+                                                       g_str_equal,
+                                                       g_free,
+                                                       (GDestroyNotify) free_stream);
+        ducker->priv->triggers = g_hash_table_new_full (g_str_hash,
+                                                        g_str_equal,
+                                                        g_free,
+                                                        NULL);
+        ducker->priv->ducked = g_hash_table_new_full (g_str_hash,
+                                                      g_str_equal,
+                                                      NULL,
+                                                      (GDestroyNotify) free_ducked_control);
+        ducker->priv->detached = g_hash_table_new_full (g_str_hash,
+                                                        g_str_equal,
+                                                        g_free,
+                                                        NULL);
+}
+
+static void
+gvc_ducker_dispose (GObject *object)
+{
+        GvcDucker     *ducker = GVC_DUCKER (object);
+        GHashTableIter iter;
+        DuckedControl *ducked;
+
+        if (ducker->priv->ramp_id != 0) {
+                g_source_remove (ducker->priv->ramp_id);
+                ducker->priv->ramp_id = 0;
+        }
+
+        /* Do not leave the applications ducked when going away */
+        g_hash_table_iter_init (&iter, ducker->priv->ducked);
+
+        while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &ducked) == TRUE)
+                write_volume (ducked, ducked->original);
+
+        g_hash_table_remove_all (ducker->priv->ducked);
+        g_hash_table_remove_all (ducker->priv->streams);
+
+        if (ducker->priv->context != NULL) {
+                g_signal_handlers_disconnect_by_data (G_OBJECT (ducker->priv->context),
+                                                      ducker);
+                g_clear_object (&ducker->priv->context);
+        }
+
+        G_OBJECT_CLASS (gvc_ducker_parent_class)->dispose (object);
+}
+
+static void
+gvc_ducker_finalize (GObject *object)
+{
+        GvcDucker *ducker = GVC_DUCKER (object);
+
+        g_hash_table_destroy (ducker->priv->streams);
+        g_hash_table_destroy (ducker->priv->triggers);
+        g_hash_table_destroy (ducker->priv->ducked);
+        g_hash_table_destroy (ducker->priv->detached);
+
+        G_OBJECT_CLASS (gvc_ducker_parent_class)->finalize (object);
+}
+
+GvcDucker *
+gvc_ducker_new (MateMixerContext *context)
+{
+        g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), NULL);
+
+        return g_object_new (GVC_TYPE_DUCKER,
+                             "context", context,
+                             NULL);
+}
@@ -0,0 +1,67 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2026 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef __GVC_DUCKER_H
+#define __GVC_DUCKER_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include <libmatemixer/matemixer.h>
+
+G_BEGIN_DECLS
+
+#define GVC_TYPE_DUCKER         (gvc_ducker_get_type ())
+#define GVC_DUCKER(o)           (G_TYPE_CHECK_INSTANCE_CAST ((o), GVC_TYPE_DUCKER, GvcDucker))
+#define GVC_DUCKER_CLASS(k)     (G_TYPE_CHECK_CLASS_CAST((k), GVC_TYPE_DUCKER, GvcDuckerClass))
+#define GVC_IS_DUCKER(o)        (G_TYPE_CHECK_INSTANCE_TYPE ((o), GVC_TYPE_DUCKER))
+#define GVC_IS_DUCKER_CLASS(k)  (G_TYPE_CHECK_CLASS_TYPE ((k), GVC_TYPE_DUCKER))
+#define GVC_DUCKER_GET_CLASS(o) (G_TYPE_INSTANCE_GET_CLASS ((o), GVC_TYPE_DUCKER, GvcDuckerClass))
+
+typedef struct _GvcDucker         GvcDucker;
+typedef struct _GvcDuckerClass    GvcDuckerClass;
+typedef struct _GvcDuckerPrivate  GvcDuckerPrivate;
+
+struct _GvcDucker
+{
+        GObject                 parent;
+        GvcDuckerPrivate       *priv;
+};
+
+struct _GvcDuckerClass
+{
+        GObjectClass            parent_class;
+};
+
+GType               gvc_ducker_get_type            (void) G_GNUC_CONST;
+
+GvcDucker *         gvc_ducker_new                 (MateMixerContext *context);
+
+gboolean            gvc_ducker_get_enabled         (GvcDucker        *ducker);
+void                gvc_ducker_set_enabled         (GvcDucker        *ducker,
+                                                    gboolean          enabled);
+
+gdouble             gvc_ducker_get_level           (GvcDucker        *ducker);
+void                gvc_ducker_set_level           (GvcDucker        *ducker,
+                                                    gdouble           level);
+
+G_END_DECLS
+
+#endif /* __GVC_DUCKER_H */
@@ -0,0 +1,338 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2026 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* Icons drawn by custom widgets, shared by all the widgets and loaded in
+ * the background.
+ *
+ * The icons are kept per icon theme and keyed by the icon name, size and
+ * scale. When an icon is not available yet, loading of the image is started
+ * in a thread and the widgets asking for it are redrawn once it is ready. */
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gtk/gtk.h>
+
+#include "gvc-icon-cache.h"
+
+#define ICON_CACHE_KEY "gvc-icon-cache"
+
+typedef struct {
+        gchar           *icon_name;
+        gint             size;
+        gint             scale;
+} IconKey;
+
+typedef struct {
+        cairo_surface_t *surface;
+        gboolean         loading;
+        GSList          *waiting;
+} IconEntry;
+
+typedef struct {
+        GtkIconTheme    *theme;
+        GHashTable      *icons;
+        guint            generation;
+} IconCache;
+
+typedef struct {
+        GtkIconTheme    *theme;
+        IconKey         *key;
+        guint            generation;
+} IconRequest;
+
+static guint
+icon_key_hash (gconstpointer data)
+{
+        const IconKey *key = data;
+
+        return g_str_hash (key->icon_name) ^ (key->size << 8) ^ key->scale;
+}
+
+static gboolean
+icon_key_equal (gconstpointer a, gconstpointer b)
+{
+        const IconKey *key_a = a;
+        const IconKey *key_b = b;
+
+        return key_a->size == key_b->size &&
+               key_a->scale == key_b->scale &&
+               g_str_equal (key_a->icon_name, key_b->icon_name);
+}
+
+static void
+free_icon_key (IconKey *key)
+{
+        g_free (key->icon_name);
+        g_slice_free (IconKey, key);
+}
+
+static void
+free_weak_ref (GWeakRef *ref)
+{
+        g_weak_ref_clear (ref);
+        g_slice_free (GWeakRef, ref);
+}
+
+static void
+free_icon_entry (IconEntry *entry)
+{
+        if (entry->surface != NULL)
+                cairo_surface_destroy (entry->surface);
+
+        g_slist_free_full (entry->waiting, (GDestroyNotify) free_weak_ref);
+        g_slice_free (IconEntry, entry);
+}
+
+static void
+on_icon_theme_changed (GtkIconTheme *theme, IconCache *cache)
+{
+        /* Results of loads started before the change are discarded */
+        cache->generation++;
+
+        g_hash_table_remove_all (cache->icons);
+}
+
+static void
+free_icon_cache (IconCache *cache)
+{
+        g_signal_handlers_disconnect_by_func (G_OBJECT (cache->theme),
+                                              on_icon_theme_changed,
+                                              cache);
+
+        g_hash_table_destroy (cache->icons);
+        g_slice_free (IconCache, cache);
+}
+
+static IconCache *
+get_icon_cache (GtkIconTheme *theme)
+{
+        IconCache *cache;
+
+        cache = g_object_get_data (G_OBJECT (theme), ICON_CACHE_KEY);
+        if (cache != NULL)
+                return cache;
+
+        cache = g_slice_new0 (IconCache);
+        cache->theme = theme;
+        cache->icons = g_hash_table_new_full (icon_key_hash,
+                                              icon_key_equal,
+                                              (GDestroyNotify) free_icon_key,
+                                              (GDestroyNotify) free_icon_entry);
+
+        g_signal_connect (G_OBJECT (theme),
+                          "changed",
+                          G_CALLBACK (on_icon_theme_changed),
+                          cache);
+
+        /* The cache lives as long as the icon theme of the screen */
+        g_object_set_data_full (G_OBJECT (theme),
+                                ICON_CACHE_KEY,
+                                cache,
+                                (GDestroyNotify) free_icon_cache);
+        return cache;
+}
+
+static void
+add_waiting_widget (IconEntry *entry, GtkWidget *widget)
+{
+        GSList   *list;
+        GWeakRef *ref;
+
+        for (list = entry->waiting; list != NULL; list = list->next) {
+                GObject  *object;
+                gboolean  found;
+
+                object = g_weak_ref_get (list->data);
+                found  = (object == G_OBJECT (widget));
+
+                if (object != NULL)
+                        g_object_unref (object);
+                if (found == TRUE)
+                        return;
+        }
+
+        ref = g_slice_new (GWeakRef);
+        g_weak_ref_init (ref, widget);
+
+        entry->waiting = g_slist_prepend (entry->waiting, ref);
+}
+
+static void
+free_icon_request (IconRequest *request)
+{
+        free_icon_key (request->key);
+        g_object_unref (request->theme);
+        g_slice_free (IconRequest, request);
+}
+
+static void
+on_icon_loaded (GtkIconInfo  *info,
+                GAsyncResult *result,
+                IconRequest  *request)
+{
+        IconCache *cache;
+        IconEntry *entry;
+        GdkPixbuf *pixbuf;
+        GError    *error = NULL;
+        GSList    *list;
+
+        pixbuf = gtk_icon_info_load_icon_finish (info, result, &error);
+        if (pixbuf == NULL) {
+                g_debug ("Failed to load icon %s: %s",
+                         request->key->icon_name,
+                         error->message);
+                g_error_free (error);
+        }
+
+        cache = get_icon_cache (request->theme);
+
+        /* The cache may have been emptied since the load started */
+        if (request->generation != cache->generation) {
+                if (pixbuf != NULL)
+                        g_object_unref (pixbuf);
+
+                free_icon_request (request);
+                g_object_unref (info);
+                return;
+        }
+
+        entry = g_hash_table_lookup (cache->icons, request->key);
+        if (G_UNLIKELY (entry == NULL)) {
+                if (pixbuf != NULL)
+                        g_object_unref (pixbuf);
+
+                free_icon_request (request);
+                g_object_unref (info);
+                return;
+        }
+
+        entry->loading = FALSE;
+
+        /* A failed icon is remembered as an empty entry and not retried
+         * until the icon theme changes */
+        if (pixbuf != NULL) {
+                entry->surface = gdk_cairo_surface_create_from_pixbuf (pixbuf,
+                                                                       request->key->scale,
+                                                                       NULL);
+                g_object_unref (pixbuf);
+        }
+
+        for (list = entry->waiting; list != NULL; list = list->next) {
+                GtkWidget *widget = g_weak_ref_get (list->data);
+
+                if (widget != NULL) {
+                        gtk_widget_queue_draw (widget);
+                        g_object_unref (widget);
+                }
+        }
+
+        g_slist_free_full (entry->waiting, (GDestroyNotify) free_weak_ref);
+        entry->waiting = NULL;
+
+        free_icon_request (request);
+        g_object_unref (info);
+}
+
+static void
+load_icon (IconCache *cache, IconEntry *entry, const IconKey *key)
+{
+        GtkIconInfo *info;
+        IconRequest *request;
+
+        /* Looking up the file only consults the in-memory index of the
+         * icon theme, reading and scaling the image is done in a thread */
+        info = gtk_icon_theme_lookup_icon_for_scale (cache->theme,
+                                                     key->icon_name,
+                                                     key->size,
+                                                     key->scale,
+                                                     GTK_ICON_LOOKUP_FORCE_SIZE);
+        if (info == NULL) {
+                g_debug ("Icon %s not found in the icon theme", key->icon_name);
+                return;
+        }
+
+        request = g_slice_new (IconRequest);
+        request->theme      = g_object_ref (cache->theme);
+        request->generation = cache->generation;
+        request->key        = g_slice_new (IconKey);
+        request->key->icon_name = g_strdup (key->icon_name);
+        request->key->size      = key->size;
+        request->key->scale     = key->scale;
+
+        entry->loading = TRUE;
+
+        gtk_icon_info_load_icon_async (info,
+                                       NULL,
+                                       (GAsyncReadyCallback) on_icon_loaded,
+                                       request);
+}
+
+/**
+ * gvc_icon_cache_get_surface:
+ * @widget: the widget to draw the icon in
+ * @icon_name: (allow-none): name of the icon
+ * @size: size of the icon in pixels
+ *
+ * Returns the icon from the icon theme of the widget's screen, at the scale
+ * of the widget. If the icon has not been loaded yet, loading is started in
+ * the background and %NULL is returned, the widget is redrawn when the icon
+ * becomes available.
+ *
+ * Returns: (transfer none) (allow-none): the icon surface owned by the cache
+ */
+cairo_surface_t *
+gvc_icon_cache_get_surface (GtkWidget *widget, const gchar *icon_name, gint size)
+{
+        IconCache *cache;
+        IconEntry *entry;
+        IconKey    key;
+
+        g_return_val_if_fail (GTK_IS_WIDGET (widget), NULL);
+
+        if (icon_name == NULL)
+                return NULL;
+
+        cache = get_icon_cache (gtk_icon_theme_get_for_screen (gtk_widget_get_screen (widget)));
+
+        key.icon_name = (gchar *) icon_name;
+        key.size      = size;
+        key.scale     = gtk_widget_get_scale_factor (widget);
+
+        entry = g_hash_table_lookup (cache->icons, &key);
+        if (entry == NULL) {
+                IconKey *stored;
+
+                stored = g_slice_new (IconKey);
+                stored->icon_name = g_strdup (icon_name);
+                stored->size      = key.size;
+                stored->scale     = key.scale;
+
+                entry = g_slice_new0 (IconEntry);
+
+                g_hash_table_insert (cache->icons, stored, entry);
+
+                load_icon (cache, entry, &key);
+        }
+
+        if (entry->loading == TRUE)
+                add_waiting_widget (entry, widget);
+
+        return entry->surface;
+}
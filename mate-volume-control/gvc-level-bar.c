@@ -39,6 +39,10 @@
 #define VERTICAL_BAR_WIDTH         6
 #define MIN_VERTICAL_BAR_HEIGHT    400
 
+/* Linear levels at which the input counts as clipped and as overloaded */
+#define CLIP_LEVEL                 0.99
+#define OVERLOAD_LEVEL             0.9
+
 typedef struct {
         int            peak_num;
         int            max_peak_num;
@@ -50,6 +54,8 @@ typedef struct {
         GdkRGBA        color_bg;
         GdkRGBA        color_fg;
         GdkRGBA        color_dark;
+        GdkRGBA        color_clip;
+        gboolean       clipped;
 } LevelBarLayout;
 
 struct _GvcLevelBarPrivate
@@ -62,6 +68,12 @@ struct _GvcLevelBarPrivate
         gdouble        rms_fraction;
         gdouble        max_peak;
         guint          max_peak_id;
+        gboolean       clipped;
+        gboolean       clipping;
+        guint          clip_count;
+        gint64         overload_start;
+        gint64         overload_time;
+        gdouble        max_level;
         LevelBarLayout layout;
 };
 
@@ -72,6 +84,10 @@ enum
         PROP_RMS_ADJUSTMENT,
         PROP_SCALE,
         PROP_ORIENTATION,
+        PROP_CLIPPED,
+        PROP_CLIP_COUNT,
+        PROP_OVERLOAD_TIME,
+        PROP_MAX_LEVEL,
         N_PROPERTIES
 };
 
@@ -101,6 +117,8 @@ layout_changed (LevelBarLayout *layout1, LevelBarLayout *layout2)
                 return TRUE;
         if (layout1->max_peak_num != layout2->max_peak_num)
                 return TRUE;
+        if (layout1->clipped != layout2->clipped)
+                return TRUE;
 
         if (!gdk_rgba_equal (&layout1->color_fg, &layout2->color_fg))
                 return TRUE;
@@ -176,6 +194,13 @@ bar_calc_layout (GvcLevelBar *bar)
                                                 &bar->priv->layout.color_fg);
         gtk_style_context_restore (context);
 
+        if (gtk_style_context_lookup_color (context,
+                                            "error_color",
+                                            &bar->priv->layout.color_clip) == FALSE)
+                gdk_rgba_parse (&bar->priv->layout.color_clip, "#cc0000");
+
+        bar->priv->layout.clipped = bar->priv->clipped;
+
         gtk_widget_get_allocation (GTK_WIDGET (bar), &allocation);
 
         bar->priv->layout.area.width = allocation.width - 2;
@@ -207,6 +232,62 @@ bar_calc_layout (GvcLevelBar *bar)
         bar->priv->layout.max_peak_num = max_peak_level / bar->priv->layout.delta;
 }
 
+static void
+update_statistics (GvcLevelBar *bar, gdouble value)
+{
+        GvcLevelBarPrivate *priv = bar->priv;
+        gdouble             level;
+        gdouble             min;
+        gdouble             max;
+        gint64              now;
+
+        /* The statistics are kept on the linear level regardless of the
+         * scale used to display it */
+        min = gtk_adjustment_get_lower (priv->peak_adjustment);
+        max = gtk_adjustment_get_upper (priv->peak_adjustment);
+
+        if (G_UNLIKELY (max <= min))
+                return;
+
+        level = (value - min) / (max - min);
+        now   = g_get_monotonic_time ();
+
+        if (level > priv->max_level) {
+                priv->max_level = level;
+                g_object_notify_by_pspec (G_OBJECT (bar), properties[PROP_MAX_LEVEL]);
+        }
+
+        if (level >= OVERLOAD_LEVEL) {
+                if (priv->overload_start == 0)
+                        priv->overload_start = now;
+        } else if (priv->overload_start != 0) {
+                priv->overload_time += now - priv->overload_start;
+                priv->overload_start = 0;
+
+                g_object_notify_by_pspec (G_OBJECT (bar), properties[PROP_OVERLOAD_TIME]);
+        }
+
+        /* A run of clipped samples counts as a single event */
+        if (level >= CLIP_LEVEL) {
+                if (priv->clipping == FALSE) {
+                        priv->clipping = TRUE;
+                        priv->clip_count++;
+
+                        g_debug ("Input clipped (%u times, %.1f s overloaded, maximum %.2f)",
+                                 priv->clip_count,
+                                 (gdouble) priv->overload_time / G_USEC_PER_SEC,
+                                 priv->max_level);
+
+                        g_object_notify_by_pspec (G_OBJECT (bar), properties[PROP_CLIP_COUNT]);
+                }
+                if (priv->clipped == FALSE) {
+                        priv->clipped = TRUE;
+                        g_object_notify_by_pspec (G_OBJECT (bar), properties[PROP_CLIPPED]);
+                }
+        } else
+                priv->clipping = FALSE;
+}
+
 static void
 update_peak_value (GvcLevelBar *bar)
 {
@@ -269,6 +350,119 @@ gvc_level_bar_set_orientation (GvcLevelBar   *bar,
         }
 }
 
+gboolean
+gvc_level_bar_get_clipped (GvcLevelBar *bar)
+{
+        g_return_val_if_fail (GVC_IS_LEVEL_BAR (bar), FALSE);
+
+        return bar->priv->clipped;
+}
+
+/**
+ * gvc_level_bar_push_sample:
+ * @bar: a #GvcLevelBar
+ * @value: a peak value in the range of the peak adjustment
+ *
+ * Feeds a peak value to the clip and overload statistics. The value set on
+ * the peak adjustment is usually smoothed for display, so the statistics
+ * are fed separately with the value reported by the monitor.
+ */
+void
+gvc_level_bar_push_sample (GvcLevelBar *bar, gdouble value)
+{
+        g_return_if_fail (GVC_IS_LEVEL_BAR (bar));
+
+        update_statistics (bar, value);
+}
+
+/**
+ * gvc_level_bar_reset_clipped:
+ * @bar: a #GvcLevelBar
+ *
+ * Clears the clip indicator, which otherwise stays lit once the level has
+ * reached full scale.
+ */
+void
+gvc_level_bar_reset_clipped (GvcLevelBar *bar)
+{
+        g_return_if_fail (GVC_IS_LEVEL_BAR (bar));
+
+        if (bar->priv->clipped == FALSE)
+                return;
+
+        bar->priv->clipped = FALSE;
+
+        bar->priv->layout.clipped = FALSE;
+        gtk_widget_queue_draw (GTK_WIDGET (bar));
+
+        g_object_notify_by_pspec (G_OBJECT (bar), properties[PROP_CLIPPED]);
+}
+
+guint
+gvc_level_bar_get_clip_count (GvcLevelBar *bar)
+{
+        g_return_val_if_fail (GVC_IS_LEVEL_BAR (bar), 0);
+
+        return bar->priv->clip_count;
+}
+
+gdouble
+gvc_level_bar_get_overload_time (GvcLevelBar *bar)
+{
+        gint64 time;
+
+        g_return_val_if_fail (GVC_IS_LEVEL_BAR (bar), 0.0);
+
+        time = bar->priv->overload_time;
+
+        /* Include the overload which is still going on */
+        if (bar->priv->overload_start != 0)
+                time += g_get_monotonic_time () - bar->priv->overload_start;
+
+        return (gdouble) time / G_USEC_PER_SEC;
+}
+
+gdouble
+gvc_level_bar_get_max_level (GvcLevelBar *bar)
+{
+        g_return_val_if_fail (GVC_IS_LEVEL_BAR (bar), 0.0);
+
+        return bar->priv->max_level;
+}
+
+/**
+ * gvc_level_bar_reset_statistics:
+ * @bar: a #GvcLevelBar
+ *
+ * Starts a new session of the clip and overload counters and clears the
+ * clip indicator.
+ */
+void
+gvc_level_bar_reset_statistics (GvcLevelBar *bar)
+{
+        GObject *object;
+
+        g_return_if_fail (GVC_IS_LEVEL_BAR (bar));
+
+        object = G_OBJECT (bar);
+
+        g_object_freeze_notify (object);
+
+        bar->priv->clipping       = FALSE;
+        bar->priv->clip_count     = 0;
+        bar->priv->overload_start = 0;
+        bar->priv->overload_time  = 0;
+        bar->priv->max_level      = 0.0;
+
+        g_object_notify_by_pspec (object, properties[PROP_CLIP_COUNT]);
+        g_object_notify_by_pspec (object, properties[PROP_OVERLOAD_TIME]);
+        g_object_notify_by_pspec (object, properties[PROP_MAX_LEVEL]);
+
+        gvc_level_bar_reset_clipped (bar);
+
+        g_object_thaw_notify (object);
+}
+
 static void
 on_peak_adjustment_value_changed (GtkAdjustment *adjustment,
                                   GvcLevelBar   *bar)
@@ -392,6 +586,11 @@ gvc_level_bar_set_property (GObject       *object,
         case PROP_RMS_ADJUSTMENT:
                 gvc_level_bar_set_rms_adjustment (self, g_value_get_object (value));
                 break;
+        case PROP_CLIPPED:
+                /* The indicator can only be cleared from outside */
+                if (g_value_get_boolean (value) == FALSE)
+                        gvc_level_bar_reset_clipped (self);
+                break;
         default:
                 G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
                 break;
@@ -419,6 +618,18 @@ gvc_level_bar_get_property (GObject     *object,
         case PROP_RMS_ADJUSTMENT:
                 g_value_set_object (value, self->priv->rms_adjustment);
                 break;
+        case PROP_CLIPPED:
+                g_value_set_boolean (value, self->priv->clipped);
+                break;
+        case PROP_CLIP_COUNT:
+                g_value_set_uint (value, self->priv->clip_count);
+                break;
+        case PROP_OVERLOAD_TIME:
+                g_value_set_double (value, gvc_level_bar_get_overload_time (self));
+                break;
+        case PROP_MAX_LEVEL:
+                g_value_set_double (value, self->priv->max_level);
+                break;
         default:
                 G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
                 break;
@@ -579,7 +790,11 @@ gvc_level_bar_draw (GtkWidget *widget, cairo_t *cr)
                                           bar->priv->layout.box_width - 1,
                                           bar->priv->layout.box_height - 1,
                                           bar->priv->layout.box_radius);
-                        if ((bar->priv->layout.max_peak_num - 1) == i) {
+                        if (bar->priv->layout.clipped == TRUE && i == NUM_BOXES - 1) {
+                                /* fill latched clip indicator */
+                                gdk_cairo_set_source_rgba (cr, &bar->priv->layout.color_clip);
+                                cairo_fill_preserve (cr);
+                        } else if ((bar->priv->layout.max_peak_num - 1) == i) {
                                 /* fill peak foreground */
                                 gdk_cairo_set_source_rgba (cr, &bar->priv->layout.color_fg);
                                 cairo_fill_preserve (cr);
@@ -628,7 +843,11 @@ gvc_level_bar_draw (GtkWidget *widget, cairo_t *cr)
                                           bar->priv->layout.box_height - 1,
                                           bar->priv->layout.box_radius);
 
-                        if ((bar->priv->layout.max_peak_num - 1) == i) {
+                        if (bar->priv->layout.clipped == TRUE && i == NUM_BOXES - 1) {
+                                /* fill latched clip indicator */
+                                gdk_cairo_set_source_rgba (cr, &bar->priv->layout.color_clip);
+                                cairo_fill_preserve (cr);
+                        } else if ((bar->priv->layout.max_peak_num - 1) == i) {
                                 /* fill peak foreground */
                                 gdk_cairo_set_source_rgba (cr, &bar->priv->layout.color_fg);
                                 cairo_fill_preserve (cr);
@@ -662,6 +881,31 @@ gvc_level_bar_draw (GtkWidget *widget, cairo_t *cr)
         return FALSE;
 }
 
+static gboolean
+gvc_level_bar_query_tooltip (GtkWidget  *widget,
+                             gint        x,
+                             gint        y,
+                             gboolean    keyboard_mode,
+                             GtkTooltip *tooltip)
+{
+        GvcLevelBar *bar = GVC_LEVEL_BAR (widget);
+        gchar       *text;
+
+        if (bar->priv->max_level <= 0.0)
+                return FALSE;
+
+        text = g_strdup_printf (ngettext ("Maximum level: %d %%\nClipped %u time, overloaded for %.1f s",
+                                          "Maximum level: %d %%\nClipped %u times, overloaded for %.1f s",
+                                          bar->priv->clip_count),
+                                (gint) round (bar->priv->max_level * 100.0),
+                                bar->priv->clip_count,
+                                gvc_level_bar_get_overload_time (bar));
+
+        gtk_tooltip_set_text (tooltip, text);
+        g_free (text);
+        return TRUE;
+}
+
 static void
 gvc_level_bar_class_init (GvcLevelBarClass *klass)
 {
@@ -676,6 +920,7 @@ gvc_level_bar_class_init (GvcLevelBarClass *klass)
         widget_class->get_preferred_width = gvc_level_bar_get_preferred_width;
         widget_class->get_preferred_height = gvc_level_bar_get_preferred_height;
         widget_class->size_allocate = gvc_level_bar_size_allocate;
+        widget_class->query_tooltip = gvc_level_bar_query_tooltip;
 #if GTK_CHECK_VERSION (3, 20, 0)
         gtk_widget_class_set_css_name (widget_class, "gvc-level-bar");
 #endif
@@ -716,6 +961,44 @@ gvc_level_bar_class_init (GvcLevelBarClass *klass)
                                   G_PARAM_CONSTRUCT |
                                   G_PARAM_STATIC_STRINGS);
 
+        properties[PROP_CLIPPED] =
+                g_param_spec_boolean ("clipped",
+                                      "Clipped",
+                                      "Whether the level has reached full scale since the indicator was cleared",
+                                      FALSE,
+                                      G_PARAM_READWRITE |
+                                      G_PARAM_STATIC_STRINGS);
+
+        properties[PROP_CLIP_COUNT] =
+                g_param_spec_uint ("clip-count",
+                                   "Clip Count",
+                                   "Number of times the level has reached full scale",
+                                   0,
+                                   G_MAXUINT,
+                                   0,
+                                   G_PARAM_READABLE |
+                                   G_PARAM_STATIC_STRINGS);
+
+        properties[PROP_OVERLOAD_TIME] =
+                g_param_spec_double ("overload-time",
+                                     "Overload Time",
+                                     "Time in seconds the level has spent near full scale",
+                                     0.0,
+                                     G_MAXDOUBLE,
+                                     0.0,
+                                     G_PARAM_READABLE |
+                                     G_PARAM_STATIC_STRINGS);
+
+        properties[PROP_MAX_LEVEL] =
+                g_param_spec_double ("max-level",
+                                     "Maximum Level",
+                                     "Highest linear level seen",
+                                     0.0,
+                                     1.0,
+                                     0.0,
+                                     G_PARAM_READABLE |
+                                     G_PARAM_STATIC_STRINGS);
+
         g_object_class_install_properties (object_class, N_PROPERTIES, properties);
 
         g_type_class_add_private (klass, sizeof (GvcLevelBarPrivate));
@@ -757,6 +1040,7 @@ gvc_level_bar_init (GvcLevelBar *bar)
                           bar);
 
         gtk_widget_set_has_window (GTK_WIDGET (bar), FALSE);
+        gtk_widget_set_has_tooltip (GTK_WIDGET (bar), TRUE);
 }
 
 static void
@@ -74,6 +74,18 @@ GtkAdjustment *     gvc_level_bar_get_rms_adjustment  (GvcLevelBar   *bar);
 void                gvc_level_bar_set_scale           (GvcLevelBar   *bar,
                                                        GvcLevelScale  scale);
 
+void                gvc_level_bar_push_sample         (GvcLevelBar   *bar,
+                                                       gdouble        value);
+
+gboolean            gvc_level_bar_get_clipped         (GvcLevelBar   *bar);
+void                gvc_level_bar_reset_clipped       (GvcLevelBar   *bar);
+
+guint               gvc_level_bar_get_clip_count      (GvcLevelBar   *bar);
+gdouble             gvc_level_bar_get_overload_time   (GvcLevelBar   *bar);
+gdouble             gvc_level_bar_get_max_level       (GvcLevelBar   *bar);
+
+void                gvc_level_bar_reset_statistics    (GvcLevelBar   *bar);
+
 G_END_DECLS
 
 #endif /* __GVC_LEVEL_BAR_H */
@@ -21,6 +21,7 @@
 
 #include "config.h"
 
+#include <string.h>
 #include <glib.h>
 #include <glib/gi18n.h>
 #include <glib-object.h>
@@ -29,6 +30,8 @@
 #include <gtk/gtk.h>
 #include <libmatemixer/matemixer.h>
 
+#include "gvc-agc.h"
+#include "gvc-app-list.h"
 #include "gvc-channel-bar.h"
 #include "gvc-balance-bar.h"
 #include "gvc-combo-box.h"
@@ -38,6 +41,14 @@
 #include "gvc-speaker-test.h"
 #include "gvc-utils.h"
 
+#define BAR_RAMP_DURATION 120
+
+/* Default time an application stream must exist before it gets a bar */
+#define APP_GRACE_PERIOD   500
+
+/* Time in milliseconds to wait for more typing before filtering the lists */
+#define SEARCH_DEBOUNCE    150
+
 #define GVC_MIXER_DIALOG_GET_PRIVATE(o) (G_TYPE_INSTANCE_GET_PRIVATE ((o), GVC_TYPE_MIXER_DIALOG, GvcMixerDialogPrivate))
 
 struct _GvcMixerDialogPrivate
@@ -53,11 +64,17 @@ struct _GvcMixerDialogPrivate
         GtkWidget        *output_stream_box;
         GtkWidget        *hw_box;
         GtkWidget        *hw_treeview;
+        GtkWidget        *hw_search_entry;
+        guint             hw_filter_id;
+        gchar            *hw_filter;
         GtkWidget        *hw_settings_box;
         GtkWidget        *hw_profile_combo;
         GtkWidget        *input_box;
         GtkWidget        *output_box;
-        GtkWidget        *applications_box;
+        GtkWidget        *applications_list;
+        GtkWidget        *applications_tools_box;
+        GtkWidget        *applications_search_entry;
+        guint             applications_filter_id;
         GtkWidget        *applications_window;
         GtkWidget        *no_apps_label;
         GtkWidget        *output_treeview;
@@ -70,11 +87,20 @@ struct _GvcMixerDialogPrivate
         GtkWidget        *input_treeview;
         GtkWidget        *input_port_combo;
         GtkWidget        *input_settings_box;
+        GtkWidget        *input_agc_button;
+        GvcAgc           *input_agc;
         GtkSizeGroup     *size_group;
         gdouble           last_input_peak;
-        guint             num_apps;
+        GHashTable       *pending_apps;
+        guint             app_grace_period;
 };
 
+typedef struct {
+        GvcMixerDialog         *dialog;
+        MateMixerStreamControl *control;
+        guint                   timeout_id;
+} PendingApp;
+
 enum {
         ICON_COLUMN,
         NAME_COLUMN,
@@ -90,6 +116,7 @@ enum {
         HW_LABEL_COLUMN,
         HW_STATUS_COLUMN,
         HW_PROFILE_COLUMN,
+        HW_SEARCH_KEY_COLUMN,
         HW_NUM_COLUMNS
 };
 
@@ -103,7 +130,8 @@ enum {
 
 enum {
         PROP_0,
-        PROP_CONTEXT
+        PROP_CONTEXT,
+        PROP_APP_GRACE_PERIOD
 };
 
 static const guint tab_accel_keys[] = {
@@ -254,6 +282,7 @@ update_output_settings (GvcMixerDialog *dialog)
         MateMixerStreamControl     *control;
         MateMixerStreamControlFlags flags;
         MateMixerSwitch            *port_switch;
+        const GvcChannelTable      *channels;
         gboolean                    has_settings = FALSE;
 
         g_debug ("Updating output settings");
@@ -290,7 +319,8 @@ update_output_settings (GvcMixerDialog *dialog)
                 gtk_widget_hide (dialog->priv->output_settings_frame);
                 return;
         }
-        flags = mate_mixer_stream_control_get_flags (control);
+        flags    = mate_mixer_stream_control_get_flags (control);
+        channels = gvc_channel_table_get (control);
 
         /* Enable balance bar if it is available */
         if (flags & MATE_MIXER_STREAM_CONTROL_CAN_BALANCE) {
@@ -327,7 +357,7 @@ update_output_settings (GvcMixerDialog *dialog)
         }
 
         /* Enable subwoofer volume bar if subwoofer is available */
-        if (mate_mixer_stream_control_has_channel_position (control, MATE_MIXER_CHANNEL_LFE)) {
+        if (gvc_channel_table_get_index (channels, MATE_MIXER_CHANNEL_LFE) > -1) {
                 dialog->priv->output_lfe_bar =
                         gvc_balance_bar_new (control, BALANCE_TYPE_LFE);
 
@@ -446,6 +476,14 @@ on_stream_control_monitor_value (MateMixerStream *stream,
 {
         GtkAdjustment *adj;
 
+        if (dialog->priv->input_agc != NULL)
+                gvc_agc_process (dialog->priv->input_agc, value);
+
+        /* The statistics are kept on the raw value, the decay below is
+         * only for display and would hide short clips */
+        gvc_level_bar_push_sample (GVC_LEVEL_BAR (dialog->priv->input_level_bar),
+                                   MAX (value, 0.0));
+
         if (dialog->priv->last_input_peak >= DECAY_STEP) {
                 if (value < dialog->priv->last_input_peak - DECAY_STEP) {
                         value = dialog->priv->last_input_peak - DECAY_STEP;
@@ -461,6 +499,18 @@ on_stream_control_monitor_value (MateMixerStream *stream,
                 gtk_adjustment_set_value (adj, 0.0);
 }
 
+static gboolean
+on_input_level_button_press (GtkWidget      *widget,
+                             GdkEventButton *event,
+                             GvcMixerDialog *dialog)
+{
+        if (event->type != GDK_BUTTON_PRESS || event->button != 1)
+                return FALSE;
+
+        gvc_level_bar_reset_clipped (GVC_LEVEL_BAR (dialog->priv->input_level_bar));
+        return TRUE;
+}
+
 static void
 update_input_settings (GvcMixerDialog *dialog)
 {
@@ -480,8 +530,11 @@ update_input_settings (GvcMixerDialog *dialog)
 
         /* Get the control currently associated with the input slider */
         control = gvc_channel_bar_get_control (GVC_CHANNEL_BAR (dialog->priv->input_bar));
-        if (control == NULL)
+        if (control == NULL) {
+                gvc_agc_set_control (dialog->priv->input_agc, NULL);
+                gtk_widget_set_sensitive (dialog->priv->input_agc_button, FALSE);
                 return;
+        }
 
         flags = mate_mixer_stream_control_get_flags (control);
 
@@ -492,6 +545,16 @@ update_input_settings (GvcMixerDialog *dialog)
                                   G_CALLBACK (on_stream_control_monitor_value),
                                   dialog);
 
+        /* The gain control needs both the level monitor and a writable volume */
+        if ((flags & MATE_MIXER_STREAM_CONTROL_HAS_MONITOR) &&
+            (flags & MATE_MIXER_STREAM_CONTROL_VOLUME_WRITABLE)) {
+                gvc_agc_set_control (dialog->priv->input_agc, control);
+                gtk_widget_set_sensitive (dialog->priv->input_agc_button, TRUE);
+        } else {
+                gvc_agc_set_control (dialog->priv->input_agc, NULL);
+                gtk_widget_set_sensitive (dialog->priv->input_agc_button, FALSE);
+        }
+
         /* Get owning stream of the control */
         stream = mate_mixer_stream_control_get_stream (control);
         if (G_UNLIKELY (stream == NULL))
@@ -555,6 +618,9 @@ set_input_stream (GvcMixerDialog *dialog, MateMixerStream *stream)
 
         bar_set_stream (dialog, dialog->priv->input_bar, stream);
 
+        /* Clipping of the previous device says nothing about the new one */
+        gvc_level_bar_reset_statistics (GVC_LEVEL_BAR (dialog->priv->input_level_bar));
+
         if (stream != NULL) {
                 const GList *controls;
                 guint page = gtk_notebook_get_current_page (GTK_NOTEBOOK (dialog->priv->notebook));
@@ -632,7 +698,8 @@ create_bar (GvcMixerDialog *dialog, gboolean use_size_group, gboolean symmetric)
                       "show-mute",   TRUE,
                       "show-icons",  TRUE,
                       "show-marks",  TRUE,
-                      "extended",    TRUE, NULL);
+                      "extended",    TRUE,
+                      "ramp-duration", BAR_RAMP_DURATION, NULL);
         return bar;
 }
 
@@ -696,6 +763,20 @@ bar_set_stream_control (GvcMixerDialog         *dialog,
                 gtk_widget_set_sensitive (GTK_WIDGET (bar), TRUE);
 }
 
+static void
+update_applications_visibility (GvcMixerDialog *dialog)
+{
+        if (gvc_app_list_get_n_items (GVC_APP_LIST (dialog->priv->applications_list)) > 0) {
+                gtk_widget_hide (dialog->priv->no_apps_label);
+                gtk_widget_show (dialog->priv->applications_tools_box);
+                gtk_widget_show (dialog->priv->applications_window);
+        } else {
+                gtk_widget_hide (dialog->priv->applications_window);
+                gtk_widget_hide (dialog->priv->applications_tools_box);
+                gtk_widget_show (dialog->priv->no_apps_label);
+        }
+}
+
 static void
 add_application_control (GvcMixerDialog *dialog, MateMixerStreamControl *control)
 {
@@ -703,7 +784,6 @@ add_application_control (GvcMixerDialog *dialog, MateMixerStreamControl *control
         MateMixerStreamControlMediaRole media_role;
         MateMixerAppInfo               *info;
         MateMixerDirection              direction = MATE_MIXER_DIRECTION_UNKNOWN;
-        GtkWidget                      *bar;
         const gchar                    *app_id;
         const gchar                    *app_name;
         const gchar                    *app_icon;
@@ -740,25 +820,10 @@ add_application_control (GvcMixerDialog *dialog, MateMixerStreamControl *control
         if (G_UNLIKELY (app_name == NULL))
                 return;
 
-        bar = create_bar (dialog, FALSE, FALSE);
-
-        g_object_set (G_OBJECT (bar),
-                      "show-marks", FALSE,
-                      "extended", FALSE,
-                      NULL);
-
-        /* By default channel bars use speaker icons, use microphone icons
-         * instead for recording applications */
         stream = mate_mixer_stream_control_get_stream (control);
         if (stream != NULL)
                 direction = mate_mixer_stream_get_direction (stream);
 
-        if (direction == MATE_MIXER_DIRECTION_INPUT)
-                g_object_set (G_OBJECT (bar),
-                              "low-icon-name", "audio-input-microphone-low",
-                              "high-icon-name", "audio-input-microphone-high",
-                              NULL);
-
         app_icon = mate_mixer_app_info_get_icon (info);
         if (app_icon == NULL) {
                 if (direction == MATE_MIXER_DIRECTION_INPUT)
@@ -767,18 +832,80 @@ add_application_control (GvcMixerDialog *dialog, MateMixerStreamControl *control
                         app_icon = "applications-multimedia";
         }
 
-        gvc_channel_bar_set_name (GVC_CHANNEL_BAR (bar), app_name);
-        gvc_channel_bar_set_icon_name (GVC_CHANNEL_BAR (bar), app_icon);
+        g_debug ("Adding stream control %s for application %s",
+                 mate_mixer_stream_control_get_name (control),
+                 app_name);
 
-        gtk_box_pack_start (GTK_BOX (dialog->priv->applications_box),
-                            bar,
-                            FALSE, FALSE, 12);
+        /* The list only creates bars for the applications in view */
+        gvc_app_list_add (GVC_APP_LIST (dialog->priv->applications_list),
+                          control,
+                          app_name,
+                          app_icon);
 
-        bar_set_stream_control (dialog, bar, control);
-        dialog->priv->num_apps++;
+        update_applications_visibility (dialog);
+}
+
+static void
+free_pending_app (PendingApp *pending)
+{
+        if (pending->timeout_id != 0)
+                g_source_remove (pending->timeout_id);
+
+        g_object_unref (pending->control);
+        g_slice_free (PendingApp, pending);
+}
+
+static gboolean
+on_pending_app_timeout (PendingApp *pending)
+{
+        GvcMixerDialog         *dialog = pending->dialog;
+        MateMixerStreamControl *control;
+        MateMixerStream        *stream;
+        const gchar            *name;
+
+        pending->timeout_id = 0;
+
+        control = g_object_ref (pending->control);
+        name    = mate_mixer_stream_control_get_name (control);
+
+        g_hash_table_remove (dialog->priv->pending_apps, name);
+
+        /* Make sure the control was not removed together with its stream */
+        stream = mate_mixer_stream_control_get_stream (control);
+        if (stream != NULL && mate_mixer_stream_get_control (stream, name) == control)
+                add_application_control (dialog, control);
+
+        g_object_unref (control);
+        return G_SOURCE_REMOVE;
+}
+
+static void
+schedule_application_control (GvcMixerDialog *dialog, MateMixerStreamControl *control)
+{
+        PendingApp  *pending;
+        const gchar *name;
+
+        if (dialog->priv->app_grace_period == 0) {
+                add_application_control (dialog, control);
+                return;
+        }
+
+        name = mate_mixer_stream_control_get_name (control);
+
+        if (g_hash_table_contains (dialog->priv->pending_apps, name) == TRUE ||
+            gvc_app_list_contains (GVC_APP_LIST (dialog->priv->applications_list), name) == TRUE)
+                return;
+
+        pending = g_slice_new (PendingApp);
+        pending->dialog  = dialog;
+        pending->control = g_object_ref (control);
+        pending->timeout_id =
+                g_timeout_add (dialog->priv->app_grace_period,
+                               (GSourceFunc) on_pending_app_timeout,
+                               pending);
 
-        gtk_widget_hide (dialog->priv->no_apps_label);
-        gtk_widget_show (bar);
+        /* The name is owned by the control, which the pending entry keeps */
+        g_hash_table_insert (dialog->priv->pending_apps, (gpointer) name, pending);
 }
 
 static void
@@ -796,7 +923,7 @@ on_stream_control_added (MateMixerStream *stream,
         role = mate_mixer_stream_control_get_role (control);
 
         if (role == MATE_MIXER_STREAM_CONTROL_ROLE_APPLICATION)
-                add_application_control (dialog, control);
+                schedule_application_control (dialog, control);
 }
 
 static void
@@ -806,6 +933,12 @@ on_stream_control_removed (MateMixerStream *stream,
 {
         MateMixerStreamControl *control;
 
+        /* The stream went away before its bar was added, nothing else to do */
+        if (g_hash_table_remove (dialog->priv->pending_apps, name) == TRUE) {
+                g_debug ("Dropping short-lived application stream %s", name);
+                return;
+        }
+
         control = gvc_channel_bar_get_control (GVC_CHANNEL_BAR (dialog->priv->input_bar));
         if (control != NULL) {
                 const gchar *input_name = mate_mixer_stream_control_get_name (control);
@@ -1013,29 +1146,12 @@ remove_stream (GvcMixerDialog *dialog, const gchar *name)
 static void
 remove_application_control (GvcMixerDialog *dialog, const gchar *name)
 {
-        GtkWidget *bar;
-
-        bar = g_hash_table_lookup (dialog->priv->bars, name);
-        if (G_UNLIKELY (bar == NULL))
+        if (gvc_app_list_remove (GVC_APP_LIST (dialog->priv->applications_list), name) == FALSE)
                 return;
 
-        g_debug ("Removing application stream %s", name);
-
-        /* We could call bar_set_stream_control here, but that would pointlessly
-         * invalidate the channel bar, so just remove it ourselves */
-        g_hash_table_remove (dialog->priv->bars, name);
-
-        gtk_container_remove (GTK_CONTAINER (gtk_widget_get_parent (bar)), bar);
+        g_debug ("Removed application stream %s", name);
 
-        if (G_UNLIKELY (dialog->priv->num_apps <= 0)) {
-                g_warn_if_reached ();
-                dialog->priv->num_apps = 1;
-        }
-
-        dialog->priv->num_apps--;
-
-        if (dialog->priv->num_apps == 0)
-                gtk_widget_show (dialog->priv->no_apps_label);
+        update_applications_visibility (dialog);
 }
 
 static void
@@ -1159,6 +1275,28 @@ device_status (MateMixerDevice *device)
         return outputs_str;
 }
 
+static GtkTreeModel *
+get_device_model (GvcMixerDialog *dialog)
+{
+        GtkTreeModel *model;
+
+        /* The tree view shows a filtered view of the device store */
+        model = gtk_tree_view_get_model (GTK_TREE_VIEW (dialog->priv->hw_treeview));
+
+        return gtk_tree_model_filter_get_model (GTK_TREE_MODEL_FILTER (model));
+}
+
+static gchar *
+create_device_search_key (MateMixerDevice *device)
+{
+        const gchar *fields[2];
+
+        fields[0] = mate_mixer_device_get_label (device);
+        fields[1] = mate_mixer_device_get_name (device);
+
+        return gvc_search_key_new (fields, G_N_ELEMENTS (fields));
+}
+
 static void
 update_device_info (GvcMixerDialog *dialog, MateMixerDevice *device)
 {
@@ -1167,9 +1305,10 @@ update_device_info (GvcMixerDialog *dialog, MateMixerDevice *device)
         const gchar     *label;
         const gchar     *profile_label = NULL;
         gchar           *status;
+        gchar           *key;
         MateMixerSwitch *profile_switch;
 
-        model = gtk_tree_view_get_model (GTK_TREE_VIEW (dialog->priv->hw_treeview));
+        model = get_device_model (dialog);
 
         if (find_tree_item_by_name (model,
                                     mate_mixer_device_get_name (device),
@@ -1189,14 +1328,17 @@ update_device_info (GvcMixerDialog *dialog, MateMixerDevice *device)
         }
 
         status = device_status (device);
+        key    = create_device_search_key (device);
 
         gtk_list_store_set (GTK_LIST_STORE (model),
                             &iter,
                             HW_LABEL_COLUMN, label,
                             HW_PROFILE_COLUMN, profile_label,
                             HW_STATUS_COLUMN, status,
+                            HW_SEARCH_KEY_COLUMN, key,
                             -1);
         g_free (status);
+        g_free (key);
 }
 
 static void
@@ -1220,10 +1362,11 @@ add_device (GvcMixerDialog *dialog, MateMixerDevice *device)
         const gchar     *name;
         const gchar     *label;
         gchar           *status;
+        gchar           *key;
         const gchar     *profile_label = NULL;
         MateMixerSwitch *profile_switch;
 
-        model = gtk_tree_view_get_model (GTK_TREE_VIEW (dialog->priv->hw_treeview));
+        model = get_device_model (dialog);
 
         name  = mate_mixer_device_get_name (device);
         label = mate_mixer_device_get_label (device);
@@ -1251,6 +1394,7 @@ add_device (GvcMixerDialog *dialog, MateMixerDevice *device)
         }
 
         status = device_status (device);
+        key    = create_device_search_key (device);
 
         gtk_list_store_set (GTK_LIST_STORE (model),
                             &iter,
@@ -1259,8 +1403,10 @@ add_device (GvcMixerDialog *dialog, MateMixerDevice *device)
                             HW_ICON_COLUMN, icon,
                             HW_PROFILE_COLUMN, profile_label,
                             HW_STATUS_COLUMN, status,
+                            HW_SEARCH_KEY_COLUMN, key,
                             -1);
         g_free (status);
+        g_free (key);
 
 }
 
@@ -1285,7 +1431,7 @@ on_context_device_removed (MateMixerContext *context,
         GtkTreeModel *model;
 
         /* Remove from the device model */
-        model = gtk_tree_view_get_model (GTK_TREE_VIEW (dialog->priv->hw_treeview));
+        model = get_device_model (dialog);
 
         if (find_tree_item_by_name (GTK_TREE_MODEL (model),
                                     name,
@@ -1729,11 +1875,32 @@ compare_device_treeview_items (GtkTreeModel *model,
         return result;
 }
 
+static gboolean
+device_visible_func (GtkTreeModel *model, GtkTreeIter *iter, gpointer user_data)
+{
+        GvcMixerDialog *dialog = GVC_MIXER_DIALOG (user_data);
+        gchar          *key;
+        gboolean        visible;
+
+        if (dialog->priv->hw_filter == NULL)
+                return TRUE;
+
+        gtk_tree_model_get (model, iter,
+                            HW_SEARCH_KEY_COLUMN, &key,
+                            -1);
+
+        visible = key != NULL && strstr (key, dialog->priv->hw_filter) != NULL;
+
+        g_free (key);
+        return visible;
+}
+
 static GtkWidget *
 create_device_treeview (GvcMixerDialog *dialog, GCallback on_changed)
 {
         GtkWidget         *treeview;
         GtkListStore      *store;
+        GtkTreeModel      *filter;
         GtkCellRenderer   *renderer;
         GtkTreeViewColumn *column;
         GtkTreeSelection  *selection;
@@ -1752,10 +1919,17 @@ create_device_treeview (GvcMixerDialog *dialog, GCallback on_changed)
                                     G_TYPE_STRING,
                                     G_TYPE_STRING,
                                     G_TYPE_STRING,
+                                    G_TYPE_STRING,
                                     G_TYPE_STRING);
 
-        gtk_tree_view_set_model (GTK_TREE_VIEW (treeview),
-                                 GTK_TREE_MODEL (store));
+        filter = gtk_tree_model_filter_new (GTK_TREE_MODEL (store), NULL);
+        gtk_tree_model_filter_set_visible_func (GTK_TREE_MODEL_FILTER (filter),
+                                                device_visible_func,
+                                                dialog,
+                                                NULL);
+
+        gtk_tree_view_set_model (GTK_TREE_VIEW (treeview), filter);
+        g_object_unref (filter);
 
         renderer = gtk_cell_renderer_pixbuf_new ();
         g_object_set (G_OBJECT (renderer),
@@ -1808,6 +1982,206 @@ dialog_accel_cb (GtkAccelGroup    *accelgroup,
                 gtk_notebook_set_current_page (GTK_NOTEBOOK (self->priv->notebook), num);
 }
 
+static void
+apply_applications_filter (GvcMixerDialog *dialog)
+{
+        const gchar *text;
+
+        text = gtk_entry_get_text (GTK_ENTRY (dialog->priv->applications_search_entry));
+
+        gvc_app_list_set_filter (GVC_APP_LIST (dialog->priv->applications_list), text);
+}
+
+static gboolean
+on_applications_filter_timeout (GvcMixerDialog *dialog)
+{
+        dialog->priv->applications_filter_id = 0;
+
+        apply_applications_filter (dialog);
+        return G_SOURCE_REMOVE;
+}
+
+static void
+on_applications_search_changed (GtkEntry *entry, GvcMixerDialog *dialog)
+{
+        /* Wait until the user stops typing before filtering the list */
+        if (dialog->priv->applications_filter_id != 0)
+                g_source_remove (dialog->priv->applications_filter_id);
+
+        dialog->priv->applications_filter_id =
+                g_timeout_add (SEARCH_DEBOUNCE,
+                               (GSourceFunc) on_applications_filter_timeout,
+                               dialog);
+}
+
+static void
+on_applications_search_activate (GtkEntry *entry, GvcMixerDialog *dialog)
+{
+        if (dialog->priv->applications_filter_id != 0) {
+                g_source_remove (dialog->priv->applications_filter_id);
+                dialog->priv->applications_filter_id = 0;
+        }
+
+        apply_applications_filter (dialog);
+}
+
+static void
+on_mute_all_activate (GtkMenuItem *item, GvcMixerDialog *dialog)
+{
+        gvc_app_list_set_all_mute (GVC_APP_LIST (dialog->priv->applications_list), TRUE, FALSE);
+}
+
+static void
+on_unmute_all_activate (GtkMenuItem *item, GvcMixerDialog *dialog)
+{
+        gvc_app_list_set_all_mute (GVC_APP_LIST (dialog->priv->applications_list), FALSE, FALSE);
+}
+
+static void
+on_mute_others_activate (GtkMenuItem *item, GvcMixerDialog *dialog)
+{
+        gvc_app_list_set_all_mute (GVC_APP_LIST (dialog->priv->applications_list), TRUE, TRUE);
+}
+
+static void
+on_set_all_volume_activate (GtkMenuItem *item, GvcMixerDialog *dialog)
+{
+        gint percent;
+
+        percent = GPOINTER_TO_INT (g_object_get_data (G_OBJECT (item), "percent"));
+
+        gvc_app_list_set_all_volume (GVC_APP_LIST (dialog->priv->applications_list),
+                                     percent / 100.0);
+}
+
+static GtkWidget *
+append_menu_item (GtkWidget *menu, const gchar *label, GCallback callback, gpointer data)
+{
+        GtkWidget *item;
+
+        item = gtk_menu_item_new_with_mnemonic (label);
+        gtk_menu_shell_append (GTK_MENU_SHELL (menu), item);
+
+        if (callback != NULL)
+                g_signal_connect (G_OBJECT (item), "activate", callback, data);
+
+        return item;
+}
+
+static GtkWidget *
+create_applications_menu (GvcMixerDialog *dialog)
+{
+        GtkWidget *menu;
+        GtkWidget *submenu;
+        GtkWidget *item;
+        gint       percent;
+
+        menu = gtk_menu_new ();
+
+        append_menu_item (menu, _("_Mute All"),
+                          G_CALLBACK (on_mute_all_activate),
+                          dialog);
+        append_menu_item (menu, _("_Unmute All"),
+                          G_CALLBACK (on_unmute_all_activate),
+                          dialog);
+        append_menu_item (menu, _("Mute All _Except Selected"),
+                          G_CALLBACK (on_mute_others_activate),
+                          dialog);
+
+        gtk_menu_shell_append (GTK_MENU_SHELL (menu), gtk_separator_menu_item_new ());
+
+        item = append_menu_item (menu, _("_Reset All to 100 %"),
+                                 G_CALLBACK (on_set_all_volume_activate),
+                                 dialog);
+        g_object_set_data (G_OBJECT (item), "percent", GINT_TO_POINTER (100));
+
+        item = append_menu_item (menu, _("_Set All To"), NULL, NULL);
+
+        submenu = gtk_menu_new ();
+        gtk_menu_item_set_submenu (GTK_MENU_ITEM (item), submenu);
+
+        for (percent = 10; percent < 100; percent += 10) {
+                gchar *label;
+
+                /* Translators: volume of all the applications in percent */
+                label = g_strdup_printf (_("%d %%"), percent);
+
+                item = append_menu_item (submenu, label,
+                                         G_CALLBACK (on_set_all_volume_activate),
+                                         dialog);
+                g_object_set_data (G_OBJECT (item), "percent", GINT_TO_POINTER (percent));
+                g_free (label);
+        }
+
+        gtk_widget_show_all (menu);
+        return menu;
+}
+
+static void
+apply_device_filter (GvcMixerDialog *dialog)
+{
+        GtkTreeModel     *model;
+        GtkTreeSelection *selection;
+        GtkTreeIter       iter;
+        const gchar      *text;
+        gchar            *filter = NULL;
+
+        text = gtk_entry_get_text (GTK_ENTRY (dialog->priv->hw_search_entry));
+        if (*text != '\0')
+                filter = gvc_search_text_normalize (text);
+
+        if (g_strcmp0 (filter, dialog->priv->hw_filter) == 0) {
+                g_free (filter);
+                return;
+        }
+
+        g_free (dialog->priv->hw_filter);
+        dialog->priv->hw_filter = filter;
+
+        model = gtk_tree_view_get_model (GTK_TREE_VIEW (dialog->priv->hw_treeview));
+
+        gtk_tree_model_filter_refilter (GTK_TREE_MODEL_FILTER (model));
+
+        /* Keep a device selected if the selected one has been filtered out */
+        selection = gtk_tree_view_get_selection (GTK_TREE_VIEW (dialog->priv->hw_treeview));
+
+        if (gtk_tree_selection_get_selected (selection, NULL, NULL) == FALSE &&
+            gtk_tree_model_get_iter_first (model, &iter) == TRUE)
+                gtk_tree_selection_select_iter (selection, &iter);
+}
+
+static gboolean
+on_device_filter_timeout (GvcMixerDialog *dialog)
+{
+        dialog->priv->hw_filter_id = 0;
+
+        apply_device_filter (dialog);
+        return G_SOURCE_REMOVE;
+}
+
+static void
+on_device_search_changed (GtkEntry *entry, GvcMixerDialog *dialog)
+{
+        if (dialog->priv->hw_filter_id != 0)
+                g_source_remove (dialog->priv->hw_filter_id);
+
+        dialog->priv->hw_filter_id =
+                g_timeout_add (SEARCH_DEBOUNCE,
+                               (GSourceFunc) on_device_filter_timeout,
+                               dialog);
+}
+
+static void
+on_device_search_activate (GtkEntry *entry, GvcMixerDialog *dialog)
+{
+        if (dialog->priv->hw_filter_id != 0) {
+                g_source_remove (dialog->priv->hw_filter_id);
+                dialog->priv->hw_filter_id = 0;
+        }
+
+        apply_device_filter (dialog);
+}
+
 static void
 create_page_effects (GvcMixerDialog *self)
 {
@@ -1881,6 +2255,9 @@ gvc_mixer_dialog_constructor (GType                  type,
         GtkWidget        *scroll_box;
         GtkWidget        *sbox;
         GtkWidget        *ebox;
+        GtkWidget        *level_box;
+        GtkWidget        *group_button;
+        GtkWidget        *actions_button;
         GtkTreeSelection *selection;
         GtkAccelGroup    *accel_group;
         GClosure         *closure;
@@ -1969,15 +2346,35 @@ gvc_mixer_dialog_constructor (GType                  type,
                                                          G_CALLBACK (on_device_selection_changed));
         gtk_label_set_mnemonic_widget (GTK_LABEL (label), self->priv->hw_treeview);
 
+        sbox = gtk_box_new (GTK_ORIENTATION_VERTICAL, 6);
+        gtk_widget_set_margin_top (sbox, 6);
+        gtk_container_add (GTK_CONTAINER (box), sbox);
+
+        self->priv->hw_search_entry = gtk_search_entry_new ();
+        gtk_entry_set_placeholder_text (GTK_ENTRY (self->priv->hw_search_entry),
+                                        _("Search devices"));
+
+        g_signal_connect (G_OBJECT (self->priv->hw_search_entry),
+                          "changed",
+                          G_CALLBACK (on_device_search_changed),
+                          self);
+        g_signal_connect (G_OBJECT (self->priv->hw_search_entry),
+                          "activate",
+                          G_CALLBACK (on_device_search_activate),
+                          self);
+
+        gtk_box_pack_start (GTK_BOX (sbox),
+                            self->priv->hw_search_entry,
+                            FALSE, FALSE, 0);
+
         scroll_box = gtk_scrolled_window_new (NULL, NULL);
-        gtk_widget_set_margin_top (scroll_box, 6);
         gtk_scrolled_window_set_policy (GTK_SCROLLED_WINDOW (scroll_box),
                                         GTK_POLICY_NEVER,
                                         GTK_POLICY_AUTOMATIC);
         gtk_scrolled_window_set_shadow_type (GTK_SCROLLED_WINDOW (scroll_box),
                                              GTK_SHADOW_IN);
         gtk_container_add (GTK_CONTAINER (scroll_box), self->priv->hw_treeview);
-        gtk_container_add (GTK_CONTAINER (box), scroll_box);
+        gtk_box_pack_start (GTK_BOX (sbox), scroll_box, TRUE, TRUE, 0);
 
         selection = gtk_tree_view_get_selection (GTK_TREE_VIEW (self->priv->hw_treeview));
         gtk_tree_selection_set_mode (selection, GTK_SELECTION_SINGLE);
@@ -2041,8 +2438,19 @@ gvc_mixer_dialog_constructor (GType                  type,
                                        GTK_ORIENTATION_HORIZONTAL);
         gvc_level_bar_set_scale (GVC_LEVEL_BAR (self->priv->input_level_bar),
                                  GVC_LEVEL_SCALE_LINEAR);
+
+        /* Clicking the level bar clears its clip indicator */
+        level_box = gtk_event_box_new ();
+        gtk_event_box_set_visible_window (GTK_EVENT_BOX (level_box), FALSE);
+        gtk_container_add (GTK_CONTAINER (level_box), self->priv->input_level_bar);
+
+        g_signal_connect (G_OBJECT (level_box),
+                          "button-press-event",
+                          G_CALLBACK (on_input_level_button_press),
+                          self);
+
         gtk_box_pack_start (GTK_BOX (box),
-                            self->priv->input_level_bar,
+                            level_box,
                             TRUE, TRUE, 6);
 
         gtk_box_pack_start (GTK_BOX (box),
@@ -2055,6 +2463,22 @@ gvc_mixer_dialog_constructor (GType                  type,
                             self->priv->input_settings_box,
                             FALSE, FALSE, 0);
 
+        self->priv->input_agc = gvc_agc_new ();
+        self->priv->input_agc_button =
+                gtk_check_button_new_with_mnemonic (_("Automatically _adjust input volume"));
+
+        gtk_widget_set_tooltip_text (self->priv->input_agc_button,
+                                     _("Keep the input level steady by adjusting the input volume"));
+        gtk_widget_set_sensitive (self->priv->input_agc_button, FALSE);
+
+        g_object_bind_property (self->priv->input_agc_button, "active",
+                                self->priv->input_agc, "enabled",
+                                G_BINDING_BIDIRECTIONAL | G_BINDING_SYNC_CREATE);
+
+        gtk_box_pack_end (GTK_BOX (self->priv->input_settings_box),
+                          self->priv->input_agc_button,
+                          FALSE, FALSE, 0);
+
         box = gtk_frame_new (_("C_hoose a device for sound input:"));
         label = gtk_frame_get_label_widget (GTK_FRAME (box));
         make_label_bold (GTK_LABEL (label));
@@ -2123,6 +2547,48 @@ gvc_mixer_dialog_constructor (GType                  type,
         self->priv->output_settings_frame = box;
 
         /* Applications */
+        box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
+
+        self->priv->applications_tools_box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 12);
+        gtk_widget_set_margin_start (self->priv->applications_tools_box, 12);
+        gtk_widget_set_margin_end (self->priv->applications_tools_box, 12);
+        gtk_widget_set_margin_top (self->priv->applications_tools_box, 12);
+        gtk_box_pack_start (GTK_BOX (box),
+                            self->priv->applications_tools_box,
+                            FALSE, FALSE, 0);
+
+        self->priv->applications_search_entry = gtk_search_entry_new ();
+        gtk_entry_set_placeholder_text (GTK_ENTRY (self->priv->applications_search_entry),
+                                        _("Search applications"));
+
+        g_signal_connect (G_OBJECT (self->priv->applications_search_entry),
+                          "changed",
+                          G_CALLBACK (on_applications_search_changed),
+                          self);
+        g_signal_connect (G_OBJECT (self->priv->applications_search_entry),
+                          "activate",
+                          G_CALLBACK (on_applications_search_activate),
+                          self);
+
+        gtk_box_pack_start (GTK_BOX (self->priv->applications_tools_box),
+                            self->priv->applications_search_entry,
+                            TRUE, TRUE, 0);
+
+        group_button = gtk_check_button_new_with_mnemonic (_("_Group by application"));
+        gtk_box_pack_start (GTK_BOX (self->priv->applications_tools_box),
+                            group_button,
+                            FALSE, FALSE, 0);
+
+        /* Changes applied to all the applications at once */
+        actions_button = gtk_menu_button_new ();
+        gtk_button_set_label (GTK_BUTTON (actions_button), _("Apply to _All"));
+        gtk_button_set_use_underline (GTK_BUTTON (actions_button), TRUE);
+        gtk_menu_button_set_popup (GTK_MENU_BUTTON (actions_button),
+                                   create_applications_menu (self));
+        gtk_box_pack_end (GTK_BOX (self->priv->applications_tools_box),
+                          actions_button,
+                          FALSE, FALSE, 0);
+
         self->priv->applications_window = gtk_scrolled_window_new (NULL, NULL);
         gtk_scrolled_window_set_policy (GTK_SCROLLED_WINDOW (self->priv->applications_window),
                                         GTK_POLICY_NEVER,
@@ -2131,22 +2597,31 @@ gvc_mixer_dialog_constructor (GType                  type,
         gtk_scrolled_window_set_shadow_type (GTK_SCROLLED_WINDOW (self->priv->applications_window),
                                              GTK_SHADOW_NONE);
 
-        self->priv->applications_box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 12);
-        gtk_container_set_border_width (GTK_CONTAINER (self->priv->applications_box), 12);
+        /* The list is scrollable by itself and only creates bars for the
+         * visible applications */
+        self->priv->applications_list = gvc_app_list_new ();
 
-        gtk_container_add (GTK_CONTAINER (self->priv->applications_window),
-                           self->priv->applications_box);
+        /* Streams of the same application may be shown under a single bar */
+        g_object_bind_property (group_button, "active",
+                                self->priv->applications_list, "grouped",
+                                G_BINDING_SYNC_CREATE);
 
-        label = gtk_label_new (_("Applications"));
-        gtk_notebook_append_page (GTK_NOTEBOOK (self->priv->notebook),
-                                  self->priv->applications_window,
-                                  label);
+        gtk_container_add (GTK_CONTAINER (self->priv->applications_window),
+                           self->priv->applications_list);
+        gtk_box_pack_start (GTK_BOX (box),
+                            self->priv->applications_window,
+                            TRUE, TRUE, 0);
 
         self->priv->no_apps_label = gtk_label_new (_("No application is currently playing or recording audio."));
-        gtk_box_pack_start (GTK_BOX (self->priv->applications_box),
+        gtk_box_pack_start (GTK_BOX (box),
                             self->priv->no_apps_label,
                             TRUE, TRUE, 0);
 
+        label = gtk_label_new (_("Applications"));
+        gtk_notebook_append_page (GTK_NOTEBOOK (self->priv->notebook),
+                                  box,
+                                  label);
+
         gtk_widget_show_all (main_vbox);
 
         list = mate_mixer_context_list_streams (self->priv->context);
@@ -2155,6 +2630,8 @@ gvc_mixer_dialog_constructor (GType                  type,
                 list = list->next;
         }
 
+        update_applications_visibility (self);
+
         list = mate_mixer_context_list_devices (self->priv->context);
         while (list != NULL) {
                 add_device (self, MATE_MIXER_DEVICE (list->data));
@@ -2240,6 +2717,9 @@ gvc_mixer_dialog_set_property (GObject       *object,
         case PROP_CONTEXT:
                 gvc_mixer_dialog_set_context (self, g_value_get_object (value));
                 break;
+        case PROP_APP_GRACE_PERIOD:
+                self->priv->app_grace_period = g_value_get_uint (value);
+                break;
         default:
                 G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
                 break;
@@ -2258,6 +2738,9 @@ gvc_mixer_dialog_get_property (GObject     *object,
         case PROP_CONTEXT:
                 g_value_set_object (value, gvc_mixer_dialog_get_context (self));
                 break;
+        case PROP_APP_GRACE_PERIOD:
+                g_value_set_uint (value, self->priv->app_grace_period);
+                break;
         default:
                 G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
                 break;
@@ -2276,6 +2759,19 @@ gvc_mixer_dialog_dispose (GObject *object)
                 g_clear_object (&dialog->priv->context);
         }
 
+        g_hash_table_remove_all (dialog->priv->pending_apps);
+
+        g_clear_object (&dialog->priv->input_agc);
+
+        if (dialog->priv->applications_filter_id != 0) {
+                g_source_remove (dialog->priv->applications_filter_id);
+                dialog->priv->applications_filter_id = 0;
+        }
+        if (dialog->priv->hw_filter_id != 0) {
+                g_source_remove (dialog->priv->hw_filter_id);
+                dialog->priv->hw_filter_id = 0;
+        }
+
         G_OBJECT_CLASS (gvc_mixer_dialog_parent_class)->dispose (object);
 }
 
@@ -2300,6 +2796,18 @@ gvc_mixer_dialog_class_init (GvcMixerDialogClass *klass)
                                                               G_PARAM_CONSTRUCT_ONLY |
                                                               G_PARAM_STATIC_STRINGS));
 
+        g_object_class_install_property (object_class,
+                                         PROP_APP_GRACE_PERIOD,
+                                         g_param_spec_uint ("app-grace-period",
+                                                            "Application grace period",
+                                                            "Time in milliseconds a new application stream must exist before it is shown, 0 to show it immediately",
+                                                            0,
+                                                            G_MAXUINT,
+                                                            APP_GRACE_PERIOD,
+                                                            G_PARAM_READWRITE |
+                                                            G_PARAM_CONSTRUCT |
+                                                            G_PARAM_STATIC_STRINGS));
+
 #if GTK_CHECK_VERSION (3, 20, 0)
         GtkWidgetClass *widget_class  = GTK_WIDGET_CLASS (klass);
         gtk_widget_class_set_css_name (widget_class, "GvcMixerDialog");
@@ -2314,6 +2822,10 @@ gvc_mixer_dialog_init (GvcMixerDialog *dialog)
         dialog->priv = GVC_MIXER_DIALOG_GET_PRIVATE (dialog);
 
         dialog->priv->bars = g_hash_table_new (g_str_hash, g_str_equal);
+        dialog->priv->pending_apps = g_hash_table_new_full (g_str_hash,
+                                                            g_str_equal,
+                                                            NULL,
+                                                            (GDestroyNotify) free_pending_app);
         dialog->priv->size_group = gtk_size_group_new (GTK_SIZE_GROUP_HORIZONTAL);
 }
 
@@ -2325,6 +2837,9 @@ gvc_mixer_dialog_finalize (GObject *object)
         dialog = GVC_MIXER_DIALOG (object);
 
         g_hash_table_destroy (dialog->priv->bars);
+        g_hash_table_destroy (dialog->priv->pending_apps);
+
+        g_free (dialog->priv->hw_filter);
 
         G_OBJECT_CLASS (gvc_mixer_dialog_parent_class)->finalize (object);
 }
@@ -24,8 +24,6 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <unistd.h>
-#include <utime.h>
-#include <errno.h>
 
 #include <glib.h>
 #include <glib/gi18n.h>
@@ -33,10 +31,13 @@
 #include <gio/gio.h>
 #include <gtk/gtk.h>
 #include <canberra-gtk.h>
-#include <libxml/tree.h>
+#include <libxml/parser.h>
 
 #include "gvc-sound-theme-chooser.h"
 #include "sound-theme-file-utils.h"
+#include "sound-theme-index.h"
+#include "sound-alert-reader.h"
+#include "sound-library.h"
 
 #define GVC_SOUND_THEME_CHOOSER_GET_PRIVATE(o) (G_TYPE_INSTANCE_GET_PRIVATE ((o), GVC_TYPE_SOUND_THEME_CHOOSER, GvcSoundThemeChooserPrivate))
 
@@ -47,9 +48,35 @@ struct GvcSoundThemeChooserPrivate
         GtkWidget *theme_box;
         GtkWidget *selection_box;
         GtkWidget *click_feedback_button;
+        GtkWidget *spinner;
         GSettings *sound_settings;
+        GCancellable *cancellable;
+        gboolean   loading;
+        GHashTable *monitors;
+        guint      rescan_id;
+        gboolean   rescanning;
+        gboolean   rescan_again;
+        guint      refresh_id;
+        gboolean   files_preloaded;
+        char      *preloaded_theme;
+        GtkWidget *library_button;
+        GtkWidget *library_clear_button;
+        GCancellable *library_cancellable;
+        GHashTable *alert_iters;
+        GHashTable *theme_iters;
+        char      *active_alert;
 };
 
+typedef struct {
+        char *id;
+        char *name;
+} AlertInfo;
+
+typedef struct {
+        GHashTable *themes;
+        GPtrArray  *alerts;
+} ChooserData;
+
 static void     gvc_sound_theme_chooser_class_init (GvcSoundThemeChooserClass *klass);
 static void     gvc_sound_theme_chooser_init       (GvcSoundThemeChooser      *sound_theme_chooser);
 static void     gvc_sound_theme_chooser_dispose   (GObject            *object);
@@ -65,6 +92,16 @@ G_DEFINE_TYPE (GvcSoundThemeChooser, gvc_sound_theme_chooser, GTK_TYPE_BOX)
 #define CUSTOM_THEME_NAME       "__custom"
 #define NO_SOUNDS_THEME_NAME    "__no_sounds"
 
+/* Canberra identifier of the alert previews, and of their cached samples */
+#define PREVIEW_ID              1
+#define PREVIEW_EVENT_PREFIX    "mate-volume-control-preview-"
+
+/* Largest number of alert sounds cached when the chooser is shown */
+#define PRELOAD_MAX             16
+
+/* Time in milliseconds to wait for more changes in the sound directories */
+#define RESCAN_DELAY            1000
+
 enum {
         THEME_DISPLAY_COL,
         THEME_IDENTIFIER_COL,
@@ -77,6 +114,8 @@ enum {
         ALERT_IDENTIFIER_COL,
         ALERT_SOUND_TYPE_COL,
         ALERT_ACTIVE_COL,
+        ALERT_DETAILS_COL,
+        ALERT_LIBRARY_COL,
         ALERT_NUM_COLS
 };
 
@@ -88,6 +127,28 @@ enum {
         SOUND_TYPE_CUSTOM
 };
 
+static void reset_alert_model (GvcSoundThemeChooser *chooser);
+
+/* Both models are list stores, their iters stay valid until the row is
+ * removed, so they can be kept in an index by identifier */
+static void
+index_row (GHashTable *index, const char *id, GtkTreeIter *iter)
+{
+        g_hash_table_insert (index, g_strdup (id), gtk_tree_iter_copy (iter));
+}
+
+/* Needs to be called before the row is removed */
+static void
+unindex_row (GHashTable *index, const char *id, GtkTreeIter *iter)
+{
+        GtkTreeIter *indexed;
+
+        /* Another row may have the same identifier */
+        indexed = g_hash_table_lookup (index, id);
+        if (indexed != NULL && indexed->user_data == iter->user_data)
+                g_hash_table_remove (index, id);
+}
+
 static void
 on_combobox_changed (GtkComboBox          *widget,
                      GvcSoundThemeChooser *chooser)
@@ -112,113 +173,44 @@ on_combobox_changed (GtkComboBox          *widget,
         /* special case for no sounds */
         if (strcmp (theme_name, NO_SOUNDS_THEME_NAME) == 0) {
                 g_settings_set_boolean (chooser->priv->sound_settings, EVENT_SOUNDS_KEY, FALSE);
-                return;
         } else {
                 g_settings_set_boolean (chooser->priv->sound_settings, EVENT_SOUNDS_KEY, TRUE);
         }
 
         g_free (theme_name);
 
-        /* FIXME: reset alert model */
-}
-
-static char *
-load_index_theme_name (const char *index,
-                       char      **parent)
-{
-        GKeyFile *file;
-        char *indexname = NULL;
-        gboolean hidden;
-
-        file = g_key_file_new ();
-        if (g_key_file_load_from_file (file, index, G_KEY_FILE_KEEP_TRANSLATIONS, NULL) == FALSE) {
-                g_key_file_free (file);
-                return NULL;
-        }
-        /* Don't add hidden themes to the list */
-        hidden = g_key_file_get_boolean (file, "Sound Theme", "Hidden", NULL);
-        if (!hidden) {
-                indexname = g_key_file_get_locale_string (file,
-                                                          "Sound Theme",
-                                                          "Name",
-                                                          NULL,
-                                                          NULL);
-
-                /* Save the parent theme, if there's one */
-                if (parent != NULL) {
-                        *parent = g_key_file_get_string (file,
-                                                         "Sound Theme",
-                                                         "Inherits",
-                                                         NULL);
-                }
-        }
-
-        g_key_file_free (file);
-        return indexname;
-}
-
-static void
-sound_theme_in_dir (GHashTable *hash,
-                    const char *dir)
-{
-        GDir *d;
-        const char *name;
-
-        d = g_dir_open (dir, 0, NULL);
-        if (d == NULL) {
-                return;
-        }
-
-        while ((name = g_dir_read_name (d)) != NULL) {
-                char *dirname, *index, *indexname;
-
-                /* Look for directories */
-                dirname = g_build_filename (dir, name, NULL);
-                if (g_file_test (dirname, G_FILE_TEST_IS_DIR) == FALSE) {
-                        g_free (dirname);
-                        continue;
-                }
-
-                /* Look for index files */
-                index = g_build_filename (dirname, "index.theme", NULL);
-                g_free (dirname);
-
-                /* Check the name of the theme in the index.theme file */
-                indexname = load_index_theme_name (index, NULL);
-                g_free (index);
-                if (indexname == NULL) {
-                        continue;
-                }
-
-                g_hash_table_insert (hash, g_strdup (name), indexname);
-        }
-
-        g_dir_close (d);
+        reset_alert_model (chooser);
 }
 
 static void
-add_theme_to_store (const char   *key,
-                    const char   *value,
-                    GtkListStore *store)
+add_theme_to_store (const char           *key,
+                    SoundThemeInfo       *info,
+                    GvcSoundThemeChooser *chooser)
 {
-        char *parent;
+        GtkTreeModel *model;
+        GtkTreeIter   iter;
+        char         *parent;
 
         parent = NULL;
 
-        /* Get the parent, if we're checking the custom theme */
+        /* Get the parent, if we're checking the custom theme; it is read
+         * again as the index of the custom theme is rewritten in place */
         if (strcmp (key, CUSTOM_THEME_NAME) == 0) {
                 char *name, *path;
 
                 path = custom_theme_dir_path ("index.theme");
-                name = load_index_theme_name (path, &parent);
+                name = sound_theme_index_load_name (path, &parent);
                 g_free (name);
                 g_free (path);
         }
-        gtk_list_store_insert_with_values (store, NULL, G_MAXINT,
-                                           THEME_DISPLAY_COL, value,
+        model = gtk_combo_box_get_model (GTK_COMBO_BOX (chooser->priv->combo_box));
+
+        gtk_list_store_insert_with_values (GTK_LIST_STORE (model), &iter, G_MAXINT,
+                                           THEME_DISPLAY_COL, info->name,
                                            THEME_IDENTIFIER_COL, key,
                                            THEME_PARENT_ID_COL, parent,
                                            -1);
+        index_row (chooser->priv->theme_iters, key, &iter);
         g_free (parent);
 }
 
@@ -226,34 +218,19 @@ static void
 set_combox_for_theme_name (GvcSoundThemeChooser *chooser,
                            const char           *name)
 {
-        GtkTreeIter   iter;
-        GtkTreeModel *model;
-        gboolean      found;
+        GtkTreeIter  *iter;
 
         /* If the name is empty, use "freedesktop" */
         if (name == NULL || *name == '\0') {
                 name = "freedesktop";
         }
 
-        model = gtk_combo_box_get_model (GTK_COMBO_BOX (chooser->priv->combo_box));
-
-        if (gtk_tree_model_get_iter_first (model, &iter) == FALSE) {
-                return;
-        }
-
-        do {
-                char *value;
-
-                gtk_tree_model_get (model, &iter, THEME_IDENTIFIER_COL, &value, -1);
-                found = (value != NULL && strcmp (value, name) == 0);
-                g_free (value);
-
-        } while (!found && gtk_tree_model_iter_next (model, &iter));
+        iter = g_hash_table_lookup (chooser->priv->theme_iters, name);
 
         /* When we can't find the theme we need to set, try to set the default
          * one "freedesktop" */
-        if (found) {
-                gtk_combo_box_set_active_iter (GTK_COMBO_BOX (chooser->priv->combo_box), &iter);
+        if (iter != NULL) {
+                gtk_combo_box_set_active_iter (GTK_COMBO_BOX (chooser->priv->combo_box), iter);
         } else if (strcmp (name, "freedesktop") != 0) {
                 g_debug ("not found, falling back to fdo");
                 set_combox_for_theme_name (chooser, "freedesktop");
@@ -268,40 +245,18 @@ set_input_feedback_enabled (GvcSoundThemeChooser *chooser,
                                       enabled);
 }
 
-static void
-setup_theme_selector (GvcSoundThemeChooser *chooser)
+static gboolean
+fill_theme_selector (GvcSoundThemeChooser *chooser, GHashTable *hash)
 {
-        GHashTable           *hash;
         GtkListStore         *store;
-        GtkCellRenderer      *renderer;
-        const char * const   *data_dirs;
-        const char           *data_dir;
-        char                 *dir;
-        guint                 i;
-
-        /* Add the theme names and their display name to a hash table,
-         * makes it easy to avoid duplicate themes */
-        hash = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
-
-        data_dirs = g_get_system_data_dirs ();
-        for (i = 0; data_dirs[i] != NULL; i++) {
-                dir = g_build_filename (data_dirs[i], "sounds", NULL);
-                sound_theme_in_dir (hash, dir);
-                g_free (dir);
-        }
-
-        data_dir = g_get_user_data_dir ();
-        dir = g_build_filename (data_dir, "sounds", NULL);
-        sound_theme_in_dir (hash, dir);
-        g_free (dir);
+        GtkTreeIter           iter;
 
         /* If there isn't at least one theme, make everything
          * insensitive, LAME! */
         if (g_hash_table_size (hash) == 0) {
                 gtk_widget_set_sensitive (GTK_WIDGET (chooser), FALSE);
                 g_warning ("Bad setup, install the freedesktop sound theme");
-                g_hash_table_destroy (hash);
-                return;
+                return FALSE;
         }
 
         /* Setup the tree model, 3 columns:
@@ -313,20 +268,32 @@ setup_theme_selector (GvcSoundThemeChooser *chooser)
                                     G_TYPE_STRING,
                                     G_TYPE_STRING);
 
+        g_hash_table_remove_all (chooser->priv->theme_iters);
+
+        /* Set the display */
+        gtk_combo_box_set_model (GTK_COMBO_BOX (chooser->priv->combo_box),
+                                 GTK_TREE_MODEL (store));
+        g_object_unref (store);
+
         /* Add the themes to a combobox */
         gtk_list_store_insert_with_values (store,
-                                           NULL,
+                                           &iter,
                                            G_MAXINT,
                                            THEME_DISPLAY_COL, _("No sounds"),
-                                           THEME_IDENTIFIER_COL, "__no_sounds",
+                                           THEME_IDENTIFIER_COL, NO_SOUNDS_THEME_NAME,
                                            THEME_PARENT_ID_COL, NULL,
                                            -1);
-        g_hash_table_foreach (hash, (GHFunc) add_theme_to_store, store);
-        g_hash_table_destroy (hash);
+        index_row (chooser->priv->theme_iters, NO_SOUNDS_THEME_NAME, &iter);
 
-        /* Set the display */
-        gtk_combo_box_set_model (GTK_COMBO_BOX (chooser->priv->combo_box),
-                                 GTK_TREE_MODEL (store));
+        g_hash_table_foreach (hash, (GHFunc) add_theme_to_store, chooser);
+
+        return TRUE;
+}
+
+static void
+setup_theme_selector (GvcSoundThemeChooser *chooser)
+{
+        GtkCellRenderer      *renderer;
 
         renderer = gtk_cell_renderer_text_new ();
         gtk_cell_layout_pack_start (GTK_CELL_LAYOUT (chooser->priv->combo_box),
@@ -343,150 +310,40 @@ setup_theme_selector (GvcSoundThemeChooser *chooser)
                           chooser);
 }
 
-#define GVC_SOUND_SOUND    (xmlChar *) "sound"
-#define GVC_SOUND_NAME     (xmlChar *) "name"
-#define GVC_SOUND_FILENAME (xmlChar *) "filename"
-
-/* Adapted from yelp-toc-pager.c */
-static xmlChar *
-xml_get_and_trim_names (xmlNodePtr node)
+static void
+alert_info_free (AlertInfo *info)
 {
-        xmlNodePtr cur;
-        xmlChar *keep_lang = NULL;
-        xmlChar *value;
-        int j, keep_pri = INT_MAX;
-
-        const gchar * const * langs = g_get_language_names ();
-
-        value = NULL;
-
-        for (cur = node->children; cur; cur = cur->next) {
-                if (! xmlStrcmp (cur->name, GVC_SOUND_NAME)) {
-                        xmlChar *cur_lang = NULL;
-                        int cur_pri = INT_MAX;
-
-                        cur_lang = xmlNodeGetLang (cur);
-
-                        if (cur_lang) {
-                                for (j = 0; langs[j]; j++) {
-                                        if (g_str_equal (cur_lang, langs[j])) {
-                                                cur_pri = j;
-                                                break;
-                                        }
-                                }
-                        } else {
-                                cur_pri = INT_MAX - 1;
-                        }
-
-                        if (cur_pri <= keep_pri) {
-                                if (keep_lang)
-                                        xmlFree (keep_lang);
-                                if (value)
-                                        xmlFree (value);
-
-                                value = xmlNodeGetContent (cur);
-
-                                keep_lang = cur_lang;
-                                keep_pri = cur_pri;
-                        } else {
-                                if (cur_lang)
-                                        xmlFree (cur_lang);
-                        }
-                }
-        }
-
-        /* Delete all GVC_SOUND_NAME nodes */
-        cur = node->children;
-        while (cur) {
-                xmlNodePtr this = cur;
-                cur = cur->next;
-                if (! xmlStrcmp (this->name, GVC_SOUND_NAME)) {
-                        xmlUnlinkNode (this);
-                        xmlFreeNode (this);
-                }
-        }
-
-        return value;
+        g_free (info->id);
+        g_free (info->name);
+        g_slice_free (AlertInfo, info);
 }
 
 static void
-populate_model_from_node (GvcSoundThemeChooser *chooser,
-                          GtkTreeModel         *model,
-                          xmlNodePtr            node)
-{
-        xmlNodePtr child;
-        xmlChar   *filename;
-        xmlChar   *name;
-
-        filename = NULL;
-        name = xml_get_and_trim_names (node);
-        for (child = node->children; child; child = child->next) {
-                if (xmlNodeIsText (child)) {
-                        continue;
-                }
-
-                if (xmlStrcmp (child->name, GVC_SOUND_FILENAME) == 0) {
-                        filename = xmlNodeGetContent (child);
-                } else if (xmlStrcmp (child->name, GVC_SOUND_NAME) == 0) {
-                        /* EH? should have been trimmed */
-                }
-        }
+add_alert (const char *filename, const char *name, GPtrArray *alerts)
+{
+        AlertInfo *info;
 
-        if (filename != NULL && name != NULL) {
-                gtk_list_store_insert_with_values (GTK_LIST_STORE (model),
-                                                   NULL,
-                                                   G_MAXINT,
-                                                   ALERT_IDENTIFIER_COL, filename,
-                                                   ALERT_DISPLAY_COL, name,
-                                                   ALERT_SOUND_TYPE_COL, _("Built-in"),
-                                                   ALERT_ACTIVE_COL, FALSE,
-                                                   -1);
-        }
+        info = g_slice_new (AlertInfo);
+        info->id   = g_strdup (filename);
+        info->name = g_strdup (name);
 
-        xmlFree (filename);
-        xmlFree (name);
+        g_ptr_array_add (alerts, info);
 }
 
 static void
-populate_model_from_file (GvcSoundThemeChooser *chooser,
-                          GtkTreeModel         *model,
-                          const char           *filename)
+load_alerts_from_file (GPtrArray  *alerts,
+                       const char *filename)
 {
-        xmlDocPtr  doc;
-        xmlNodePtr root;
-        xmlNodePtr child;
-        gboolean   exists;
-
-        exists = g_file_test (filename, G_FILE_TEST_EXISTS);
-        if (! exists) {
-                return;
-        }
-
-        doc = xmlParseFile (filename);
-        if (doc == NULL) {
-                return;
-        }
-
-        root = xmlDocGetRootElement (doc);
-
-        for (child = root->children; child; child = child->next) {
-                if (xmlNodeIsText (child)) {
-                        continue;
-                }
-                if (xmlStrcmp (child->name, GVC_SOUND_SOUND) != 0) {
-                        continue;
-                }
-
-                populate_model_from_node (chooser, model, child);
-        }
-
-        xmlFreeDoc (doc);
+        if (sound_alerts_read_file (filename,
+                                    NULL,
+                                    (SoundAlertFunc) add_alert,
+                                    alerts) == FALSE)
+                g_warning ("Failed to parse the alert sounds in '%s'", filename);
 }
 
 static void
-populate_model_from_dir (GvcSoundThemeChooser *chooser,
-                         GtkTreeModel         *model,
-                         const char           *dirname)
+load_alerts_from_dir (GPtrArray  *alerts,
+                      const char *dirname)
 {
         GDir       *d;
         const char *name;
@@ -504,70 +361,67 @@ populate_model_from_dir (GvcSoundThemeChooser *chooser,
                 }
 
                 path = g_build_filename (dirname, name, NULL);
-                populate_model_from_file (chooser, model, path);
+                load_alerts_from_file (alerts, path);
                 g_free (path);
         }
 
         g_dir_close (d);
 }
 
-static gboolean
-save_alert_sounds (GvcSoundThemeChooser  *chooser,
-                   const char            *id)
+static void
+save_alert_sounds (CustomThemeTransaction *transaction,
+                   const char             *id)
 {
         const char *sounds[3] = { "bell-terminal", "bell-window-system", NULL };
-        char *path;
 
-        if (strcmp (id, DEFAULT_ALERT_ID) == 0) {
-                delete_old_files (sounds);
-                delete_disabled_files (sounds);
-        } else {
-                delete_old_files (sounds);
-                delete_disabled_files (sounds);
-                add_custom_file (sounds, id);
-        }
+        if (strcmp (id, DEFAULT_ALERT_ID) == 0)
+                custom_theme_transaction_reset_sounds (transaction, sounds);
+        else
+                custom_theme_transaction_link_sounds (transaction, sounds, id);
+}
 
-        /* And poke the directory so the theme gets updated */
-        path = custom_theme_dir_path (NULL);
-        if (utime (path, NULL) != 0) {
-                g_warning ("Failed to update mtime for directory '%s': %s",
-                           path, g_strerror (errno));
-        }
-        g_free (path);
+static void
+on_custom_theme_committed (GObject      *source_object,
+                           GAsyncResult *result,
+                           gpointer      user_data)
+{
+        GError *error = NULL;
 
-        return FALSE;
+        if (custom_theme_transaction_commit_finish (result, &error) == FALSE) {
+                g_warning ("Failed to save the custom theme: %s", error->message);
+                g_error_free (error);
+        }
 }
 
-
 static void
 update_alert_model (GvcSoundThemeChooser  *chooser,
                     const char            *id)
 {
         GtkTreeModel *model;
-        GtkTreeIter   iter;
+        GtkTreeIter  *iter;
+        char         *active;
 
         model = gtk_tree_view_get_model (GTK_TREE_VIEW (chooser->priv->treeview));
-        gtk_tree_model_get_iter_first (model, &iter);
-        do {
-                gboolean toggled;
-                char    *this_id;
-
-                gtk_tree_model_get (model, &iter,
-                                    ALERT_IDENTIFIER_COL, &this_id,
-                                    -1);
 
-                if (strcmp (this_id, id) == 0) {
-                        toggled = TRUE;
-                } else {
-                        toggled = FALSE;
-                }
-                g_free (this_id);
+        /* Only the previous and the new alert change */
+        if (chooser->priv->active_alert != NULL) {
+                iter = g_hash_table_lookup (chooser->priv->alert_iters,
+                                            chooser->priv->active_alert);
+                if (iter != NULL)
+                        gtk_list_store_set (GTK_LIST_STORE (model), iter,
+                                            ALERT_ACTIVE_COL, FALSE,
+                                            -1);
+        }
 
-                gtk_list_store_set (GTK_LIST_STORE (model),
-                                    &iter,
-                                    ALERT_ACTIVE_COL, toggled,
+        iter = g_hash_table_lookup (chooser->priv->alert_iters, id);
+        if (iter != NULL)
+                gtk_list_store_set (GTK_LIST_STORE (model), iter,
+                                    ALERT_ACTIVE_COL, TRUE,
                                     -1);
-        } while (gtk_tree_model_iter_next (model, &iter));
+
+        active = g_strdup (id);
+        g_free (chooser->priv->active_alert);
+        chooser->priv->active_alert = active;
 }
 
 static void
@@ -582,6 +436,7 @@ update_alert (GvcSoundThemeChooser *chooser,
         gboolean      is_default;
         gboolean      add_custom;
         gboolean      remove_custom;
+        CustomThemeTransaction *transaction;
 
         theme_model = gtk_combo_box_get_model (GTK_COMBO_BOX (chooser->priv->combo_box));
         /* Get the current theme's name, and set the parent */
@@ -591,7 +446,7 @@ update_alert (GvcSoundThemeChooser *chooser,
 
         gtk_tree_model_get (theme_model, &iter,
                             THEME_IDENTIFIER_COL, &theme,
-                            THEME_IDENTIFIER_COL, &parent,
+                            THEME_PARENT_ID_COL, &parent,
                             -1);
         is_custom = strcmp (theme, CUSTOM_THEME_NAME) == 0;
         is_default = strcmp (alert_id, DEFAULT_ALERT_ID) == 0;
@@ -604,49 +459,64 @@ update_alert (GvcSoundThemeChooser *chooser,
          */
         add_custom = FALSE;
         remove_custom = FALSE;
+        transaction = custom_theme_transaction_new ();
+
         if (! is_custom && is_default) {
                 /* remove custom just in case */
                 remove_custom = TRUE;
         } else if (! is_custom && ! is_default) {
-                create_custom_theme (parent);
-                save_alert_sounds (chooser, alert_id);
+                custom_theme_transaction_set_parent (transaction, theme);
+                save_alert_sounds (transaction, alert_id);
                 add_custom = TRUE;
         } else if (is_custom && is_default) {
-                save_alert_sounds (chooser, alert_id);
-                /* after removing files check if it is empty */
+                save_alert_sounds (transaction, alert_id);
+                /* after removing files check if it is empty, the
+                 * snapshot includes the committed changes already */
+                custom_theme_transaction_commit_async (transaction,
+                                                       on_custom_theme_committed,
+                                                       NULL);
+                transaction = NULL;
+
                 if (custom_theme_dir_is_empty ()) {
                         remove_custom = TRUE;
                 }
         } else if (is_custom && ! is_default) {
-                save_alert_sounds (chooser, alert_id);
+                save_alert_sounds (transaction, alert_id);
         }
 
+        if (remove_custom) {
+                if (transaction == NULL)
+                        transaction = custom_theme_transaction_new ();
+
+                custom_theme_transaction_delete_theme (transaction);
+        }
+
+        if (transaction != NULL)
+                custom_theme_transaction_commit_async (transaction,
+                                                       on_custom_theme_committed,
+                                                       NULL);
+
         if (add_custom) {
                 gtk_list_store_insert_with_values (GTK_LIST_STORE (theme_model),
-                                                   NULL,
+                                                   &iter,
                                                    G_MAXINT,
                                                    THEME_DISPLAY_COL, _("Custom"),
                                                    THEME_IDENTIFIER_COL, CUSTOM_THEME_NAME,
                                                    THEME_PARENT_ID_COL, theme,
                                                    -1);
+                index_row (chooser->priv->theme_iters, CUSTOM_THEME_NAME, &iter);
+
                 set_combox_for_theme_name (chooser, CUSTOM_THEME_NAME);
         } else if (remove_custom) {
-                gtk_tree_model_get_iter_first (theme_model, &iter);
-                do {
-                        char *this_parent;
+                GtkTreeIter *custom_iter;
 
-                        gtk_tree_model_get (theme_model, &iter,
-                                            THEME_PARENT_ID_COL, &this_parent,
-                                            -1);
-                        if (this_parent != NULL && strcmp (this_parent, CUSTOM_THEME_NAME) != 0) {
-                                g_free (this_parent);
-                                gtk_list_store_remove (GTK_LIST_STORE (theme_model), &iter);
-                                break;
-                        }
-                        g_free (this_parent);
-                } while (gtk_tree_model_iter_next (theme_model, &iter));
+                custom_iter = g_hash_table_lookup (chooser->priv->theme_iters, CUSTOM_THEME_NAME);
+                if (custom_iter != NULL) {
+                        iter = *custom_iter;
 
-                delete_custom_theme_dir ();
+                        unindex_row (chooser->priv->theme_iters, CUSTOM_THEME_NAME, &iter);
+                        gtk_list_store_remove (GTK_LIST_STORE (theme_model), &iter);
+                }
 
                 set_combox_for_theme_name (chooser, parent);
         }
@@ -688,14 +558,61 @@ on_alert_toggled (GtkCellRendererToggle *renderer,
         g_free (id);
 }
 
+/* The theme the default alert is played from, the parent theme for the
+ * custom theme */
+static char *
+get_bell_theme (GvcSoundThemeChooser *chooser)
+{
+        GtkTreeModel *theme_model;
+        GtkTreeIter   theme_iter;
+        gchar        *theme_id = NULL;
+        gchar        *parent_id = NULL;
+
+        if (gtk_combo_box_get_active_iter (GTK_COMBO_BOX (chooser->priv->combo_box), &theme_iter) == FALSE)
+                return NULL;
+
+        theme_model = gtk_combo_box_get_model (GTK_COMBO_BOX (chooser->priv->combo_box));
+
+        gtk_tree_model_get (theme_model, &theme_iter,
+                            THEME_IDENTIFIER_COL, &theme_id,
+                            THEME_PARENT_ID_COL, &parent_id, -1);
+
+        if (theme_id != NULL && strcmp (theme_id, CUSTOM_THEME_NAME) == 0) {
+                g_free (theme_id);
+                return parent_id;
+        }
+        g_free (parent_id);
+
+        if (theme_id != NULL && strcmp (theme_id, NO_SOUNDS_THEME_NAME) == 0) {
+                g_free (theme_id);
+                return NULL;
+        }
+        return theme_id;
+}
+
+static char *
+get_preview_event_id (const char *filename)
+{
+        char *checksum;
+        char *event_id;
+
+        /* The cached samples are looked up by the event identifier, sounds
+         * from the library may share their names with the built-in ones */
+        checksum = g_compute_checksum_for_string (G_CHECKSUM_MD5, filename, -1);
+        event_id = g_strconcat (PREVIEW_EVENT_PREFIX, checksum, NULL);
+        g_free (checksum);
+
+        return event_id;
+}
+
 static void
 play_preview_for_path (GvcSoundThemeChooser *chooser, GtkTreePath *path)
 {
         GtkTreeModel *model;
         GtkTreeIter   iter;
-        GtkTreeIter   theme_iter;
+        ca_context   *context;
         gchar        *id = NULL;
-        gchar        *parent_theme = NULL;
+        gchar        *bell_theme;
 
         model = gtk_tree_view_get_model (GTK_TREE_VIEW (chooser->priv->treeview));
         if (gtk_tree_model_get_iter (model, &iter, path) == FALSE)
@@ -707,67 +624,207 @@ play_preview_for_path (GvcSoundThemeChooser *chooser, GtkTreePath *path)
         if (id == NULL)
                 return;
 
-        if (gtk_combo_box_get_active_iter (GTK_COMBO_BOX (chooser->priv->combo_box), &theme_iter)) {
-                GtkTreeModel *theme_model;
-                gchar        *theme_id = NULL;
-                gchar        *parent_id = NULL;
-
-                theme_model = gtk_combo_box_get_model (GTK_COMBO_BOX (chooser->priv->combo_box));
-
-                gtk_tree_model_get (theme_model, &theme_iter,
-                                    THEME_IDENTIFIER_COL, &theme_id,
-                                    THEME_PARENT_ID_COL, &parent_id, -1);
-                if (theme_id && strcmp (theme_id, CUSTOM_THEME_NAME) == 0)
-                        parent_theme = g_strdup (parent_id);
-
-                g_free (theme_id);
-                g_free (parent_id);
-        }
+        /* Stop the previous preview, moving through the list quickly
+         * would otherwise play all of them at once */
+        context = ca_gtk_context_get_for_screen (gtk_widget_get_screen (GTK_WIDGET (chooser)));
+        ca_context_cancel (context, PREVIEW_ID);
 
-        /* special case: for the default item on custom themes
-         * play the alert for the parent theme */
         if (strcmp (id, DEFAULT_ALERT_ID) == 0) {
-                if (parent_theme != NULL) {
-                        ca_gtk_play_for_widget (GTK_WIDGET (chooser), 0,
+                bell_theme = get_bell_theme (chooser);
+
+                if (bell_theme != NULL) {
+                        ca_gtk_play_for_widget (GTK_WIDGET (chooser), PREVIEW_ID,
                                                 CA_PROP_APPLICATION_NAME, _("Sound Preferences"),
                                                 CA_PROP_EVENT_ID, "bell-window-system",
-                                                CA_PROP_CANBERRA_XDG_THEME_NAME, parent_theme,
+                                                CA_PROP_CANBERRA_XDG_THEME_NAME, bell_theme,
                                                 CA_PROP_EVENT_DESCRIPTION, _("Testing event sound"),
-                                                CA_PROP_CANBERRA_CACHE_CONTROL, "never",
+                                                CA_PROP_CANBERRA_CACHE_CONTROL, "volatile",
                                                 CA_PROP_APPLICATION_ID, "org.mate.VolumeControl",
 #ifdef CA_PROP_CANBERRA_ENABLE
                                                 CA_PROP_CANBERRA_ENABLE, "1",
 #endif
                                                 NULL);
                 } else {
-                        ca_gtk_play_for_widget (GTK_WIDGET (chooser), 0,
+                        ca_gtk_play_for_widget (GTK_WIDGET (chooser), PREVIEW_ID,
                                                 CA_PROP_APPLICATION_NAME, _("Sound Preferences"),
                                                 CA_PROP_EVENT_ID, "bell-window-system",
                                                 CA_PROP_EVENT_DESCRIPTION, _("Testing event sound"),
-                                                CA_PROP_CANBERRA_CACHE_CONTROL, "never",
+                                                CA_PROP_CANBERRA_CACHE_CONTROL, "volatile",
                                                 CA_PROP_APPLICATION_ID, "org.mate.VolumeControl",
 #ifdef CA_PROP_CANBERRA_ENABLE
                                                 CA_PROP_CANBERRA_ENABLE, "1",
 #endif
                                                 NULL);
                 }
+                g_free (bell_theme);
         } else {
-                ca_gtk_play_for_widget (GTK_WIDGET (chooser), 0,
+                char *event_id = get_preview_event_id (id);
+
+                ca_gtk_play_for_widget (GTK_WIDGET (chooser), PREVIEW_ID,
                                         CA_PROP_APPLICATION_NAME, _("Sound Preferences"),
+                                        CA_PROP_EVENT_ID, event_id,
                                         CA_PROP_MEDIA_FILENAME, id,
                                         CA_PROP_EVENT_DESCRIPTION, _("Testing event sound"),
-                                        CA_PROP_CANBERRA_CACHE_CONTROL, "never",
+                                        CA_PROP_CANBERRA_CACHE_CONTROL, "volatile",
                                         CA_PROP_APPLICATION_ID, "org.mate.VolumeControl",
 #ifdef CA_PROP_CANBERRA_ENABLE
                                         CA_PROP_CANBERRA_ENABLE, "1",
 #endif
                                         NULL);
-
+                g_free (event_id);
         }
-        g_free (parent_theme);
         g_free (id);
 }
 
+typedef struct {
+        GPtrArray  *files;
+        char       *bell_theme;
+} PreloadData;
+
+static void
+preload_data_free (PreloadData *data)
+{
+        if (data->files != NULL)
+                g_ptr_array_free (data->files, TRUE);
+
+        g_free (data->bell_theme);
+        g_slice_free (PreloadData, data);
+}
+
+static void
+preload_thread (GTask        *task,
+                gpointer      source_object,
+                PreloadData  *data,
+                GCancellable *cancellable)
+{
+        ca_context *context;
+        guint       i;
+        int         ret;
+
+        /* Decoding and uploading the samples takes a while and holds the
+         * lock of the context, so use a private one instead of blocking the
+         * previews which play through the context of the screen */
+        ret = ca_context_create (&context);
+        if (ret != CA_SUCCESS) {
+                g_debug ("Failed to create a context for caching: %s", ca_strerror (ret));
+                g_task_return_boolean (task, FALSE);
+                return;
+        }
+
+        ca_context_change_props (context,
+                                 CA_PROP_APPLICATION_NAME, _("Sound Preferences"),
+                                 CA_PROP_APPLICATION_ID, "org.mate.VolumeControl",
+                                 NULL);
+
+        ret = ca_context_open (context);
+        if (ret != CA_SUCCESS) {
+                g_debug ("Failed to open a context for caching: %s", ca_strerror (ret));
+                ca_context_destroy (context);
+                g_task_return_boolean (task, FALSE);
+                return;
+        }
+
+        for (i = 0; data->files != NULL && i < data->files->len; i++) {
+                const char *filename = g_ptr_array_index (data->files, i);
+                char       *event_id;
+
+                if (g_cancellable_is_cancelled (cancellable))
+                        break;
+
+                event_id = get_preview_event_id (filename);
+
+                ret = ca_context_cache (context,
+                                        CA_PROP_EVENT_ID, event_id,
+                                        CA_PROP_MEDIA_FILENAME, filename,
+                                        NULL);
+                if (ret != CA_SUCCESS)
+                        g_debug ("Failed to cache %s: %s", filename, ca_strerror (ret));
+
+                g_free (event_id);
+        }
+
+        if (data->bell_theme != NULL && g_cancellable_is_cancelled (cancellable) == FALSE) {
+                ret = ca_context_cache (context,
+                                        CA_PROP_EVENT_ID, "bell-window-system",
+                                        CA_PROP_CANBERRA_XDG_THEME_NAME, data->bell_theme,
+                                        NULL);
+                if (ret != CA_SUCCESS)
+                        g_debug ("Failed to cache the bell of %s: %s",
+                                 data->bell_theme,
+                                 ca_strerror (ret));
+        }
+
+        ca_context_destroy (context);
+
+        g_task_return_boolean (task, TRUE);
+}
+
+static void
+preload_alert_sounds (GvcSoundThemeChooser *chooser)
+{
+        PreloadData  *data;
+        GTask        *task;
+        GtkTreeModel *model;
+        GtkTreeIter   iter;
+        char         *bell_theme;
+
+        if (chooser->priv->loading || gtk_widget_get_mapped (GTK_WIDGET (chooser)) == FALSE)
+                return;
+
+        bell_theme = get_bell_theme (chooser);
+
+        if (chooser->priv->files_preloaded &&
+            g_strcmp0 (bell_theme, chooser->priv->preloaded_theme) == 0) {
+                g_free (bell_theme);
+                return;
+        }
+
+        data = g_slice_new0 (PreloadData);
+
+        if (g_strcmp0 (bell_theme, chooser->priv->preloaded_theme) != 0) {
+                data->bell_theme = g_strdup (bell_theme);
+
+                g_free (chooser->priv->preloaded_theme);
+                chooser->priv->preloaded_theme = bell_theme;
+        } else
+                g_free (bell_theme);
+
+        /* The built-in alerts only need to be cached once */
+        if (chooser->priv->files_preloaded == FALSE) {
+                model = gtk_tree_view_get_model (GTK_TREE_VIEW (chooser->priv->treeview));
+
+                data->files = g_ptr_array_new_with_free_func (g_free);
+
+                if (gtk_tree_model_get_iter_first (model, &iter)) {
+                        do {
+                                char     *id;
+                                gboolean  library;
+
+                                gtk_tree_model_get (model, &iter,
+                                                    ALERT_IDENTIFIER_COL, &id,
+                                                    ALERT_LIBRARY_COL, &library,
+                                                    -1);
+
+                                /* The sound library may be huge, its files
+                                 * are only cached when previewed */
+                                if (id != NULL && library == FALSE &&
+                                    strcmp (id, DEFAULT_ALERT_ID) != 0 &&
+                                    data->files->len < PRELOAD_MAX)
+                                        g_ptr_array_add (data->files, id);
+                                else
+                                        g_free (id);
+                        } while (gtk_tree_model_iter_next (model, &iter));
+                }
+
+                chooser->priv->files_preloaded = TRUE;
+        }
+
+        task = g_task_new (chooser, chooser->priv->cancellable, NULL, NULL);
+        g_task_set_task_data (task, data, (GDestroyNotify) preload_data_free);
+        g_task_run_in_thread (task, (GTaskThreadFunc) preload_thread);
+        g_object_unref (task);
+}
+
 static void
 on_treeview_row_activated (GtkTreeView          *treeview,
                            GtkTreePath          *path,
@@ -801,16 +858,78 @@ on_treeview_selection_changed (GtkTreeSelection     *selection,
         g_list_free (paths);
 }
 
-static GtkWidget *
-create_alert_treeview (GvcSoundThemeChooser *chooser)
+static char *
+format_details (gdouble duration, guint channels, guint rate)
 {
-        GtkListStore         *store;
-        GtkWidget            *treeview;
-        GtkCellRenderer      *renderer;
-        GtkTreeViewColumn    *column;
-        GtkTreeSelection     *selection;
+        char *length;
+        char *layout;
+        char *details;
+
+        if (duration < 60.0)
+                length = g_strdup_printf (_("%.1f s"), duration);
+        else
+                length = g_strdup_printf ("%u:%02u",
+                                          (guint) duration / 60,
+                                          (guint) duration % 60);
+
+        if (channels == 1)
+                layout = g_strdup (_("Mono"));
+        else if (channels == 2)
+                layout = g_strdup (_("Stereo"));
+        else
+                layout = g_strdup_printf (ngettext ("%u channel", "%u channels", channels),
+                                          channels);
+
+        /* Translators: length, channels and sample rate of a sound,
+         * for example "1.5 s, Stereo, 44.1 kHz" */
+        details = g_strdup_printf (_("%s, %s, %g kHz"), length, layout, rate / 1000.0);
+
+        g_free (length);
+        g_free (layout);
+
+        return details;
+}
 
-        treeview = gtk_tree_view_new ();
+static void
+set_column_width_for_texts (GtkTreeViewColumn *column,
+                            GtkCellRenderer   *renderer,
+                            GtkWidget         *treeview,
+                            const char       **texts)
+{
+        PangoLayout *layout;
+        gint         width;
+        gint         max_width = 0;
+        gint         xpad;
+        guint        i;
+
+        for (i = 0; texts[i] != NULL; i++) {
+                layout = gtk_widget_create_pango_layout (treeview, texts[i]);
+                pango_layout_get_pixel_size (layout, &width, NULL);
+                g_object_unref (layout);
+
+                max_width = MAX (max_width, width);
+        }
+
+        gtk_cell_renderer_get_padding (renderer, &xpad, NULL);
+
+        gtk_tree_view_column_set_sizing (column, GTK_TREE_VIEW_COLUMN_FIXED);
+        gtk_tree_view_column_set_fixed_width (column, max_width + 2 * xpad + 12);
+}
+
+static GtkWidget *
+create_alert_treeview (GvcSoundThemeChooser *chooser)
+{
+        GtkListStore         *store;
+        GtkWidget            *treeview;
+        GtkCellRenderer      *renderer;
+        GtkTreeViewColumn    *column;
+        GtkTreeSelection     *selection;
+        GtkTreeIter           iter;
+        const char           *types[4];
+        char                 *details[4];
+        gint                  width;
+
+        treeview = gtk_tree_view_new ();
 
         gtk_tree_view_set_headers_visible (GTK_TREE_VIEW (treeview), FALSE);
         g_signal_connect (G_OBJECT (treeview),
@@ -826,30 +945,36 @@ create_alert_treeview (GvcSoundThemeChooser *chooser)
                           G_CALLBACK (on_treeview_selection_changed),
                           chooser);
 
-        /* Setup the tree model, 3 columns:
+        /* Setup the tree model, 6 columns:
          * - display name
          * - sound id
          * - sound type
+         * - active
+         * - length and format of library sounds
+         * - whether the sound is from the library
          */
         store = gtk_list_store_new (ALERT_NUM_COLS,
                                     G_TYPE_STRING,
                                     G_TYPE_STRING,
                                     G_TYPE_STRING,
+                                    G_TYPE_BOOLEAN,
+                                    G_TYPE_STRING,
                                     G_TYPE_BOOLEAN);
 
         gtk_list_store_insert_with_values (store,
-                                           NULL,
+                                           &iter,
                                            G_MAXINT,
                                            ALERT_IDENTIFIER_COL, DEFAULT_ALERT_ID,
                                            ALERT_DISPLAY_COL, _("Default"),
                                            ALERT_SOUND_TYPE_COL, _("From theme"),
                                            ALERT_ACTIVE_COL, TRUE,
                                            -1);
-
-        populate_model_from_dir (chooser, GTK_TREE_MODEL (store), SOUND_SET_DIR);
+        index_row (chooser->priv->alert_iters, DEFAULT_ALERT_ID, &iter);
+        chooser->priv->active_alert = g_strdup (DEFAULT_ALERT_ID);
 
         gtk_tree_view_set_model (GTK_TREE_VIEW (treeview),
                                  GTK_TREE_MODEL (store));
+        g_object_unref (store);
 
         renderer = gtk_cell_renderer_toggle_new ();
         gtk_cell_renderer_toggle_set_radio (GTK_CELL_RENDERER_TOGGLE (renderer), TRUE);
@@ -858,6 +983,9 @@ create_alert_treeview (GvcSoundThemeChooser *chooser)
                                                            renderer,
                                                            "active", ALERT_ACTIVE_COL,
                                                            NULL);
+        gtk_cell_renderer_get_preferred_width (renderer, treeview, NULL, &width);
+        gtk_tree_view_column_set_sizing (column, GTK_TREE_VIEW_COLUMN_FIXED);
+        gtk_tree_view_column_set_fixed_width (column, width);
         gtk_tree_view_append_column (GTK_TREE_VIEW (treeview), column);
         g_signal_connect (renderer,
                           "toggled",
@@ -865,10 +993,13 @@ create_alert_treeview (GvcSoundThemeChooser *chooser)
                           chooser);
 
         renderer = gtk_cell_renderer_text_new ();
+        g_object_set (G_OBJECT (renderer), "ellipsize", PANGO_ELLIPSIZE_END, NULL);
         column = gtk_tree_view_column_new_with_attributes (_("Name"),
                                                            renderer,
                                                            "text", ALERT_DISPLAY_COL,
                                                            NULL);
+        gtk_tree_view_column_set_sizing (column, GTK_TREE_VIEW_COLUMN_FIXED);
+        gtk_tree_view_column_set_expand (column, TRUE);
         gtk_tree_view_append_column (GTK_TREE_VIEW (treeview), column);
 
         renderer = gtk_cell_renderer_text_new ();
@@ -876,9 +1007,34 @@ create_alert_treeview (GvcSoundThemeChooser *chooser)
                                                            renderer,
                                                            "text", ALERT_SOUND_TYPE_COL,
                                                            NULL);
+        types[0] = _("From theme");
+        types[1] = _("Built-in");
+        types[2] = _("Library");
+        types[3] = NULL;
+        set_column_width_for_texts (column, renderer, treeview, types);
+
+        gtk_tree_view_append_column (GTK_TREE_VIEW (treeview), column);
+
+        renderer = gtk_cell_renderer_text_new ();
+        column = gtk_tree_view_column_new_with_attributes (_("Details"),
+                                                           renderer,
+                                                           "text", ALERT_DETAILS_COL,
+                                                           NULL);
+        details[0] = format_details (3599.0, 1, 44100);
+        details[1] = format_details (3599.0, 2, 22050);
+        details[2] = format_details (3599.0, 6, 48000);
+        details[3] = NULL;
+        set_column_width_for_texts (column, renderer, treeview, (const char **) details);
+        g_free (details[0]);
+        g_free (details[1]);
+        g_free (details[2]);
 
         gtk_tree_view_append_column (GTK_TREE_VIEW (treeview), column);
 
+        /* Only the visible rows are measured, so that a library with
+         * thousands of sounds stays quick */
+        gtk_tree_view_set_fixed_height_mode (GTK_TREE_VIEW (treeview), TRUE);
+
         return treeview;
 }
 
@@ -886,32 +1042,27 @@ static int
 get_file_type (const char *sound_name,
                char      **linked_name)
 {
-        char *name, *filename;
+        char *name;
 
         *linked_name = NULL;
 
         name = g_strdup_printf ("%s.disabled", sound_name);
-        filename = custom_theme_dir_path (name);
-        g_free (name);
 
-        if (g_file_test (filename, G_FILE_TEST_IS_REGULAR) != FALSE) {
-                g_free (filename);
+        if (custom_theme_dir_has_file (name) != FALSE) {
+                g_free (name);
                 return SOUND_TYPE_OFF;
         }
-        g_free (filename);
+        g_free (name);
 
         /* We only check for .ogg files because those are the
          * only ones we create */
         name = g_strdup_printf ("%s.ogg", sound_name);
-        filename = custom_theme_dir_path (name);
+
+        *linked_name = custom_theme_dir_read_link (name);
         g_free (name);
 
-        if (g_file_test (filename, G_FILE_TEST_IS_SYMLINK) != FALSE) {
-                *linked_name = g_file_read_link (filename, NULL);
-                g_free (filename);
+        if (*linked_name != NULL)
                 return SOUND_TYPE_CUSTOM;
-        }
-        g_free (filename);
 
         return SOUND_TYPE_BUILTIN;
 }
@@ -943,6 +1094,10 @@ update_theme (GvcSoundThemeChooser *chooser)
         gboolean     events_enabled;
         gboolean     feedback_enabled;
 
+        /* Everything is updated once the themes are loaded */
+        if (chooser->priv->loading)
+                return;
+
         feedback_enabled = g_settings_get_boolean (chooser->priv->sound_settings, INPUT_SOUNDS_KEY);
         set_input_feedback_enabled (chooser, feedback_enabled);
 
@@ -961,14 +1116,697 @@ update_theme (GvcSoundThemeChooser *chooser)
         update_alerts_from_theme_name (chooser, theme_name);
 
         g_free (theme_name);
+
+        preload_alert_sounds (chooser);
+}
+
+static void
+chooser_data_free (ChooserData *data)
+{
+        if (data->themes != NULL)
+                g_hash_table_destroy (data->themes);
+        if (data->alerts != NULL)
+                g_ptr_array_free (data->alerts, TRUE);
+
+        g_slice_free (ChooserData, data);
+}
+
+static void
+load_chooser_data_thread (GTask        *task,
+                          gpointer      source_object,
+                          gpointer      task_data,
+                          GCancellable *cancellable)
+{
+        ChooserData *data;
+
+        data = g_slice_new0 (ChooserData);
+
+        data->themes = sound_theme_index_load ();
+
+        if (g_cancellable_is_cancelled (cancellable) == FALSE) {
+                data->alerts = g_ptr_array_new_with_free_func ((GDestroyNotify) alert_info_free);
+
+                load_alerts_from_dir (data->alerts, SOUND_SET_DIR);
+        }
+
+        if (g_task_return_error_if_cancelled (task) == TRUE) {
+                chooser_data_free (data);
+                return;
+        }
+
+        g_task_return_pointer (task, data, (GDestroyNotify) chooser_data_free);
+}
+
+static void
+fill_alert_model (GvcSoundThemeChooser *chooser, GPtrArray *alerts)
+{
+        GtkTreeModel *model;
+        GtkTreeIter   iter;
+        guint         i;
+
+        model = gtk_tree_view_get_model (GTK_TREE_VIEW (chooser->priv->treeview));
+
+        /* Detach the model so the tree view does not follow every insert */
+        g_object_ref (model);
+        gtk_tree_view_set_model (GTK_TREE_VIEW (chooser->priv->treeview), NULL);
+
+        for (i = 0; i < alerts->len; i++) {
+                AlertInfo *info = g_ptr_array_index (alerts, i);
+
+                gtk_list_store_insert_with_values (GTK_LIST_STORE (model),
+                                                   &iter,
+                                                   G_MAXINT,
+                                                   ALERT_IDENTIFIER_COL, info->id,
+                                                   ALERT_DISPLAY_COL, info->name,
+                                                   ALERT_SOUND_TYPE_COL, _("Built-in"),
+                                                   ALERT_ACTIVE_COL, FALSE,
+                                                   -1);
+                index_row (chooser->priv->alert_iters, info->id, &iter);
+        }
+
+        gtk_tree_view_set_model (GTK_TREE_VIEW (chooser->priv->treeview), model);
+        g_object_unref (model);
+}
+
+static void
+fill_library_model (GvcSoundThemeChooser *chooser, GPtrArray *entries)
+{
+        GtkTreeModel *model;
+        GtkTreeIter   iter;
+        gboolean      valid;
+        guint         i;
+
+        model = gtk_tree_view_get_model (GTK_TREE_VIEW (chooser->priv->treeview));
+
+        g_object_ref (model);
+        gtk_tree_view_set_model (GTK_TREE_VIEW (chooser->priv->treeview), NULL);
+
+        /* The library rows always come last */
+        valid = gtk_tree_model_get_iter_first (model, &iter);
+        while (valid) {
+                gboolean  library;
+                char     *id;
+
+                gtk_tree_model_get (model, &iter,
+                                    ALERT_LIBRARY_COL, &library,
+                                    ALERT_IDENTIFIER_COL, &id,
+                                    -1);
+                if (library) {
+                        unindex_row (chooser->priv->alert_iters, id, &iter);
+                        valid = gtk_list_store_remove (GTK_LIST_STORE (model), &iter);
+                } else
+                        valid = gtk_tree_model_iter_next (model, &iter);
+
+                g_free (id);
+        }
+
+        for (i = 0; entries != NULL && i < entries->len; i++) {
+                SoundLibraryEntry *entry = g_ptr_array_index (entries, i);
+                char              *details;
+
+                details = format_details (entry->duration, entry->channels, entry->rate);
+
+                gtk_list_store_insert_with_values (GTK_LIST_STORE (model),
+                                                   &iter,
+                                                   G_MAXINT,
+                                                   ALERT_IDENTIFIER_COL, entry->path,
+                                                   ALERT_DISPLAY_COL, entry->name,
+                                                   ALERT_SOUND_TYPE_COL, _("Library"),
+                                                   ALERT_ACTIVE_COL, FALSE,
+                                                   ALERT_DETAILS_COL, details,
+                                                   ALERT_LIBRARY_COL, TRUE,
+                                                   -1);
+                index_row (chooser->priv->alert_iters, entry->path, &iter);
+                g_free (details);
+        }
+
+        gtk_tree_view_set_model (GTK_TREE_VIEW (chooser->priv->treeview), model);
+        g_object_unref (model);
+
+        reset_alert_model (chooser);
+}
+
+static void
+load_library_thread (GTask        *task,
+                     gpointer      source_object,
+                     gpointer      task_data,
+                     GCancellable *cancellable)
+{
+        GPtrArray *entries;
+
+        entries = sound_library_load (task_data, cancellable);
+
+        if (g_task_return_error_if_cancelled (task) == FALSE)
+                g_task_return_pointer (task, entries, (GDestroyNotify) g_ptr_array_unref);
+        else
+                g_ptr_array_unref (entries);
+}
+
+static void
+on_library_loaded (GObject      *source_object,
+                   GAsyncResult *result,
+                   gpointer      user_data)
+{
+        GvcSoundThemeChooser *chooser;
+        GPtrArray            *entries;
+        GError               *error = NULL;
+
+        entries = g_task_propagate_pointer (G_TASK (result), &error);
+        if (entries == NULL) {
+                /* Replaced by another folder, or the chooser is gone */
+                g_error_free (error);
+                return;
+        }
+
+        chooser = GVC_SOUND_THEME_CHOOSER (source_object);
+
+        fill_library_model (chooser, entries);
+        g_ptr_array_unref (entries);
+}
+
+static void
+load_library (GvcSoundThemeChooser *chooser)
+{
+        GTask *task;
+        char  *folder;
+
+        if (chooser->priv->library_cancellable != NULL) {
+                g_cancellable_cancel (chooser->priv->library_cancellable);
+                g_clear_object (&chooser->priv->library_cancellable);
+        }
+
+        folder = sound_library_get_folder ();
+
+        gtk_widget_set_sensitive (chooser->priv->library_clear_button, folder != NULL);
+
+        if (folder == NULL) {
+                gtk_file_chooser_unselect_all (GTK_FILE_CHOOSER (chooser->priv->library_button));
+                fill_library_model (chooser, NULL);
+                return;
+        }
+
+        gtk_file_chooser_set_filename (GTK_FILE_CHOOSER (chooser->priv->library_button), folder);
+
+        chooser->priv->library_cancellable = g_cancellable_new ();
+
+        task = g_task_new (chooser,
+                           chooser->priv->library_cancellable,
+                           on_library_loaded,
+                           NULL);
+        g_task_set_task_data (task, folder, g_free);
+        g_task_run_in_thread (task, load_library_thread);
+        g_object_unref (task);
+}
+
+static void
+on_library_folder_set (GtkFileChooserButton *button,
+                       GvcSoundThemeChooser *chooser)
+{
+        char *folder;
+
+        folder = gtk_file_chooser_get_filename (GTK_FILE_CHOOSER (button));
+        if (folder == NULL)
+                return;
+
+        sound_library_set_folder (folder);
+        g_free (folder);
+
+        load_library (chooser);
+}
+
+static void
+on_library_clear_clicked (GtkButton            *button,
+                          GvcSoundThemeChooser *chooser)
+{
+        sound_library_set_folder (NULL);
+
+        load_library (chooser);
+}
+
+static void
+on_chooser_data_loaded (GObject      *source_object,
+                        GAsyncResult *result,
+                        gpointer      user_data)
+{
+        GvcSoundThemeChooser *chooser;
+        ChooserData          *data;
+        GError               *error = NULL;
+
+        data = g_task_propagate_pointer (G_TASK (result), &error);
+        if (data == NULL) {
+                /* The chooser has been destroyed */
+                g_error_free (error);
+                return;
+        }
+
+        chooser = GVC_SOUND_THEME_CHOOSER (source_object);
+
+        chooser->priv->loading = FALSE;
+
+        gtk_spinner_stop (GTK_SPINNER (chooser->priv->spinner));
+        gtk_widget_hide (chooser->priv->spinner);
+
+        fill_alert_model (chooser, data->alerts);
+
+        if (fill_theme_selector (chooser, data->themes) == TRUE) {
+                gtk_widget_set_sensitive (chooser->priv->theme_box, TRUE);
+
+                update_theme (chooser);
+        }
+
+        chooser_data_free (data);
+
+        setup_monitors (chooser);
+
+        load_library (chooser);
+}
+
+static void
+load_chooser_data (GvcSoundThemeChooser *chooser)
+{
+        GTask *task;
+
+        chooser->priv->loading = TRUE;
+
+        /* Keep the widgets inactive until there is something to show */
+        gtk_widget_set_sensitive (chooser->priv->theme_box, FALSE);
+        gtk_widget_set_sensitive (chooser->priv->selection_box, FALSE);
+        gtk_widget_set_sensitive (chooser->priv->click_feedback_button, FALSE);
+
+        gtk_widget_show (chooser->priv->spinner);
+        gtk_spinner_start (GTK_SPINNER (chooser->priv->spinner));
+
+        chooser->priv->cancellable = g_cancellable_new ();
+
+        task = g_task_new (chooser,
+                           chooser->priv->cancellable,
+                           on_chooser_data_loaded,
+                           NULL);
+
+        g_task_run_in_thread (task, load_chooser_data_thread);
+        g_object_unref (task);
+}
+
+static void schedule_rescan (GvcSoundThemeChooser *chooser);
+
+static void
+load_themes_thread (GTask        *task,
+                    gpointer      source_object,
+                    gpointer      task_data,
+                    GCancellable *cancellable)
+{
+        g_task_return_pointer (task,
+                               sound_theme_index_load (),
+                               (GDestroyNotify) g_hash_table_destroy);
+}
+
+static void
+apply_theme_changes (GvcSoundThemeChooser *chooser, GHashTable *hash)
+{
+        GtkTreeModel   *model;
+        GtkTreeIter     iter;
+        GHashTableIter  hash_iter;
+        gpointer        key;
+        gpointer        value;
+        gboolean        valid;
+        gboolean        active_removed = FALSE;
+        GHashTable     *added;
+        char           *active = NULL;
+
+        model = gtk_combo_box_get_model (GTK_COMBO_BOX (chooser->priv->combo_box));
+        if (model == NULL)
+                return;
+
+        if (gtk_combo_box_get_active_iter (GTK_COMBO_BOX (chooser->priv->combo_box), &iter))
+                gtk_tree_model_get (model, &iter, THEME_IDENTIFIER_COL, &active, -1);
+
+        /* Themes which are not in the model yet */
+        added = g_hash_table_new (g_str_hash, g_str_equal);
+
+        g_hash_table_iter_init (&hash_iter, hash);
+        while (g_hash_table_iter_next (&hash_iter, &key, &value))
+                g_hash_table_insert (added, key, value);
+
+        valid = gtk_tree_model_get_iter_first (model, &iter);
+        while (valid) {
+                SoundThemeInfo *info;
+                char           *id;
+                char           *name;
+
+                gtk_tree_model_get (model, &iter,
+                                    THEME_IDENTIFIER_COL, &id,
+                                    THEME_DISPLAY_COL, &name,
+                                    -1);
+
+                if (strcmp (id, NO_SOUNDS_THEME_NAME) == 0) {
+                        valid = gtk_tree_model_iter_next (model, &iter);
+                        g_free (id);
+                        g_free (name);
+                        continue;
+                }
+
+                info = g_hash_table_lookup (hash, id);
+                if (info == NULL) {
+                        g_debug ("Sound theme %s has been removed", id);
+
+                        if (g_strcmp0 (id, active) == 0)
+                                active_removed = TRUE;
+
+                        unindex_row (chooser->priv->theme_iters, id, &iter);
+                        valid = gtk_list_store_remove (GTK_LIST_STORE (model), &iter);
+                } else {
+                        if (g_strcmp0 (name, info->name) != 0)
+                                gtk_list_store_set (GTK_LIST_STORE (model), &iter,
+                                                    THEME_DISPLAY_COL, info->name,
+                                                    -1);
+
+                        /* The parent of the custom theme is changed in place */
+                        if (strcmp (id, CUSTOM_THEME_NAME) == 0) {
+                                char *path;
+                                char *parent = NULL;
+
+                                path = custom_theme_dir_path ("index.theme");
+                                g_free (sound_theme_index_load_name (path, &parent));
+                                g_free (path);
+
+                                gtk_list_store_set (GTK_LIST_STORE (model), &iter,
+                                                    THEME_PARENT_ID_COL, parent,
+                                                    -1);
+                                g_free (parent);
+                        }
+
+                        g_hash_table_remove (added, id);
+                        valid = gtk_tree_model_iter_next (model, &iter);
+                }
+                g_free (id);
+                g_free (name);
+        }
+
+        if (g_hash_table_size (added) > 0) {
+                g_debug ("%u sound themes have been added", g_hash_table_size (added));
+
+                g_hash_table_foreach (added, (GHFunc) add_theme_to_store, chooser);
+        }
+        g_hash_table_destroy (added);
+        g_free (active);
+
+        /* Select the configured theme again, or the fallback */
+        if (active_removed)
+                update_theme (chooser);
+}
+
+static void
+on_themes_rescanned (GObject      *source_object,
+                     GAsyncResult *result,
+                     gpointer      user_data)
+{
+        GvcSoundThemeChooser *chooser;
+        GHashTable           *hash;
+        GError               *error = NULL;
+
+        hash = g_task_propagate_pointer (G_TASK (result), &error);
+        if (hash == NULL) {
+                g_error_free (error);
+                return;
+        }
+
+        chooser = GVC_SOUND_THEME_CHOOSER (source_object);
+
+        chooser->priv->rescanning = FALSE;
+
+        apply_theme_changes (chooser, hash);
+        g_hash_table_destroy (hash);
+
+        /* Something has changed while scanning */
+        if (chooser->priv->rescan_again) {
+                chooser->priv->rescan_again = FALSE;
+                schedule_rescan (chooser);
+        }
+}
+
+static gboolean
+on_rescan_timeout (GvcSoundThemeChooser *chooser)
+{
+        GTask *task;
+
+        chooser->priv->rescan_id = 0;
+
+        if (chooser->priv->rescanning) {
+                chooser->priv->rescan_again = TRUE;
+                return G_SOURCE_REMOVE;
+        }
+
+        chooser->priv->rescanning = TRUE;
+
+        task = g_task_new (chooser,
+                           chooser->priv->cancellable,
+                           on_themes_rescanned,
+                           NULL);
+
+        g_task_run_in_thread (task, load_themes_thread);
+        g_object_unref (task);
+
+        return G_SOURCE_REMOVE;
+}
+
+static void
+schedule_rescan (GvcSoundThemeChooser *chooser)
+{
+        /* Wait until the changes stop coming, installing a theme creates
+         * many files in a short time */
+        if (chooser->priv->rescan_id != 0)
+                g_source_remove (chooser->priv->rescan_id);
+
+        chooser->priv->rescan_id = g_timeout_add (RESCAN_DELAY,
+                                                  (GSourceFunc) on_rescan_timeout,
+                                                  chooser);
+}
+
+/* Marks the alert of the current theme without writing it back, which
+ * would change the custom theme directory again */
+static void
+reset_alert_model (GvcSoundThemeChooser *chooser)
+{
+        GtkTreeModel *model;
+        GtkTreeIter   iter;
+        char         *theme;
+
+        if (gtk_combo_box_get_active_iter (GTK_COMBO_BOX (chooser->priv->combo_box), &iter) == FALSE)
+                return;
+
+        model = gtk_combo_box_get_model (GTK_COMBO_BOX (chooser->priv->combo_box));
+        gtk_tree_model_get (model, &iter, THEME_IDENTIFIER_COL, &theme, -1);
+
+        if (strcmp (theme, CUSTOM_THEME_NAME) == 0) {
+                char *linkname = NULL;
+
+                if (get_file_type ("bell-terminal", &linkname) == SOUND_TYPE_CUSTOM && linkname != NULL)
+                        update_alert_model (chooser, linkname);
+                else
+                        update_alert_model (chooser, DEFAULT_ALERT_ID);
+
+                g_free (linkname);
+        } else {
+                update_alert_model (chooser, DEFAULT_ALERT_ID);
+        }
+
+        g_free (theme);
+}
+
+static gboolean
+on_refresh_timeout (GvcSoundThemeChooser *chooser)
+{
+        chooser->priv->refresh_id = 0;
+
+        reset_alert_model (chooser);
+        return G_SOURCE_REMOVE;
+}
+
+static void add_directory_monitor (GvcSoundThemeChooser *chooser, GFile *dir);
+
+static gboolean
+is_sounds_dir (GFile *dir)
+{
+        char     *basename;
+        gboolean  result;
+
+        basename = g_file_get_basename (dir);
+        result = g_strcmp0 (basename, "sounds") == 0;
+        g_free (basename);
+
+        return result;
+}
+
+static void
+on_sounds_dir_changed (GFileMonitor         *monitor,
+                       GFile                *file,
+                       GFile                *other_file,
+                       GFileMonitorEvent     event_type,
+                       GvcSoundThemeChooser *chooser)
+{
+        GFile *parent;
+        char  *parent_path;
+        char  *custom_path;
+        char  *basename;
+
+        if (event_type == G_FILE_MONITOR_EVENT_ATTRIBUTE_CHANGED ||
+            event_type == G_FILE_MONITOR_EVENT_PRE_UNMOUNT ||
+            event_type == G_FILE_MONITOR_EVENT_UNMOUNTED)
+                return;
+
+        parent = g_file_get_parent (file);
+        if (G_UNLIKELY (parent == NULL))
+                return;
+
+        parent_path = g_file_get_path (parent);
+        custom_path = custom_theme_dir_path (NULL);
+        basename    = g_file_get_basename (file);
+
+        /* Work directories of the custom theme while it is saved */
+        if (basename != NULL && basename[0] == '.' && is_sounds_dir (parent) == TRUE)
+                goto out;
+
+        /* The custom theme directory or one of its files has changed,
+         * possibly by someone else */
+        if (g_strcmp0 (parent_path, custom_path) == 0 ||
+            (g_strcmp0 (basename, CUSTOM_THEME_NAME) == 0 && is_sounds_dir (parent) == TRUE))
+                custom_theme_dir_invalidate ();
+
+        if (g_strcmp0 (parent_path, custom_path) == 0 &&
+            g_strcmp0 (basename, "index.theme") != 0) {
+                /* The alert of the custom theme has changed */
+                if (chooser->priv->refresh_id != 0)
+                        g_source_remove (chooser->priv->refresh_id);
+
+                chooser->priv->refresh_id = g_timeout_add (RESCAN_DELAY,
+                                                           (GSourceFunc) on_refresh_timeout,
+                                                           chooser);
+        } else {
+                char *path = g_file_get_path (file);
+
+                /* Follow a new theme directory as well, its index.theme
+                 * usually appears a while after the directory itself */
+                if (event_type == G_FILE_MONITOR_EVENT_CREATED &&
+                    is_sounds_dir (parent) == TRUE &&
+                    g_file_test (path, G_FILE_TEST_IS_DIR) == TRUE) {
+                        /* The custom theme is replaced as a whole when it
+                         * is saved, the old monitor follows the old one */
+                        if (g_strcmp0 (path, custom_path) == 0)
+                                g_hash_table_remove (chooser->priv->monitors, path);
+
+                        add_directory_monitor (chooser, file);
+                } else if (event_type == G_FILE_MONITOR_EVENT_DELETED &&
+                         g_strcmp0 (path, custom_path) != 0)
+                        g_hash_table_remove (chooser->priv->monitors, path);
+
+                g_free (path);
+
+                schedule_rescan (chooser);
+        }
+
+out:
+        g_free (basename);
+        g_free (custom_path);
+        g_free (parent_path);
+        g_object_unref (parent);
+}
+
+static void
+free_monitor (GFileMonitor *monitor)
+{
+        g_signal_handlers_disconnect_matched (G_OBJECT (monitor),
+                                              G_SIGNAL_MATCH_FUNC,
+                                              0, 0, NULL,
+                                              on_sounds_dir_changed,
+                                              NULL);
+        g_file_monitor_cancel (monitor);
+        g_object_unref (monitor);
+}
+
+static void
+add_directory_monitor (GvcSoundThemeChooser *chooser, GFile *dir)
+{
+        GFileMonitor *monitor;
+        GError       *error = NULL;
+        char         *path;
+
+        path = g_file_get_path (dir);
+
+        if (g_hash_table_contains (chooser->priv->monitors, path) == TRUE) {
+                g_free (path);
+                return;
+        }
+
+        monitor = g_file_monitor_directory (dir, G_FILE_MONITOR_NONE, NULL, &error);
+        if (monitor == NULL) {
+                g_debug ("Failed to monitor %s: %s", path, error->message);
+                g_error_free (error);
+                g_free (path);
+                return;
+        }
+
+        g_signal_connect (G_OBJECT (monitor),
+                          "changed",
+                          G_CALLBACK (on_sounds_dir_changed),
+                          chooser);
+
+        g_hash_table_insert (chooser->priv->monitors, path, monitor);
+}
+
+static void
+add_directory_monitor_for_path (GvcSoundThemeChooser *chooser, const char *path)
+{
+        GFile *dir;
+
+        dir = g_file_new_for_path (path);
+        add_directory_monitor (chooser, dir);
+        g_object_unref (dir);
+}
+
+static void
+setup_monitors (GvcSoundThemeChooser *chooser)
+{
+        const char * const *data_dirs;
+        char               *dir;
+        guint               i;
+
+        data_dirs = g_get_system_data_dirs ();
+        for (i = 0; data_dirs[i] != NULL; i++) {
+                dir = g_build_filename (data_dirs[i], "sounds", NULL);
+                add_directory_monitor_for_path (chooser, dir);
+                g_free (dir);
+        }
+
+        dir = g_build_filename (g_get_user_data_dir (), "sounds", NULL);
+        add_directory_monitor_for_path (chooser, dir);
+        g_free (dir);
+
+        /* Changes made to the custom theme by other programs */
+        dir = custom_theme_dir_path (NULL);
+        add_directory_monitor_for_path (chooser, dir);
+        g_free (dir);
+}
+
+static void
+gvc_sound_theme_chooser_map (GtkWidget *widget)
+{
+        GTK_WIDGET_CLASS (gvc_sound_theme_chooser_parent_class)->map (widget);
+
+        /* Have the sounds ready by the time the user starts browsing */
+        preload_alert_sounds (GVC_SOUND_THEME_CHOOSER (widget));
 }
 
 static void
 gvc_sound_theme_chooser_class_init (GvcSoundThemeChooserClass *klass)
 {
-        GObjectClass *object_class = G_OBJECT_CLASS (klass);
+        GObjectClass   *object_class = G_OBJECT_CLASS (klass);
+        GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
 
         object_class->dispose = gvc_sound_theme_chooser_dispose;
+        widget_class->map = gvc_sound_theme_chooser_map;
+
+        /* The alert definitions are parsed in a thread */
+        xmlInitParser ();
 
         g_type_class_add_private (klass, sizeof (GvcSoundThemeChooserPrivate));
 }
@@ -1018,10 +1856,26 @@ gvc_sound_theme_chooser_init (GvcSoundThemeChooser *chooser)
         GtkWidget   *box;
         GtkWidget   *label;
         GtkWidget   *scrolled_window;
+        GtkWidget   *selection_box;
+        GtkWidget   *library_box;
         gchar       *str;
 
         chooser->priv = GVC_SOUND_THEME_CHOOSER_GET_PRIVATE (chooser);
 
+        chooser->priv->monitors = g_hash_table_new_full (g_str_hash,
+                                                         g_str_equal,
+                                                         g_free,
+                                                         (GDestroyNotify) free_monitor);
+
+        chooser->priv->alert_iters = g_hash_table_new_full (g_str_hash,
+                                                            g_str_equal,
+                                                            g_free,
+                                                            (GDestroyNotify) gtk_tree_iter_free);
+        chooser->priv->theme_iters = g_hash_table_new_full (g_str_hash,
+                                                            g_str_equal,
+                                                            g_free,
+                                                            (GDestroyNotify) gtk_tree_iter_free);
+
         chooser->priv->theme_box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);
 
         gtk_box_pack_start (GTK_BOX (chooser),
@@ -1033,6 +1887,10 @@ gvc_sound_theme_chooser_init (GvcSoundThemeChooser *chooser)
         gtk_box_pack_start (GTK_BOX (chooser->priv->theme_box), chooser->priv->combo_box, FALSE, FALSE, 6);
         gtk_label_set_mnemonic_widget (GTK_LABEL (label), chooser->priv->combo_box);
 
+        chooser->priv->spinner = gtk_spinner_new ();
+        gtk_widget_set_no_show_all (chooser->priv->spinner, TRUE);
+        gtk_box_pack_start (GTK_BOX (chooser->priv->theme_box), chooser->priv->spinner, FALSE, FALSE, 0);
+
         chooser->priv->sound_settings = g_settings_new (KEY_SOUNDS_SCHEMA);
 
         g_signal_connect (G_OBJECT (chooser->priv->sound_settings),
@@ -1066,7 +1924,40 @@ gvc_sound_theme_chooser_init (GvcSoundThemeChooser *chooser)
                                              GTK_SHADOW_IN);
 
         gtk_container_add (GTK_CONTAINER (scrolled_window), chooser->priv->treeview);
-        gtk_container_add (GTK_CONTAINER (box), scrolled_window);
+
+        selection_box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 6);
+        gtk_box_pack_start (GTK_BOX (selection_box), scrolled_window, TRUE, TRUE, 0);
+        gtk_container_add (GTK_CONTAINER (box), selection_box);
+
+        /* A folder of the user's own sounds to choose from */
+        library_box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 6);
+        gtk_box_pack_start (GTK_BOX (selection_box), library_box, FALSE, FALSE, 0);
+
+        label = gtk_label_new_with_mnemonic (_("Sound _library:"));
+        gtk_box_pack_start (GTK_BOX (library_box), label, FALSE, FALSE, 0);
+
+        chooser->priv->library_button =
+                gtk_file_chooser_button_new (_("Select a Folder of Sounds"),
+                                             GTK_FILE_CHOOSER_ACTION_SELECT_FOLDER);
+        gtk_label_set_mnemonic_widget (GTK_LABEL (label), chooser->priv->library_button);
+        gtk_box_pack_start (GTK_BOX (library_box), chooser->priv->library_button, TRUE, TRUE, 0);
+
+        g_signal_connect (G_OBJECT (chooser->priv->library_button),
+                          "file-set",
+                          G_CALLBACK (on_library_folder_set),
+                          chooser);
+
+        chooser->priv->library_clear_button =
+                gtk_button_new_from_icon_name ("edit-clear", GTK_ICON_SIZE_BUTTON);
+        gtk_widget_set_tooltip_text (chooser->priv->library_clear_button,
+                                     _("Do not use a sound library"));
+        gtk_widget_set_sensitive (chooser->priv->library_clear_button, FALSE);
+        gtk_box_pack_start (GTK_BOX (library_box), chooser->priv->library_clear_button, FALSE, FALSE, 0);
+
+        g_signal_connect (G_OBJECT (chooser->priv->library_clear_button),
+                          "clicked",
+                          G_CALLBACK (on_library_clear_clicked),
+                          chooser);
 
         chooser->priv->click_feedback_button = gtk_check_button_new_with_mnemonic (_("Enable _window and button sounds"));
         gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (chooser->priv->click_feedback_button),
@@ -1082,7 +1973,7 @@ gvc_sound_theme_chooser_init (GvcSoundThemeChooser *chooser)
                           chooser);
 
         setup_theme_selector (chooser);
-        update_theme (chooser);
+        load_chooser_data (chooser);
 
         setup_list_size_constraint (scrolled_window, chooser->priv->treeview);
 }
@@ -1094,8 +1985,46 @@ gvc_sound_theme_chooser_dispose (GObject *object)
 
         chooser = GVC_SOUND_THEME_CHOOSER (object);
 
+        if (chooser->priv->cancellable != NULL) {
+                g_cancellable_cancel (chooser->priv->cancellable);
+                g_clear_object (&chooser->priv->cancellable);
+        }
+
+        if (chooser->priv->library_cancellable != NULL) {
+                g_cancellable_cancel (chooser->priv->library_cancellable);
+                g_clear_object (&chooser->priv->library_cancellable);
+        }
+
+        if (chooser->priv->monitors != NULL) {
+                g_hash_table_destroy (chooser->priv->monitors);
+                chooser->priv->monitors = NULL;
+        }
+        if (chooser->priv->rescan_id != 0) {
+                g_source_remove (chooser->priv->rescan_id);
+                chooser->priv->rescan_id = 0;
+        }
+        if (chooser->priv->refresh_id != 0) {
+                g_source_remove (chooser->priv->refresh_id);
+                chooser->priv->refresh_id = 0;
+        }
+
         g_clear_object (&chooser->priv->sound_settings);
 
+        g_free (chooser->priv->preloaded_theme);
+        chooser->priv->preloaded_theme = NULL;
+
+        if (chooser->priv->alert_iters != NULL) {
+                g_hash_table_destroy (chooser->priv->alert_iters);
+                chooser->priv->alert_iters = NULL;
+        }
+        if (chooser->priv->theme_iters != NULL) {
+                g_hash_table_destroy (chooser->priv->theme_iters);
+                chooser->priv->theme_iters = NULL;
+        }
+
+        g_free (chooser->priv->active_alert);
+        chooser->priv->active_alert = NULL;
+
         G_OBJECT_CLASS (gvc_sound_theme_chooser_parent_class)->dispose (object);
 }
 
@@ -94,15 +94,99 @@ gvc_channel_position_to_pretty_string (MateMixerChannelPosition position)
         return pretty_position[position];
 }
 
+static void
+fill_channel_table (GvcChannelTable *table, MateMixerStreamControl *control)
+{
+        guint i;
+
+        table->num_channels = mate_mixer_stream_control_get_num_channels (control);
+
+        for (i = 0; i < MATE_MIXER_CHANNEL_MAX; i++)
+                table->index[i] = -1;
+
+        for (i = 0; i < table->num_channels; i++) {
+                MateMixerChannelPosition position;
+
+                position = mate_mixer_stream_control_get_channel_position (control, i);
+
+                /* Keep the first channel with each position */
+                if (position > MATE_MIXER_CHANNEL_UNKNOWN &&
+                    position < MATE_MIXER_CHANNEL_MAX &&
+                    table->index[position] == -1)
+                        table->index[position] = i;
+        }
+
+        table->valid = TRUE;
+}
+
+static void
+on_control_channels_notify (MateMixerStreamControl *control,
+                            GParamSpec             *pspec,
+                            GvcChannelTable        *table)
+{
+        /* Rebuilt on the next use, the notifications are frequent */
+        table->valid = FALSE;
+}
+
+/* The table is attached to the control and built on first use. Backends
+ * notify the volume and the flags of a control when its channel map
+ * changes, which marks the table for rebuilding. */
+const GvcChannelTable *
+gvc_channel_table_get (MateMixerStreamControl *control)
+{
+        static GQuark    quark = 0;
+        GvcChannelTable *table;
+
+        g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control), NULL);
+
+        if (G_UNLIKELY (quark == 0))
+                quark = g_quark_from_static_string ("gvc-channel-table");
+
+        table = g_object_get_qdata (G_OBJECT (control), quark);
+        if (table == NULL) {
+                table = g_new0 (GvcChannelTable, 1);
+
+                /* The handlers go away with the control, before the table */
+                g_signal_connect (G_OBJECT (control),
+                                  "notify::volume",
+                                  G_CALLBACK (on_control_channels_notify),
+                                  table);
+                g_signal_connect (G_OBJECT (control),
+                                  "notify::flags",
+                                  G_CALLBACK (on_control_channels_notify),
+                                  table);
+
+                g_object_set_qdata_full (G_OBJECT (control), quark, table, g_free);
+        } else if (table->valid == TRUE)
+                return table;
+
+        fill_channel_table (table, control);
+        return table;
+}
+
+gint
+gvc_channel_table_get_index (const GvcChannelTable   *table,
+                             MateMixerChannelPosition position)
+{
+        g_return_val_if_fail (table != NULL, -1);
+        g_return_val_if_fail (position >= 0 && position < MATE_MIXER_CHANNEL_MAX, -1);
+
+        return table->index[position];
+}
+
 const gchar *
 gvc_channel_map_to_pretty_string (MateMixerStreamControl *control)
 {
+        const GvcChannelTable *table;
+
         g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control), NULL);
 
-#define HAS_POSITION(p) (mate_mixer_stream_control_has_channel_position (control, (p)))
+        table = gvc_channel_table_get (control);
+
+#define HAS_POSITION(p) (table->index[(p)] > -1)
 
         /* Modeled after PulseAudio 5.0, probably could be extended with other combinations */
-        switch (mate_mixer_stream_control_get_num_channels (control)) {
+        switch (table->num_channels) {
         case 1:
                 if (HAS_POSITION (MATE_MIXER_CHANNEL_MONO))
                         return _("Mono");
@@ -156,3 +240,52 @@ gvc_channel_map_to_pretty_string (MateMixerStreamControl *control)
 
         return NULL;
 }
+
+gchar *
+gvc_search_text_normalize (const gchar *text)
+{
+        gchar *normalized;
+        gchar *folded;
+
+        if (text == NULL)
+                return NULL;
+
+        /* Compatibility decomposition makes e.g. ligatures and full-width
+         * forms match their plain counterparts */
+        normalized = g_utf8_normalize (text, -1, G_NORMALIZE_ALL);
+        if (G_UNLIKELY (normalized == NULL))
+                return NULL;
+
+        folded = g_utf8_casefold (normalized, -1);
+        g_free (normalized);
+
+        return folded;
+}
+
+gchar *
+gvc_search_key_new (const gchar * const *fields, guint n_fields)
+{
+        GString *key;
+        guint    i;
+
+        g_return_val_if_fail (fields != NULL || n_fields == 0, NULL);
+
+        key = g_string_new (NULL);
+
+        for (i = 0; i < n_fields; i++) {
+                gchar *text;
+
+                text = gvc_search_text_normalize (fields[i]);
+                if (text == NULL)
+                        continue;
+
+                /* Separate the fields so that a match cannot span two of them */
+                if (key->len > 0)
+                        g_string_append_c (key, '\n');
+
+                g_string_append (key, text);
+                g_free (text);
+        }
+
+        return g_string_free (key, FALSE);
+}
@@ -27,10 +27,27 @@
 
 G_BEGIN_DECLS
 
+/* Index of the first channel of each position, -1 if not present */
+typedef struct
+{
+        guint    num_channels;
+        gint     index[MATE_MIXER_CHANNEL_MAX];
+        gboolean valid;
+} GvcChannelTable;
+
+const GvcChannelTable *gvc_channel_table_get       (MateMixerStreamControl  *control);
+gint                   gvc_channel_table_get_index (const GvcChannelTable   *table,
+                                                    MateMixerChannelPosition position);
+
 const gchar *gvc_channel_position_to_pulse_string  (MateMixerChannelPosition position);
 const gchar *gvc_channel_position_to_pretty_string (MateMixerChannelPosition position);
 const gchar *gvc_channel_map_to_pretty_string      (MateMixerStreamControl  *control);
 
+/* Case and accent insensitive text used for incremental searching */
+gchar       *gvc_search_text_normalize             (const gchar             *text);
+gchar       *gvc_search_key_new                    (const gchar * const     *fields,
+                                                    guint                    n_fields);
+
 G_END_DECLS
 
 #endif /* __GVC_HELPERS_H */
@@ -0,0 +1,157 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 8 -*-
+ * Copyright (C) 2026 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/* The alert sound definitions.
+ *
+ * The files list a <sound> element for each alert, holding the file of the
+ * alert and its name translated into many languages. The files are read in
+ * a single pass without building a document tree, only the contents of the
+ * name with the best language found so far are copied. */
+
+#include <config.h>
+#include <limits.h>
+#include <glib.h>
+#include <libxml/xmlreader.h>
+
+#include "sound-alert-reader.h"
+
+#define SOUND_ELEMENT    (xmlChar *) "sound"
+#define NAME_ELEMENT     (xmlChar *) "name"
+#define FILENAME_ELEMENT (xmlChar *) "filename"
+
+/* Position of the language in the list of preferred languages, lower is
+ * better. Names without a language come right before foreign ones */
+static int
+get_language_priority (const xmlChar       *lang,
+                       const gchar * const *langs)
+{
+        int j;
+
+        if (lang == NULL)
+                return INT_MAX - 1;
+
+        for (j = 0; langs[j] != NULL; j++) {
+                if (g_str_equal ((const gchar *) lang, langs[j]))
+                        return j;
+        }
+        return INT_MAX;
+}
+
+/**
+ * sound_alerts_read_file:
+ * @path: the file to read
+ * @langs: (allow-none): the preferred languages, the languages of the
+ *   current locale if %NULL
+ * @func: called for each alert with its file and translated name
+ * @user_data: data for @func
+ *
+ * Returns: %FALSE if the file could not be opened or is not valid, the
+ * alerts read before the error have been reported
+ **/
+gboolean
+sound_alerts_read_file (const char          *path,
+                        const gchar * const *langs,
+                        SoundAlertFunc       func,
+                        gpointer             user_data)
+{
+        xmlTextReaderPtr reader;
+        xmlChar         *sound_name = NULL;
+        xmlChar         *sound_file = NULL;
+        gboolean         in_sound = FALSE;
+        int              keep_pri = INT_MAX;
+        int              ret;
+
+        g_return_val_if_fail (path != NULL, FALSE);
+        g_return_val_if_fail (func != NULL, FALSE);
+
+        reader = xmlReaderForFile (path, NULL, XML_PARSE_NONET);
+        if (reader == NULL)
+                return FALSE;
+
+        if (langs == NULL)
+                langs = g_get_language_names ();
+
+        while ((ret = xmlTextReaderRead (reader)) == 1) {
+                const xmlChar *element;
+                int            type;
+                int            depth;
+
+                type = xmlTextReaderNodeType (reader);
+                if (type != XML_READER_TYPE_ELEMENT &&
+                    type != XML_READER_TYPE_END_ELEMENT)
+                        continue;
+
+                element = xmlTextReaderConstName (reader);
+                depth   = xmlTextReaderDepth (reader);
+
+                if (depth == 1 && xmlStrcmp (element, SOUND_ELEMENT) == 0) {
+                        if (type == XML_READER_TYPE_ELEMENT &&
+                            xmlTextReaderIsEmptyElement (reader) == 0) {
+                                in_sound = TRUE;
+                                keep_pri = INT_MAX;
+                                continue;
+                        }
+
+                        if (in_sound && sound_file != NULL && sound_name != NULL)
+                                func ((const char *) sound_file,
+                                      (const char *) sound_name,
+                                      user_data);
+
+                        if (sound_name != NULL)
+                                xmlFree (sound_name);
+                        if (sound_file != NULL)
+                                xmlFree (sound_file);
+
+                        sound_name = NULL;
+                        sound_file = NULL;
+                        in_sound = FALSE;
+                        continue;
+                }
+
+                if (in_sound == FALSE || depth != 2 || type != XML_READER_TYPE_ELEMENT)
+                        continue;
+
+                if (xmlStrcmp (element, NAME_ELEMENT) == 0) {
+                        int pri;
+
+                        pri = get_language_priority (xmlTextReaderConstXmlLang (reader), langs);
+                        if (pri <= keep_pri) {
+                                if (sound_name != NULL)
+                                        xmlFree (sound_name);
+
+                                sound_name = xmlTextReaderReadString (reader);
+                                keep_pri = pri;
+                        }
+                } else if (xmlStrcmp (element, FILENAME_ELEMENT) == 0) {
+                        if (sound_file != NULL)
+                                xmlFree (sound_file);
+
+                        sound_file = xmlTextReaderReadString (reader);
+                }
+        }
+
+        if (sound_name != NULL)
+                xmlFree (sound_name);
+        if (sound_file != NULL)
+                xmlFree (sound_file);
+
+        xmlFreeTextReader (reader);
+
+        return ret == 0;
+}
@@ -0,0 +1,33 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 8 -*-
+ * Copyright (C) 2026 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+#ifndef __SOUND_ALERT_READER_H__
+#define __SOUND_ALERT_READER_H__
+
+#include <glib.h>
+
+typedef void (* SoundAlertFunc) (const char *filename,
+                                 const char *name,
+                                 gpointer    user_data);
+
+gboolean sound_alerts_read_file (const char          *path,
+                                 const gchar * const *langs,
+                                 SoundAlertFunc       func,
+                                 gpointer             user_data);
+
+#endif /* __SOUND_ALERT_READER_H__ */
@@ -0,0 +1,586 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 8 -*-
+ * Copyright (C) 2026 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/* A folder of sounds the user can pick alerts from.
+ *
+ * Every file is opened to read the format, channels, rate and duration from
+ * its header, which also tells whether libcanberra is able to play it. The
+ * results are kept in a cache file together with the size and modification
+ * time of each file, so that a file is only read again after it has been
+ * changed. Only Ogg Vorbis and PCM WAV files are listed. */
+
+#include <config.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <gio/gio.h>
+
+#include "sound-library.h"
+
+#define CACHE_VERSION   1
+
+#define CACHE_GROUP     "Sound Library Cache"
+#define CONFIG_GROUP    "Sound Library"
+
+/* Depth of the subfolders searched for sounds */
+#define MAX_DEPTH       3
+
+/* Size of the end of an Ogg file searched for the last page */
+#define OGG_TAIL_SIZE   65536
+
+typedef struct {
+        guint     channels;
+        guint     rate;
+        gdouble   duration;
+} SoundInfo;
+
+void
+sound_library_entry_free (SoundLibraryEntry *entry)
+{
+        g_free (entry->path);
+        g_free (entry->name);
+        g_slice_free (SoundLibraryEntry, entry);
+}
+
+static char *
+get_config_path (void)
+{
+        return g_build_filename (g_get_user_config_dir (),
+                                 "mate-volume-control",
+                                 "sound-library",
+                                 NULL);
+}
+
+/**
+ * sound_library_get_folder:
+ *
+ * Returns: the folder chosen by the user, or %NULL
+ */
+char *
+sound_library_get_folder (void)
+{
+        GKeyFile *config;
+        char     *path;
+        char     *folder;
+
+        config = g_key_file_new ();
+
+        path = get_config_path ();
+        g_key_file_load_from_file (config, path, G_KEY_FILE_NONE, NULL);
+        g_free (path);
+
+        folder = g_key_file_get_string (config, CONFIG_GROUP, "Folder", NULL);
+        g_key_file_free (config);
+
+        return folder;
+}
+
+void
+sound_library_set_folder (const char *folder)
+{
+        GKeyFile *config;
+        GError   *error = NULL;
+        char     *path;
+        char     *dir;
+        char     *data;
+        gsize     length;
+
+        path = get_config_path ();
+
+        if (folder == NULL) {
+                g_unlink (path);
+                g_free (path);
+                return;
+        }
+
+        config = g_key_file_new ();
+        g_key_file_set_string (config, CONFIG_GROUP, "Folder", folder);
+        data = g_key_file_to_data (config, &length, NULL);
+        g_key_file_free (config);
+
+        dir = g_path_get_dirname (path);
+        g_mkdir_with_parents (dir, 0755);
+        g_free (dir);
+
+        if (g_file_set_contents (path, data, length, &error) == FALSE) {
+                g_warning ("Failed to save the sound library folder: %s", error->message);
+                g_error_free (error);
+        }
+
+        g_free (path);
+        g_free (data);
+}
+
+static guint16
+read_uint16 (const guchar *data)
+{
+        return data[0] | (data[1] << 8);
+}
+
+static guint32
+read_uint32 (const guchar *data)
+{
+        return (guint32) data[0] |
+               ((guint32) data[1] << 8) |
+               ((guint32) data[2] << 16) |
+               ((guint32) data[3] << 24);
+}
+
+static gint64
+read_int64 (const guchar *data)
+{
+        return (gint64) ((guint64) read_uint32 (data) |
+                         ((guint64) read_uint32 (data + 4) << 32));
+}
+
+static gboolean
+read_wav_info (FILE *f, SoundInfo *info)
+{
+        guchar   header[12];
+        guchar   chunk[8];
+        guchar   fmt[16];
+        guint32  byte_rate = 0;
+        gboolean have_fmt = FALSE;
+
+        if (fread (header, 1, sizeof (header), f) != sizeof (header) ||
+            memcmp (header, "RIFF", 4) != 0 ||
+            memcmp (header + 8, "WAVE", 4) != 0)
+                return FALSE;
+
+        while (fread (chunk, 1, sizeof (chunk), f) == sizeof (chunk)) {
+                guint32 size = read_uint32 (chunk + 4);
+
+                if (memcmp (chunk, "fmt ", 4) == 0) {
+                        guint16 format;
+                        guint16 bits;
+
+                        if (size < sizeof (fmt) || fread (fmt, 1, sizeof (fmt), f) != sizeof (fmt))
+                                return FALSE;
+
+                        format         = read_uint16 (fmt);
+                        info->channels = read_uint16 (fmt + 2);
+                        info->rate     = read_uint32 (fmt + 4);
+                        byte_rate      = read_uint32 (fmt + 8);
+                        bits           = read_uint16 (fmt + 14);
+
+                        /* libcanberra only reads plain 8 and 16 bit PCM, not extensible */
+                        if (format != 1 ||
+                            (bits != 8 && bits != 16) ||
+                            info->channels == 0 ||
+                            info->rate == 0 ||
+                            byte_rate == 0)
+                                return FALSE;
+
+                        have_fmt = TRUE;
+                        size -= sizeof (fmt);
+                } else if (memcmp (chunk, "data", 4) == 0) {
+                        if (have_fmt == FALSE)
+                                return FALSE;
+
+                        info->duration = (gdouble) size / byte_rate;
+                        return TRUE;
+                }
+
+                /* Chunks are padded to an even size */
+                if (fseek (f, size + (size & 1), SEEK_CUR) != 0)
+                        return FALSE;
+        }
+
+        return FALSE;
+}
+
+static gboolean
+read_ogg_info (FILE *f, goffset file_size, SoundInfo *info)
+{
+        guchar  page[27 + 255 + 30];
+        guchar *tail;
+        gsize   length;
+        gsize   offset;
+        gsize   i;
+        gint64  granule = -1;
+        guint   segments;
+
+        length = fread (page, 1, sizeof (page), f);
+        if (length < 27 || memcmp (page, "OggS", 4) != 0)
+                return FALSE;
+
+        /* The first packet is the identification header of the codec */
+        segments = page[26];
+        offset = 27 + segments;
+        if (offset + 16 > length ||
+            page[offset] != 0x01 ||
+            memcmp (page + offset + 1, "vorbis", 6) != 0)
+                return FALSE;
+
+        info->channels = page[offset + 11];
+        info->rate     = read_uint32 (page + offset + 12);
+        if (info->channels == 0 || info->rate == 0)
+                return FALSE;
+
+        /* The granule position of the last page is the number of samples */
+        length = MIN (file_size, OGG_TAIL_SIZE);
+        if (fseek (f, file_size - length, SEEK_SET) != 0)
+                return FALSE;
+
+        tail = g_malloc (length);
+        length = fread (tail, 1, length, f);
+
+        for (i = length >= 27 ? length - 27 + 1 : 0; i > 0; i--) {
+                const guchar *p = tail + i - 1;
+
+                if (memcmp (p, "OggS", 4) == 0 &&
+                    memcmp (p + 14, page + 14, 4) == 0) {
+                        granule = read_int64 (p + 6);
+                        if (granule >= 0)
+                                break;
+                }
+        }
+        g_free (tail);
+
+        if (granule < 0)
+                return FALSE;
+
+        info->duration = (gdouble) granule / info->rate;
+        return TRUE;
+}
+
+static gboolean
+read_sound_info (const char *path, goffset size, SoundInfo *info)
+{
+        FILE       *f;
+        const char *suffix;
+        gboolean    result;
+
+        f = g_fopen (path, "rb");
+        if (f == NULL)
+                return FALSE;
+
+        /* Matched the same way as in is_sound_file() */
+        suffix = strrchr (path, '.');
+
+        if (suffix != NULL && g_ascii_strcasecmp (suffix, ".wav") == 0)
+                result = read_wav_info (f, info);
+        else
+                result = read_ogg_info (f, size, info);
+
+        fclose (f);
+        return result;
+}
+
+static gboolean
+is_sound_file (const char *name)
+{
+        const char *suffix;
+
+        suffix = strrchr (name, '.');
+        if (suffix == NULL)
+                return FALSE;
+
+        return g_ascii_strcasecmp (suffix, ".ogg") == 0 ||
+               g_ascii_strcasecmp (suffix, ".oga") == 0 ||
+               g_ascii_strcasecmp (suffix, ".wav") == 0;
+}
+
+static char *
+get_cache_path (void)
+{
+        return g_build_filename (g_get_user_cache_dir (),
+                                 "mate-volume-control",
+                                 "sound-library",
+                                 NULL);
+}
+
+static GKeyFile *
+load_cache (const char *folder)
+{
+        GKeyFile *cache;
+        char     *path;
+        char     *cached_folder;
+        gint      version;
+
+        cache = g_key_file_new ();
+
+        path = get_cache_path ();
+        if (g_key_file_load_from_file (cache, path, G_KEY_FILE_NONE, NULL) == FALSE) {
+                g_free (path);
+                return cache;
+        }
+        g_free (path);
+
+        version = g_key_file_get_integer (cache, CACHE_GROUP, "Version", NULL);
+        cached_folder = g_key_file_get_string (cache, CACHE_GROUP, "Folder", NULL);
+
+        if (version != CACHE_VERSION || g_strcmp0 (folder, cached_folder) != 0) {
+                g_debug ("Discarding outdated sound library cache");
+
+                g_key_file_free (cache);
+                cache = g_key_file_new ();
+        }
+        g_free (cached_folder);
+
+        return cache;
+}
+
+static void
+save_cache (GKeyFile *cache, const char *folder)
+{
+        GError *error = NULL;
+        char   *path;
+        char   *dir;
+        char   *data;
+        gsize   length;
+
+        g_key_file_set_integer (cache, CACHE_GROUP, "Version", CACHE_VERSION);
+        g_key_file_set_string (cache, CACHE_GROUP, "Folder", folder);
+
+        data = g_key_file_to_data (cache, &length, NULL);
+        path = get_cache_path ();
+
+        dir = g_path_get_dirname (path);
+        g_mkdir_with_parents (dir, 0755);
+        g_free (dir);
+
+        if (g_file_set_contents (path, data, length, &error) == FALSE) {
+                g_debug ("Failed to save the sound library cache: %s", error->message);
+                g_error_free (error);
+        }
+
+        g_free (path);
+        g_free (data);
+}
+
+static gboolean
+is_cacheable (const char *path)
+{
+        /* Group names cannot hold these */
+        return strpbrk (path, "[]\n\r") == NULL;
+}
+
+/* Returns whether the file was found in the cache, @valid tells whether it
+ * is a playable sound */
+static gboolean
+load_cached_info (GKeyFile   *cache,
+                  const char *path,
+                  GStatBuf   *buf,
+                  SoundInfo  *info,
+                  gboolean   *valid)
+{
+        if (g_key_file_has_group (cache, path) == FALSE)
+                return FALSE;
+
+        if (g_key_file_get_uint64 (cache, path, "Size", NULL) != (guint64) buf->st_size ||
+            g_key_file_get_int64 (cache, path, "MTime", NULL) != (gint64) buf->st_mtime)
+                return FALSE;
+
+        *valid = g_key_file_get_boolean (cache, path, "Valid", NULL);
+        if (*valid == FALSE)
+                return TRUE;
+
+        info->channels = g_key_file_get_integer (cache, path, "Channels", NULL);
+        info->rate     = g_key_file_get_integer (cache, path, "Rate", NULL);
+        info->duration = g_key_file_get_double (cache, path, "Duration", NULL);
+        return TRUE;
+}
+
+static void
+save_cached_info (GKeyFile   *cache,
+                  const char *path,
+                  GStatBuf   *buf,
+                  SoundInfo  *info,
+                  gboolean    valid)
+{
+        g_key_file_remove_group (cache, path, NULL);
+
+        g_key_file_set_uint64 (cache, path, "Size", buf->st_size);
+        g_key_file_set_int64 (cache, path, "MTime", buf->st_mtime);
+        g_key_file_set_boolean (cache, path, "Valid", valid);
+
+        if (valid == FALSE)
+                return;
+
+        g_key_file_set_integer (cache, path, "Channels", info->channels);
+        g_key_file_set_integer (cache, path, "Rate", info->rate);
+        g_key_file_set_double (cache, path, "Duration", info->duration);
+}
+
+static char *
+get_display_name (const char *path)
+{
+        char *basename;
+        char *name;
+        char *suffix;
+
+        basename = g_filename_display_basename (path);
+        suffix = strrchr (basename, '.');
+        if (suffix != NULL && suffix != basename)
+                *suffix = '\0';
+
+        name = g_strdup (g_strdelimit (basename, "_", ' '));
+        g_free (basename);
+
+        return name;
+}
+
+static gboolean
+scan_folder (GPtrArray    *entries,
+             GKeyFile     *cache,
+             GHashTable   *seen,
+             const char   *folder,
+             guint         depth,
+             GCancellable *cancellable)
+{
+        GDir       *d;
+        const char *name;
+        gboolean    changed = FALSE;
+
+        d = g_dir_open (folder, 0, NULL);
+        if (d == NULL)
+                return FALSE;
+
+        while ((name = g_dir_read_name (d)) != NULL) {
+                SoundLibraryEntry *entry;
+                SoundInfo          info = { 0, 0, 0.0 };
+                GStatBuf           buf;
+                gboolean           valid;
+                char              *path;
+
+                if (g_cancellable_is_cancelled (cancellable))
+                        break;
+                if (name[0] == '.')
+                        continue;
+
+                path = g_build_filename (folder, name, NULL);
+
+                if (g_stat (path, &buf) != 0) {
+                        g_free (path);
+                        continue;
+                }
+
+                if (S_ISDIR (buf.st_mode)) {
+                        if (depth < MAX_DEPTH)
+                                changed |= scan_folder (entries, cache, seen, path, depth + 1, cancellable);
+
+                        g_free (path);
+                        continue;
+                }
+
+                if (S_ISREG (buf.st_mode) == FALSE || is_sound_file (name) == FALSE) {
+                        g_free (path);
+                        continue;
+                }
+
+                if (is_cacheable (path)) {
+                        g_hash_table_add (seen, g_strdup (path));
+
+                        if (load_cached_info (cache, path, &buf, &info, &valid) == FALSE) {
+                                valid = read_sound_info (path, buf.st_size, &info);
+
+                                save_cached_info (cache, path, &buf, &info, valid);
+                                changed = TRUE;
+                        }
+                } else {
+                        valid = read_sound_info (path, buf.st_size, &info);
+                }
+
+                if (valid == FALSE) {
+                        g_debug ("Skipping %s, not a playable sound", path);
+                        g_free (path);
+                        continue;
+                }
+
+                entry = g_slice_new (SoundLibraryEntry);
+                entry->path     = path;
+                entry->name     = get_display_name (path);
+                entry->channels = info.channels;
+                entry->rate     = info.rate;
+                entry->duration = info.duration;
+
+                g_ptr_array_add (entries, entry);
+        }
+        g_dir_close (d);
+
+        return changed;
+}
+
+static gint
+compare_entries (gconstpointer a, gconstpointer b)
+{
+        const SoundLibraryEntry *entry_a = *(const SoundLibraryEntry **) a;
+        const SoundLibraryEntry *entry_b = *(const SoundLibraryEntry **) b;
+
+        return g_utf8_collate (entry_a->name, entry_b->name);
+}
+
+/**
+ * sound_library_load:
+ * @folder: the folder to search
+ * @cancellable: (allow-none): a #GCancellable
+ *
+ * Reads the sounds of @folder and its subfolders, this may take a while
+ * and should be called from a thread.
+ *
+ * Returns: an array of #SoundLibraryEntry sorted by name
+ */
+GPtrArray *
+sound_library_load (const char *folder, GCancellable *cancellable)
+{
+        GPtrArray  *entries;
+        GKeyFile   *cache;
+        GHashTable *seen;
+        gchar     **groups;
+        gboolean    changed;
+        guint       i;
+
+        g_return_val_if_fail (folder != NULL, NULL);
+
+        entries = g_ptr_array_new_with_free_func ((GDestroyNotify) sound_library_entry_free);
+
+        cache = load_cache (folder);
+        seen  = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+        changed = scan_folder (entries, cache, seen, folder, 0, cancellable);
+
+        if (g_cancellable_is_cancelled (cancellable) == FALSE) {
+                /* Forget the files which are gone */
+                groups = g_key_file_get_groups (cache, NULL);
+                for (i = 0; groups[i] != NULL; i++) {
+                        if (strcmp (groups[i], CACHE_GROUP) == 0 ||
+                            g_hash_table_contains (seen, groups[i]) == TRUE)
+                                continue;
+
+                        g_key_file_remove_group (cache, groups[i], NULL);
+                        changed = TRUE;
+                }
+                g_strfreev (groups);
+
+                if (changed)
+                        save_cache (cache, folder);
+        }
+
+        g_hash_table_destroy (seen);
+        g_key_file_free (cache);
+
+        g_ptr_array_sort (entries, compare_entries);
+
+        g_debug ("Found %u sounds in %s", entries->len, folder);
+
+        return entries;
+}
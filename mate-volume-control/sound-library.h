@@ -0,0 +1,40 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 8 -*-
+ * Copyright (C) 2026 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+#ifndef __SOUND_LIBRARY_H__
+#define __SOUND_LIBRARY_H__
+
+#include <gio/gio.h>
+
+typedef struct {
+        char     *path;
+        char     *name;
+        guint     channels;
+        guint     rate;
+        gdouble   duration;
+} SoundLibraryEntry;
+
+void        sound_library_entry_free (SoundLibraryEntry *entry);
+
+char       *sound_library_get_folder (void);
+void        sound_library_set_folder (const char        *folder);
+
+GPtrArray  *sound_library_load       (const char        *folder,
+                                      GCancellable      *cancellable);
+
+#endif /* __SOUND_LIBRARY_H__ */
@@ -22,22 +22,140 @@
 #include <glib/gi18n.h>
 #include <gio/gio.h>
 #include <utime.h>
+#include <errno.h>
+#include <string.h>
 #include <strings.h>
+#include <unistd.h>
 
 #include "sound-theme-file-utils.h"
 
 #define CUSTOM_THEME_NAME       "__custom"
+#define TRASH_PREFIX            "." CUSTOM_THEME_NAME "-trash-"
+
+/* Number of entries read and deleted at once when removing directories
+ * in the background */
+#define DELETE_BATCH_SIZE       64
+
+typedef struct {
+        GFileType  type;
+        char      *target;
+} CustomThemeEntry;
+
+/* Contents of the custom theme directory, read in one pass and dropped
+ * whenever the directory is changed */
+static GHashTable *snapshot = NULL;
+
+/* Transactions are written one at a time, in the order of their commits */
+static GThreadPool *transaction_pool = NULL;
+static guint        pending_transactions = 0;
+
+static void
+custom_theme_entry_free (CustomThemeEntry *entry)
+{
+        g_free (entry->target);
+        g_slice_free (CustomThemeEntry, entry);
+}
+
+static void
+snapshot_clear (void)
+{
+        if (snapshot != NULL) {
+                g_hash_table_destroy (snapshot);
+                snapshot = NULL;
+        }
+}
 
-/* This function needs to be called after each individual
- * changeset to the theme */
 void
-custom_theme_update_time (void)
+custom_theme_dir_invalidate (void)
 {
-        char *path;
+        /* The snapshot already holds the result of the transactions
+         * being written, reading the directory now would show them
+         * half done */
+        if (pending_transactions > 0)
+                return;
 
-        path = custom_theme_dir_path (NULL);
-        utime (path, NULL);
-        g_free (path);
+        snapshot_clear ();
+}
+
+static GHashTable *
+custom_theme_dir_snapshot (void)
+{
+        char            *dir;
+        GFile           *file;
+        GFileEnumerator *enumerator;
+        GFileInfo       *info;
+        GError          *error = NULL;
+
+        if (snapshot != NULL)
+                return snapshot;
+
+        snapshot = g_hash_table_new_full (g_str_hash,
+                                          g_str_equal,
+                                          g_free,
+                                          (GDestroyNotify) custom_theme_entry_free);
+
+        dir = custom_theme_dir_path (NULL);
+        file = g_file_new_for_path (dir);
+        g_free (dir);
+
+        enumerator = g_file_enumerate_children (file,
+                                                G_FILE_ATTRIBUTE_STANDARD_NAME ","
+                                                G_FILE_ATTRIBUTE_STANDARD_TYPE ","
+                                                G_FILE_ATTRIBUTE_STANDARD_SYMLINK_TARGET,
+                                                G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
+                                                NULL, &error);
+        if (enumerator == NULL) {
+                /* A missing directory is simply an empty theme */
+                if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) == FALSE)
+                        g_warning ("Unable to enumerate files: %s", error->message);
+
+                g_error_free (error);
+                g_object_unref (file);
+                return snapshot;
+        }
+
+        while ((info = g_file_enumerator_next_file (enumerator, NULL, NULL)) != NULL) {
+                CustomThemeEntry *entry;
+
+                entry = g_slice_new (CustomThemeEntry);
+                entry->type   = g_file_info_get_file_type (info);
+                entry->target = g_strdup (g_file_info_get_symlink_target (info));
+
+                g_hash_table_insert (snapshot,
+                                     g_strdup (g_file_info_get_name (info)),
+                                     entry);
+                g_object_unref (info);
+        }
+        g_file_enumerator_close (enumerator, NULL, NULL);
+        g_object_unref (enumerator);
+        g_object_unref (file);
+
+        g_debug ("Read %u entries of the custom theme dir",
+                 g_hash_table_size (snapshot));
+
+        return snapshot;
+}
+
+gboolean
+custom_theme_dir_has_file (const char *name)
+{
+        CustomThemeEntry *entry;
+
+        entry = g_hash_table_lookup (custom_theme_dir_snapshot (), name);
+
+        return entry != NULL && entry->type == G_FILE_TYPE_REGULAR;
+}
+
+char *
+custom_theme_dir_read_link (const char *name)
+{
+        CustomThemeEntry *entry;
+
+        entry = g_hash_table_lookup (custom_theme_dir_snapshot (), name);
+        if (entry == NULL || entry->type != G_FILE_TYPE_SYMBOLIC_LINK)
+                return NULL;
+
+        return g_strdup (entry->target);
 }
 
 char *
@@ -66,7 +184,7 @@ directory_delete_recursive (GFile *directory, GError **error)
         enumerator = g_file_enumerate_children (directory,
                                                 G_FILE_ATTRIBUTE_STANDARD_NAME ","
                                                 G_FILE_ATTRIBUTE_STANDARD_TYPE,
-                                                G_FILE_QUERY_INFO_NONE,
+                                                G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
                                                 NULL, error);
         if (enumerator == NULL)
                 return FALSE;
@@ -125,181 +243,983 @@ capplet_file_delete_recursive (GFile *file, GError **error)
                 return g_file_delete (file, NULL, error);
 }
 
-void
-delete_custom_theme_dir (void)
+typedef struct {
+        GFile           *dir;
+        GFileEnumerator *enumerator;
+        GList           *subdirs;
+        gboolean         listed;
+} DeleteFrame;
+
+typedef struct {
+        GSList          *frames;
+        guint            outstanding;
+        GError          *error;
+} DeleteData;
+
+static void delete_next (GTask *task);
+static void delete_next_batch (GTask *task);
+
+static void
+delete_frame_free (DeleteFrame *frame)
 {
-        char *dir;
-        GFile *file;
+        g_object_unref (frame->dir);
+        g_clear_object (&frame->enumerator);
+        g_list_free_full (frame->subdirs, g_object_unref);
+        g_slice_free (DeleteFrame, frame);
+}
 
-        dir = custom_theme_dir_path (NULL);
-        file = g_file_new_for_path (dir);
-        g_free (dir);
-        capplet_file_delete_recursive (file, NULL);
-        g_object_unref (file);
+static void
+delete_data_free (DeleteData *data)
+{
+        g_slist_free_full (data->frames, (GDestroyNotify) delete_frame_free);
+        if (data->error != NULL)
+                g_error_free (data->error);
 
-        g_debug ("deleted the custom theme dir");
+        g_slice_free (DeleteData, data);
 }
 
-gboolean
-custom_theme_dir_is_empty (void)
+static void
+delete_push_frame (DeleteData *data, GFile *dir)
 {
-        char            *dir;
-        GFile           *file;
-        gboolean         is_empty;
-        GFileEnumerator *enumerator;
-        GFileInfo       *info;
-        GError          *error = NULL;
+        DeleteFrame *frame;
 
-        dir = custom_theme_dir_path (NULL);
-        file = g_file_new_for_path (dir);
-        g_free (dir);
+        frame = g_slice_new0 (DeleteFrame);
+        frame->dir = g_object_ref (dir);
 
-        is_empty = TRUE;
+        data->frames = g_slist_prepend (data->frames, frame);
+}
 
-        enumerator = g_file_enumerate_children (file,
-                                                G_FILE_ATTRIBUTE_STANDARD_NAME ","
-                                                G_FILE_ATTRIBUTE_STANDARD_TYPE,
-                                                G_FILE_QUERY_INFO_NONE,
-                                                NULL, &error);
-        if (enumerator == NULL) {
-                g_warning ("Unable to enumerate files: %s", error->message);
-                g_error_free (error);
-                goto out;
+static void
+on_delete_dir_deleted (GObject      *source_object,
+                       GAsyncResult *result,
+                       gpointer      user_data)
+{
+        GTask      *task = user_data;
+        DeleteData *data = g_task_get_task_data (task);
+        GError     *error = NULL;
+
+        if (g_file_delete_finish (G_FILE (source_object), result, &error) == FALSE &&
+            g_error_matches (error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) == FALSE) {
+                g_task_return_error (task, error);
+                g_object_unref (task);
+                return;
         }
+        g_clear_error (&error);
 
-        while (is_empty &&
-               (info = g_file_enumerator_next_file (enumerator, NULL, NULL))) {
+        delete_frame_free (data->frames->data);
+        data->frames = g_slist_delete_link (data->frames, data->frames);
+
+        if (data->frames == NULL) {
+                g_task_return_boolean (task, TRUE);
+                g_object_unref (task);
+                return;
+        }
+        delete_next (task);
+}
 
-                if (strcmp ("index.theme", g_file_info_get_name (info)) != 0) {
-                        is_empty = FALSE;
+static void
+on_delete_file_deleted (GObject      *source_object,
+                        GAsyncResult *result,
+                        gpointer      user_data)
+{
+        GTask      *task = user_data;
+        DeleteData *data = g_task_get_task_data (task);
+        GError     *error = NULL;
+
+        if (g_file_delete_finish (G_FILE (source_object), result, &error) == FALSE) {
+                if (data->error == NULL &&
+                    g_error_matches (error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) == FALSE)
+                        data->error = error;
+                else
+                        g_error_free (error);
+        }
+
+        /* Wait for the whole batch before reading the next one */
+        if (--data->outstanding > 0)
+                return;
+
+        if (data->error != NULL) {
+                g_task_return_error (task, data->error);
+                data->error = NULL;
+                g_object_unref (task);
+                return;
+        }
+        delete_next_batch (task);
+}
+
+static void
+on_delete_files_listed (GObject      *source_object,
+                        GAsyncResult *result,
+                        gpointer      user_data)
+{
+        GTask       *task = user_data;
+        DeleteData  *data = g_task_get_task_data (task);
+        DeleteFrame *frame = data->frames->data;
+        GList       *infos, *l;
+        GError      *error = NULL;
+
+        infos = g_file_enumerator_next_files_finish (G_FILE_ENUMERATOR (source_object),
+                                                     result,
+                                                     &error);
+        if (error != NULL) {
+                g_task_return_error (task, error);
+                g_object_unref (task);
+                return;
+        }
+
+        if (infos == NULL) {
+                /* All the files are gone, the subdirectories are next */
+                g_file_enumerator_close_async (frame->enumerator,
+                                               G_PRIORITY_LOW,
+                                               NULL, NULL, NULL);
+                g_clear_object (&frame->enumerator);
+
+                frame->listed = TRUE;
+                delete_next (task);
+                return;
+        }
+
+        for (l = infos; l != NULL; l = l->next) {
+                GFileInfo *info = l->data;
+                GFile     *child;
+
+                child = g_file_get_child (frame->dir, g_file_info_get_name (info));
+
+                if (g_file_info_get_file_type (info) == G_FILE_TYPE_DIRECTORY) {
+                        frame->subdirs = g_list_prepend (frame->subdirs, child);
+                } else {
+                        data->outstanding++;
+
+                        g_file_delete_async (child,
+                                             G_PRIORITY_LOW,
+                                             g_task_get_cancellable (task),
+                                             on_delete_file_deleted,
+                                             task);
+                        g_object_unref (child);
                 }
+        }
+        g_list_free_full (infos, g_object_unref);
 
-                g_object_unref (info);
+        if (data->outstanding == 0)
+                delete_next_batch (task);
+}
+
+static void
+delete_next_batch (GTask *task)
+{
+        DeleteData  *data = g_task_get_task_data (task);
+        DeleteFrame *frame = data->frames->data;
+
+        g_file_enumerator_next_files_async (frame->enumerator,
+                                            DELETE_BATCH_SIZE,
+                                            G_PRIORITY_LOW,
+                                            g_task_get_cancellable (task),
+                                            on_delete_files_listed,
+                                            task);
+}
+
+static void
+on_delete_dir_enumerated (GObject      *source_object,
+                          GAsyncResult *result,
+                          gpointer      user_data)
+{
+        GTask       *task = user_data;
+        DeleteData  *data = g_task_get_task_data (task);
+        DeleteFrame *frame = data->frames->data;
+        GError      *error = NULL;
+
+        frame->enumerator = g_file_enumerate_children_finish (G_FILE (source_object),
+                                                              result,
+                                                              &error);
+        if (frame->enumerator == NULL) {
+                if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_NOT_DIRECTORY) == FALSE) {
+                        g_task_return_error (task, error);
+                        g_object_unref (task);
+                        return;
+                }
+
+                /* Not a directory, just remove it */
+                g_error_free (error);
+                frame->listed = TRUE;
+                delete_next (task);
+                return;
         }
-        g_file_enumerator_close (enumerator, NULL, NULL);
+        delete_next_batch (task);
+}
 
- out:
-        g_object_unref (file);
+static void
+delete_next (GTask *task)
+{
+        DeleteData  *data = g_task_get_task_data (task);
+        DeleteFrame *frame = data->frames->data;
+
+        if (frame->listed == FALSE) {
+                g_file_enumerate_children_async (frame->dir,
+                                                 G_FILE_ATTRIBUTE_STANDARD_NAME ","
+                                                 G_FILE_ATTRIBUTE_STANDARD_TYPE,
+                                                 G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
+                                                 G_PRIORITY_LOW,
+                                                 g_task_get_cancellable (task),
+                                                 on_delete_dir_enumerated,
+                                                 task);
+                return;
+        }
+
+        if (frame->subdirs != NULL) {
+                GFile *subdir = frame->subdirs->data;
+
+                frame->subdirs = g_list_delete_link (frame->subdirs, frame->subdirs);
+
+                delete_push_frame (data, subdir);
+                g_object_unref (subdir);
+
+                delete_next (task);
+                return;
+        }
 
-        return is_empty;
+        /* Everything below the directory is gone */
+        g_file_delete_async (frame->dir,
+                             G_PRIORITY_LOW,
+                             g_task_get_cancellable (task),
+                             on_delete_dir_deleted,
+                             task);
 }
 
+/**
+ * capplet_file_delete_recursive_async :
+ * @file :
+ * @cancellable :
+ * @callback :
+ * @user_data :
+ *
+ * Deletes @file like capplet_file_delete_recursive() without blocking,
+ * the directories are read and emptied in batches.
+ **/
 static void
-delete_one_file (const char *sound_name, const char *pattern)
+capplet_file_delete_recursive_async (GFile               *file,
+                                     GCancellable        *cancellable,
+                                     GAsyncReadyCallback  callback,
+                                     gpointer             user_data)
 {
-        GFile *file;
-        char *name, *filename;
+        DeleteData *data;
+        GTask      *task;
 
-        name = g_strdup_printf (pattern, sound_name);
-        filename = custom_theme_dir_path (name);
-        g_free (name);
-        file = g_file_new_for_path (filename);
-        g_free (filename);
-        capplet_file_delete_recursive (file, NULL);
-        g_object_unref (file);
+        data = g_slice_new0 (DeleteData);
+        delete_push_frame (data, file);
+
+        task = g_task_new (NULL, cancellable, callback, user_data);
+        g_task_set_task_data (task, data, (GDestroyNotify) delete_data_free);
+
+        delete_next (task);
+}
+
+static gboolean
+capplet_file_delete_recursive_finish (GAsyncResult *result, GError **error)
+{
+        return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+gboolean
+custom_theme_dir_is_empty (void)
+{
+        GHashTable *entries;
+
+        entries = custom_theme_dir_snapshot ();
+
+        if (g_hash_table_size (entries) == 0)
+                return TRUE;
+
+        return g_hash_table_size (entries) == 1 &&
+               g_hash_table_contains (entries, "index.theme");
+}
+
+typedef enum {
+        CUSTOM_SOUND_RESET,
+        CUSTOM_SOUND_DISABLED,
+        CUSTOM_SOUND_LINK
+} CustomSoundChange;
+
+typedef struct {
+        CustomSoundChange  change;
+        char              *filename;
+} CustomSound;
+
+struct _CustomThemeTransaction {
+        char       *dir;
+        char       *trash;
+        char       *parent;
+        gboolean    delete_theme;
+        GHashTable *sounds;
+};
+
+typedef struct {
+        GAsyncReadyCallback callback;
+        gpointer            user_data;
+} CommitData;
+
+static void
+custom_sound_free (CustomSound *sound)
+{
+        g_free (sound->filename);
+        g_slice_free (CustomSound, sound);
+}
+
+CustomThemeTransaction *
+custom_theme_transaction_new (void)
+{
+        CustomThemeTransaction *transaction;
+
+        transaction = g_slice_new0 (CustomThemeTransaction);
+        transaction->sounds = g_hash_table_new_full (g_str_hash,
+                                                     g_str_equal,
+                                                     g_free,
+                                                     (GDestroyNotify) custom_sound_free);
+        return transaction;
+}
+
+void
+custom_theme_transaction_free (CustomThemeTransaction *transaction)
+{
+        if (transaction == NULL)
+                return;
+
+        g_hash_table_destroy (transaction->sounds);
+        g_free (transaction->parent);
+        g_free (transaction->trash);
+        g_free (transaction->dir);
+        g_slice_free (CustomThemeTransaction, transaction);
 }
 
+/* Writes a new index.theme inheriting from @parent, creating the
+ * theme if needed */
 void
-delete_old_files (const char **sounds)
+custom_theme_transaction_set_parent (CustomThemeTransaction *transaction,
+                                     const char             *parent)
+{
+        g_free (transaction->parent);
+        transaction->parent = g_strdup (parent);
+}
+
+static void
+set_sounds (CustomThemeTransaction *transaction,
+            const char            **sounds,
+            CustomSoundChange       change,
+            const char             *filename)
 {
         guint i;
 
         for (i = 0; sounds[i] != NULL; i++) {
-                delete_one_file (sounds[i], "%s.ogg");
+                CustomSound *sound;
+
+                sound = g_slice_new (CustomSound);
+                sound->change   = change;
+                sound->filename = g_strdup (filename);
+
+                g_hash_table_insert (transaction->sounds, g_strdup (sounds[i]), sound);
         }
 }
 
+/* Falls back to the sounds of the parent theme */
 void
-delete_disabled_files (const char **sounds)
+custom_theme_transaction_reset_sounds (CustomThemeTransaction *transaction,
+                                       const char            **sounds)
 {
-        guint i;
+        set_sounds (transaction, sounds, CUSTOM_SOUND_RESET, NULL);
+}
 
-        for (i = 0; sounds[i] != NULL; i++)
-                delete_one_file (sounds[i], "%s.disabled");
+void
+custom_theme_transaction_disable_sounds (CustomThemeTransaction *transaction,
+                                         const char            **sounds)
+{
+        set_sounds (transaction, sounds, CUSTOM_SOUND_DISABLED, NULL);
+}
+
+void
+custom_theme_transaction_link_sounds (CustomThemeTransaction *transaction,
+                                      const char            **sounds,
+                                      const char             *filename)
+{
+        set_sounds (transaction, sounds, CUSTOM_SOUND_LINK, filename);
+}
+
+/* Removes the whole theme, other changes are ignored */
+void
+custom_theme_transaction_delete_theme (CustomThemeTransaction *transaction)
+{
+        transaction->delete_theme = TRUE;
 }
 
 static void
-create_one_file (GFile *file)
+snapshot_apply (CustomThemeTransaction *transaction)
 {
-        GFileOutputStream* stream;
+        GHashTable       *entries;
+        GHashTableIter    iter;
+        CustomThemeEntry *entry;
+        gpointer          key, value;
+
+        entries = custom_theme_dir_snapshot ();
+
+        if (transaction->delete_theme) {
+                g_hash_table_remove_all (entries);
+                return;
+        }
+
+        if (transaction->parent != NULL) {
+                entry = g_slice_new0 (CustomThemeEntry);
+                entry->type = G_FILE_TYPE_REGULAR;
+
+                g_hash_table_insert (entries, g_strdup ("index.theme"), entry);
+        }
 
-        stream = g_file_create (file, G_FILE_CREATE_NONE, NULL, NULL);
-        if (stream != NULL) {
-                g_output_stream_close (G_OUTPUT_STREAM (stream), NULL, NULL);
-                g_object_unref (stream);
+        g_hash_table_iter_init (&iter, transaction->sounds);
+        while (g_hash_table_iter_next (&iter, &key, &value)) {
+                CustomSound *sound = value;
+                char        *ogg, *disabled;
+
+                ogg = g_strdup_printf ("%s.ogg", (char *) key);
+                disabled = g_strdup_printf ("%s.disabled", (char *) key);
+
+                g_hash_table_remove (entries, ogg);
+                g_hash_table_remove (entries, disabled);
+
+                if (sound->change == CUSTOM_SOUND_LINK) {
+                        entry = g_slice_new0 (CustomThemeEntry);
+                        entry->type   = G_FILE_TYPE_SYMBOLIC_LINK;
+                        entry->target = g_strdup (sound->filename);
+
+                        g_hash_table_insert (entries, ogg, entry);
+                        ogg = NULL;
+                } else if (sound->change == CUSTOM_SOUND_DISABLED) {
+                        entry = g_slice_new0 (CustomThemeEntry);
+                        entry->type = G_FILE_TYPE_REGULAR;
+
+                        g_hash_table_insert (entries, disabled, entry);
+                        disabled = NULL;
+                }
+                g_free (ogg);
+                g_free (disabled);
         }
 }
 
-void
-add_disabled_file (const char **sounds)
+static gboolean
+set_error_from_errno (GError    **error,
+                      const char *message,
+                      const char *path)
 {
-        guint i;
+        int saved_errno = errno;
 
-        for (i = 0; sounds[i] != NULL; i++) {
-                GFile *file;
-                char *name, *filename;
+        g_set_error (error,
+                     G_IO_ERROR,
+                     g_io_error_from_errno (saved_errno),
+                     "%s '%s': %s",
+                     message,
+                     path,
+                     g_strerror (saved_errno));
+        return FALSE;
+}
 
-                name = g_strdup_printf ("%s.disabled", sounds[i]);
-                filename = custom_theme_dir_path (name);
-                g_free (name);
-                file = g_file_new_for_path (filename);
-                g_free (filename);
+static gboolean
+delete_path (const char *path, GError **error)
+{
+        GFile    *file;
+        gboolean  success;
 
-                create_one_file (file);
-                g_object_unref (file);
+        file = g_file_new_for_path (path);
+        success = capplet_file_delete_recursive (file, error);
+        g_object_unref (file);
+
+        return success;
+}
+
+/* Whether @name in the old theme is replaced by the transaction */
+static gboolean
+is_changed_entry (CustomThemeTransaction *transaction, const char *name)
+{
+        const char *suffix;
+        char       *sound;
+        gboolean    changed;
+
+        if (strcmp (name, "index.theme") == 0)
+                return transaction->parent != NULL;
+
+        suffix = strrchr (name, '.');
+        if (suffix == NULL ||
+            (strcmp (suffix, ".ogg") != 0 && strcmp (suffix, ".disabled") != 0))
+                return FALSE;
+
+        sound = g_strndup (name, suffix - name);
+        changed = g_hash_table_contains (transaction->sounds, sound);
+        g_free (sound);
+
+        return changed;
+}
+
+/* Fills @staging with the entries of the current theme that are kept,
+ * subdirectories are returned in @subdirs to be moved just before the
+ * commit */
+static gboolean
+stage_old_entries (CustomThemeTransaction *transaction,
+                   const char             *staging,
+                   GPtrArray              *subdirs,
+                   GError                **error)
+{
+        GDir       *d;
+        const char *name;
+        gboolean    success = TRUE;
+
+        d = g_dir_open (transaction->dir, 0, NULL);
+        if (d == NULL)
+                return TRUE;
+
+        while (success && (name = g_dir_read_name (d)) != NULL) {
+                GStatBuf  buf;
+                char     *path, *target;
+
+                if (is_changed_entry (transaction, name))
+                        continue;
+
+                path   = g_build_filename (transaction->dir, name, NULL);
+                target = g_build_filename (staging, name, NULL);
+
+                if (g_lstat (path, &buf) != 0) {
+                        success = set_error_from_errno (error, "Failed to stat", path);
+                } else if (S_ISLNK (buf.st_mode)) {
+                        char *contents;
+
+                        contents = g_file_read_link (path, error);
+                        if (contents == NULL)
+                                success = FALSE;
+                        else if (symlink (contents, target) != 0)
+                                success = set_error_from_errno (error, "Failed to create link", target);
+                        g_free (contents);
+                } else if (S_ISDIR (buf.st_mode)) {
+                        g_ptr_array_add (subdirs, g_strdup (name));
+                } else if (link (path, target) != 0) {
+                        GFile *source, *destination;
+
+                        /* Hard links are not supported everywhere */
+                        source      = g_file_new_for_path (path);
+                        destination = g_file_new_for_path (target);
+
+                        success = g_file_copy (source, destination,
+                                               G_FILE_COPY_NOFOLLOW_SYMLINKS |
+                                               G_FILE_COPY_ALL_METADATA,
+                                               NULL, NULL, NULL, error);
+                        g_object_unref (source);
+                        g_object_unref (destination);
+                }
+
+                g_free (target);
+                g_free (path);
         }
+        g_dir_close (d);
+
+        return success;
 }
 
-void
-add_custom_file (const char **sounds, const char *filename)
+static gboolean
+stage_new_entries (CustomThemeTransaction *transaction,
+                   const char             *staging,
+                   GError                **error)
 {
-        guint i;
+        GHashTableIter  iter;
+        gpointer        key, value;
+        char           *path;
 
-        for (i = 0; sounds[i] != NULL; i++) {
-                GFile *file;
-                char *name, *path;
-
-                /* We use *.ogg because it's the first type of file that
-                 * libcanberra looks at */
-                name = g_strdup_printf ("%s.ogg", sounds[i]);
-                path = custom_theme_dir_path (name);
-                g_free (name);
-                /* In case there's already a link there, delete it */
-                g_unlink (path);
-                file = g_file_new_for_path (path);
+        if (transaction->parent != NULL) {
+                GKeyFile *keyfile;
+                char     *data;
+                gboolean  success;
+
+                /* Set the data for index.theme */
+                keyfile = g_key_file_new ();
+                g_key_file_set_string (keyfile, "Sound Theme", "Name", _("Custom"));
+                g_key_file_set_string (keyfile, "Sound Theme", "Inherits", transaction->parent);
+                g_key_file_set_string (keyfile, "Sound Theme", "Directories", ".");
+                data = g_key_file_to_data (keyfile, NULL, NULL);
+                g_key_file_free (keyfile);
+
+                path = g_build_filename (staging, "index.theme", NULL);
+                success = g_file_set_contents (path, data, -1, error);
+                g_free (path);
+                g_free (data);
+
+                if (success == FALSE)
+                        return FALSE;
+        }
+
+        g_hash_table_iter_init (&iter, transaction->sounds);
+        while (g_hash_table_iter_next (&iter, &key, &value)) {
+                CustomSound *sound = value;
+
+                if (sound->change == CUSTOM_SOUND_LINK) {
+                        char *name;
+
+                        /* We use *.ogg because it's the first type of file that
+                         * libcanberra looks at */
+                        name = g_strdup_printf ("%s.ogg", (char *) key);
+                        path = g_build_filename (staging, name, NULL);
+                        g_free (name);
+
+                        if (symlink (sound->filename, path) != 0) {
+                                set_error_from_errno (error, "Failed to create link", path);
+                                g_free (path);
+                                return FALSE;
+                        }
+                        g_free (path);
+                } else if (sound->change == CUSTOM_SOUND_DISABLED) {
+                        char *name;
+
+                        name = g_strdup_printf ("%s.disabled", (char *) key);
+                        path = g_build_filename (staging, name, NULL);
+                        g_free (name);
+
+                        if (g_file_set_contents (path, "", 0, error) == FALSE) {
+                                g_free (path);
+                                return FALSE;
+                        }
+                        g_free (path);
+                }
+        }
+
+        path = g_build_filename (staging, "index.theme", NULL);
+        if (g_file_test (path, G_FILE_TEST_EXISTS) == FALSE) {
+                g_set_error (error,
+                             G_IO_ERROR,
+                             G_IO_ERROR_NOT_FOUND,
+                             "The custom theme does not exist");
+                g_free (path);
+                return FALSE;
+        }
+        g_free (path);
+
+        return TRUE;
+}
+
+/* Renames @path to a unique hidden name, so it is gone from the theme
+ * at once and can be removed in the background. Returns the new name,
+ * or %NULL if @path had to be deleted right away */
+static char *
+move_to_trash (const char *path, const char *parent_dir)
+{
+        char *trash;
+
+        trash = g_build_filename (parent_dir, TRASH_PREFIX "XXXXXX", NULL);
+
+        /* An empty directory can be replaced by a rename */
+        if (g_mkdtemp (trash) == NULL) {
+                g_free (trash);
+                delete_path (path, NULL);
+                return NULL;
+        }
+
+        if (g_rename (path, trash) != 0) {
+                g_rmdir (trash);
+                g_free (trash);
+                delete_path (path, NULL);
+                return NULL;
+        }
+        return trash;
+}
+
+static void
+empty_trash (const char *parent_dir)
+{
+        static gboolean  emptied = FALSE;
+        GDir            *d;
+        const char      *name;
+
+        /* Only once, later directories are being removed by this
+         * process already */
+        if (emptied)
+                return;
+        emptied = TRUE;
+
+        d = g_dir_open (parent_dir, 0, NULL);
+        if (d == NULL)
+                return;
+
+        while ((name = g_dir_read_name (d)) != NULL) {
+                char *path;
+
+                if (g_str_has_prefix (name, TRASH_PREFIX) == FALSE)
+                        continue;
+
+                path = g_build_filename (parent_dir, name, NULL);
+                delete_path (path, NULL);
                 g_free (path);
+        }
+        g_dir_close (d);
+}
+
+/* Removes a staging directory which has not been committed. Only the
+ * directories of the theme are moved into it, they are given back to the
+ * theme first and the staging directory is kept if that fails, so the
+ * next commit can try again. */
+static void
+abort_staging (const char *staging, const char *dir)
+{
+        GDir       *d;
+        const char *name;
+        gboolean    success = TRUE;
+
+        d = g_dir_open (staging, 0, NULL);
+        if (d == NULL)
+                return;
+
+        while ((name = g_dir_read_name (d)) != NULL) {
+                char *from, *to;
+
+                from = g_build_filename (staging, name, NULL);
+                to   = g_build_filename (dir, name, NULL);
+
+                if (g_file_test (from, G_FILE_TEST_IS_DIR) == TRUE &&
+                    g_file_test (from, G_FILE_TEST_IS_SYMLINK) == FALSE &&
+                    g_file_test (to, G_FILE_TEST_EXISTS) == FALSE &&
+                    g_rename (from, to) != 0) {
+                        g_warning ("Failed to move '%s' back: %s", from, g_strerror (errno));
+                        success = FALSE;
+                }
+
+                g_free (from);
+                g_free (to);
+        }
+        g_dir_close (d);
+
+        if (success)
+                delete_path (staging, NULL);
+}
+
+static gboolean
+transaction_run (CustomThemeTransaction *transaction, GError **error)
+{
+        GPtrArray *subdirs = NULL;
+        char      *parent_dir, *staging, *aside;
+        gboolean   success = FALSE;
+        guint      i;
+
+        /* Keep the work directories hidden so they are never taken
+         * for themes */
+        parent_dir = g_path_get_dirname (transaction->dir);
+        staging    = g_build_filename (parent_dir, "." CUSTOM_THEME_NAME "-new", NULL);
+        aside      = g_build_filename (parent_dir, "." CUSTOM_THEME_NAME "-old", NULL);
+
+        /* Finish a commit that was interrupted between its renames */
+        if (g_file_test (transaction->dir, G_FILE_TEST_EXISTS) == FALSE &&
+            g_file_test (aside, G_FILE_TEST_IS_DIR) == TRUE)
+                g_rename (aside, transaction->dir);
+
+        /* Left over by a process that exited while removing them */
+        empty_trash (parent_dir);
+
+        if (g_file_test (staging, G_FILE_TEST_EXISTS) == TRUE) {
+                /* There is no theme to give the directories back to */
+                if (g_file_test (transaction->dir, G_FILE_TEST_IS_DIR) == FALSE)
+                        delete_path (staging, NULL);
+                else
+                        abort_staging (staging, transaction->dir);
+
+                if (g_file_test (staging, G_FILE_TEST_EXISTS) == TRUE) {
+                        g_set_error (error, G_IO_ERROR, G_IO_ERROR_EXISTS,
+                                     "Failed to remove '%s'", staging);
+                        goto out;
+                }
+        }
+        if (g_file_test (aside, G_FILE_TEST_EXISTS) == TRUE)
+                delete_path (aside, NULL);
+
+        if (transaction->delete_theme) {
+                /* Readers see the theme disappear at once, the files are
+                 * removed afterwards */
+                if (g_file_test (transaction->dir, G_FILE_TEST_EXISTS) == TRUE)
+                        transaction->trash = move_to_trash (transaction->dir, parent_dir);
+
+                success = TRUE;
+                goto out;
+        }
+
+        if (g_mkdir_with_parents (staging, 0755) != 0) {
+                set_error_from_errno (error, "Failed to create", staging);
+                goto out;
+        }
+
+        subdirs = g_ptr_array_new_with_free_func (g_free);
+
+        if (stage_old_entries (transaction, staging, subdirs, error) == FALSE ||
+            stage_new_entries (transaction, staging, error) == FALSE) {
+                delete_path (staging, NULL);
+                goto out;
+        }
+
+        /* Anything else stored in the theme is moved along, and moved
+         * back if the theme cannot be replaced */
+        for (i = 0; i < subdirs->len; i++) {
+                const char *name = g_ptr_array_index (subdirs, i);
+                char       *from, *to;
+
+                from = g_build_filename (transaction->dir, name, NULL);
+                to   = g_build_filename (staging, name, NULL);
+
+                if (g_rename (from, to) != 0)
+                        g_warning ("Failed to move '%s': %s", from, g_strerror (errno));
+
+                g_free (from);
+                g_free (to);
+        }
+
+        /* A directory cannot be renamed over another one that is not
+         * empty, so the old theme is moved out of the way first */
+        if (g_rename (transaction->dir, aside) != 0 && errno != ENOENT) {
+                set_error_from_errno (error, "Failed to replace", transaction->dir);
+                abort_staging (staging, transaction->dir);
+                goto out;
+        }
+
+        if (g_rename (staging, transaction->dir) != 0) {
+                set_error_from_errno (error, "Failed to replace", transaction->dir);
+
+                /* Otherwise the next commit restores the theme first */
+                if (g_rename (aside, transaction->dir) == 0)
+                        abort_staging (staging, transaction->dir);
+                goto out;
+        }
+
+        if (g_file_test (aside, G_FILE_TEST_EXISTS) == TRUE)
+                transaction->trash = move_to_trash (aside, parent_dir);
+
+        /* And poke the directory once so the theme gets updated */
+        if (utime (transaction->dir, NULL) != 0)
+                g_warning ("Failed to update mtime for directory '%s': %s",
+                           transaction->dir, g_strerror (errno));
+
+        success = TRUE;
+out:
+        if (subdirs != NULL)
+                g_ptr_array_free (subdirs, TRUE);
+
+        g_free (aside);
+        g_free (staging);
+        g_free (parent_dir);
+
+        return success;
+}
+
+static void
+transaction_thread (GTask *task, gpointer user_data)
+{
+        CustomThemeTransaction *transaction;
+        GError                 *error = NULL;
+
+        transaction = g_task_get_task_data (task);
+
+        if (transaction_run (transaction, &error) == TRUE)
+                g_task_return_boolean (task, TRUE);
+        else
+                g_task_return_error (task, error);
+
+        g_object_unref (task);
+}
+
+static void
+on_trash_deleted (GObject      *source_object,
+                  GAsyncResult *result,
+                  gpointer      user_data)
+{
+        GError *error = NULL;
+
+        if (capplet_file_delete_recursive_finish (result, &error) == FALSE) {
+                g_debug ("Failed to remove the old custom theme: %s", error->message);
+                g_error_free (error);
+        }
+}
+
+static void
+on_transaction_committed (GObject      *source_object,
+                          GAsyncResult *result,
+                          gpointer      user_data)
+{
+        CommitData             *data = user_data;
+        CustomThemeTransaction *transaction;
+
+        transaction = g_task_get_task_data (G_TASK (result));
 
-                /* Create the link */
-                g_file_make_symbolic_link (file, filename, NULL, NULL);
+        /* The old theme is removed without holding up the next
+         * transactions */
+        if (transaction->trash != NULL) {
+                GFile *file;
+
+                file = g_file_new_for_path (transaction->trash);
+                capplet_file_delete_recursive_async (file, NULL, on_trash_deleted, NULL);
                 g_object_unref (file);
         }
+
+        /* Start over from what is on the disk once everything has been
+         * written */
+        if (--pending_transactions == 0)
+                snapshot_clear ();
+
+        if (data->callback != NULL)
+                data->callback (source_object, result, data->user_data);
+
+        g_slice_free (CommitData, data);
 }
 
+/**
+ * custom_theme_transaction_commit_async:
+ * @transaction: (transfer full): the changes to make
+ * @callback: called once the changes are on the disk, or failed
+ * @user_data: data for @callback
+ *
+ * Writes all the changes of @transaction to the custom theme from a
+ * worker thread. The theme is staged in a separate directory and then
+ * swapped in with two renames, so readers never see a partly written
+ * theme. Between the renames the theme does not exist for a moment, and
+ * the old theme is restored from its hidden directory when a commit is
+ * interrupted there. Callbacks are called in the order of the commits.
+ *
+ * The state returned by custom_theme_dir_has_file() and similar
+ * functions includes the changes right away.
+ **/
 void
-create_custom_theme (const char *parent)
+custom_theme_transaction_commit_async (CustomThemeTransaction *transaction,
+                                       GAsyncReadyCallback     callback,
+                                       gpointer                user_data)
 {
-        GKeyFile *keyfile;
-        char     *data;
-        char     *path;
+        CommitData *data;
+        GTask      *task;
 
-        /* Create the custom directory */
-        path = custom_theme_dir_path (NULL);
-        g_mkdir_with_parents (path, 0755);
-        g_free (path);
+        g_return_if_fail (transaction != NULL);
 
-        /* Set the data for index.theme */
-        keyfile = g_key_file_new ();
-        g_key_file_set_string (keyfile, "Sound Theme", "Name", _("Custom"));
-        g_key_file_set_string (keyfile, "Sound Theme", "Inherits", parent);
-        g_key_file_set_string (keyfile, "Sound Theme", "Directories", ".");
-        data = g_key_file_to_data (keyfile, NULL, NULL);
-        g_key_file_free (keyfile);
-
-        /* Save the index.theme */
-        path = custom_theme_dir_path ("index.theme");
-        g_file_set_contents (path, data, -1, NULL);
-        g_free (path);
-        g_free (data);
+        if (G_UNLIKELY (transaction_pool == NULL))
+                transaction_pool = g_thread_pool_new ((GFunc) transaction_thread,
+                                                      NULL,
+                                                      1,
+                                                      FALSE,
+                                                      NULL);
+
+        transaction->dir = custom_theme_dir_path (NULL);
+
+        snapshot_apply (transaction);
+
+        data = g_slice_new (CommitData);
+        data->callback  = callback;
+        data->user_data = user_data;
+
+        task = g_task_new (NULL, NULL, on_transaction_committed, data);
+        g_task_set_task_data (task,
+                              transaction,
+                              (GDestroyNotify) custom_theme_transaction_free);
+
+        pending_transactions++;
+
+        g_thread_pool_push (transaction_pool, task, NULL);
+}
+
+gboolean
+custom_theme_transaction_commit_finish (GAsyncResult *result,
+                                        GError      **error)
+{
+        g_return_val_if_fail (g_task_is_valid (result, NULL), FALSE);
 
-        custom_theme_update_time ();
+        return g_task_propagate_boolean (G_TASK (result), error);
 }
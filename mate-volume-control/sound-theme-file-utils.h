@@ -23,15 +23,24 @@
 
 char *custom_theme_dir_path (const char *child);
 gboolean custom_theme_dir_is_empty (void);
-void create_custom_theme (const char *parent);
+gboolean custom_theme_dir_has_file (const char *name);
+char *custom_theme_dir_read_link (const char *name);
+void custom_theme_dir_invalidate (void);
 
-void delete_custom_theme_dir (void);
-void delete_old_files (const char **sounds);
-void delete_disabled_files (const char **sounds);
+typedef struct _CustomThemeTransaction CustomThemeTransaction;
 
-void add_disabled_file (const char **sounds);
-void add_custom_file (const char **sounds, const char *filename);
+CustomThemeTransaction *custom_theme_transaction_new (void);
+void custom_theme_transaction_free (CustomThemeTransaction *transaction);
 
-void custom_theme_update_time (void);
+void custom_theme_transaction_set_parent (CustomThemeTransaction *transaction, const char *parent);
+void custom_theme_transaction_reset_sounds (CustomThemeTransaction *transaction, const char **sounds);
+void custom_theme_transaction_disable_sounds (CustomThemeTransaction *transaction, const char **sounds);
+void custom_theme_transaction_link_sounds (CustomThemeTransaction *transaction, const char **sounds, const char *filename);
+void custom_theme_transaction_delete_theme (CustomThemeTransaction *transaction);
+
+void custom_theme_transaction_commit_async (CustomThemeTransaction *transaction,
+                                            GAsyncReadyCallback callback,
+                                            gpointer user_data);
+gboolean custom_theme_transaction_commit_finish (GAsyncResult *result, GError **error);
 
 #endif /* __SOUND_THEME_FILE_UTILS_HH__ */
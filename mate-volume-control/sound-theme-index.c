@@ -0,0 +1,453 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 8 -*-
+ * Copyright (C) 2026 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/* The list of installed sound themes.
+ *
+ * Finding the themes means opening every sounds directory, checking each of
+ * its entries and parsing all the index.theme files. The result is kept in
+ * a cache file together with the modification time of each sounds directory,
+ * so that a directory is only scanned again after a theme has been added to
+ * it or removed from it.
+ *
+ * Subdirectories which have no index.theme yet, such as a theme which is
+ * still being installed, are remembered and checked on every load, as their
+ * index appearing does not change the time of the sounds directory. */
+
+#include <config.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include "sound-theme-index.h"
+
+#define CACHE_VERSION   2
+
+#define CACHE_GROUP     "Sound Theme Cache"
+#define THEME_GROUP     "Sound Theme"
+
+void
+sound_theme_info_free (SoundThemeInfo *info)
+{
+        g_free (info->id);
+        g_free (info->name);
+        g_free (info->parent);
+        g_slice_free (SoundThemeInfo, info);
+}
+
+static gboolean
+load_index_theme (const char *index,
+                  char      **name,
+                  char      **parent,
+                  gboolean   *hidden)
+{
+        GKeyFile *file;
+
+        *name   = NULL;
+        *parent = NULL;
+        *hidden = FALSE;
+
+        file = g_key_file_new ();
+        if (g_key_file_load_from_file (file, index, G_KEY_FILE_KEEP_TRANSLATIONS, NULL) == FALSE) {
+                g_key_file_free (file);
+                return FALSE;
+        }
+
+        *hidden = g_key_file_get_boolean (file, THEME_GROUP, "Hidden", NULL);
+        *name   = g_key_file_get_locale_string (file, THEME_GROUP, "Name", NULL, NULL);
+        *parent = g_key_file_get_string (file, THEME_GROUP, "Inherits", NULL);
+
+        g_key_file_free (file);
+
+        return *name != NULL;
+}
+
+/**
+ * sound_theme_index_load_name:
+ * @index: path of an index.theme file
+ * @parent: (out) (allow-none): return location for the parent theme
+ *
+ * Returns: the display name of the theme, or %NULL if the theme is hidden
+ * or the file cannot be read
+ */
+char *
+sound_theme_index_load_name (const char *index,
+                             char      **parent)
+{
+        char     *name;
+        char     *inherits;
+        gboolean  hidden;
+
+        if (load_index_theme (index, &name, &inherits, &hidden) == FALSE) {
+                g_free (name);
+                g_free (inherits);
+                return NULL;
+        }
+
+        /* Don't add hidden themes to the list */
+        if (hidden) {
+                g_free (name);
+                g_free (inherits);
+                return NULL;
+        }
+
+        if (parent != NULL)
+                *parent = inherits;
+        else
+                g_free (inherits);
+
+        return name;
+}
+
+static char *
+get_cache_path (void)
+{
+        return g_build_filename (g_get_user_cache_dir (),
+                                 "mate-volume-control",
+                                 "sound-themes",
+                                 NULL);
+}
+
+static char *
+get_cache_locale (void)
+{
+        /* Display names are resolved for the current locale */
+        return g_strjoinv (":", (char **) g_get_language_names ());
+}
+
+static GKeyFile *
+load_cache (void)
+{
+        GKeyFile *cache;
+        char     *path;
+        char     *locale;
+        char     *cached_locale;
+        gint      version;
+
+        cache = g_key_file_new ();
+
+        path = get_cache_path ();
+        if (g_key_file_load_from_file (cache, path, G_KEY_FILE_NONE, NULL) == FALSE) {
+                g_free (path);
+                return cache;
+        }
+        g_free (path);
+
+        version = g_key_file_get_integer (cache, CACHE_GROUP, "Version", NULL);
+
+        locale = get_cache_locale ();
+        cached_locale = g_key_file_get_string (cache, CACHE_GROUP, "Locale", NULL);
+
+        if (version != CACHE_VERSION || g_strcmp0 (locale, cached_locale) != 0) {
+                g_debug ("Discarding outdated sound theme cache");
+
+                g_key_file_free (cache);
+                cache = g_key_file_new ();
+        }
+
+        g_free (locale);
+        g_free (cached_locale);
+
+        return cache;
+}
+
+static void
+save_cache (GKeyFile *cache)
+{
+        GError *error = NULL;
+        char   *locale;
+        char   *path;
+        char   *dir;
+        char   *data;
+        gsize   length;
+
+        locale = get_cache_locale ();
+
+        g_key_file_set_integer (cache, CACHE_GROUP, "Version", CACHE_VERSION);
+        g_key_file_set_string (cache, CACHE_GROUP, "Locale", locale);
+        g_free (locale);
+
+        data = g_key_file_to_data (cache, &length, NULL);
+        path = get_cache_path ();
+
+        dir = g_path_get_dirname (path);
+        g_mkdir_with_parents (dir, 0755);
+        g_free (dir);
+
+        if (g_file_set_contents (path, data, length, &error) == FALSE) {
+                g_debug ("Failed to save the sound theme cache: %s", error->message);
+                g_error_free (error);
+        }
+
+        g_free (path);
+        g_free (data);
+}
+
+static void
+remove_cached_dir (GKeyFile *cache, const char *dir)
+{
+        char  **themes;
+        guint   i;
+
+        themes = g_key_file_get_string_list (cache, dir, "Themes", NULL, NULL);
+        if (themes != NULL) {
+                for (i = 0; themes[i] != NULL; i++) {
+                        char *group = g_build_filename (dir, themes[i], NULL);
+
+                        g_key_file_remove_group (cache, group, NULL);
+                        g_free (group);
+                }
+                g_strfreev (themes);
+        }
+
+        g_key_file_remove_group (cache, dir, NULL);
+}
+
+static void
+add_theme (GHashTable *hash,
+           const char *id,
+           const char *name,
+           const char *parent)
+{
+        SoundThemeInfo *info;
+
+        info = g_slice_new (SoundThemeInfo);
+        info->id     = g_strdup (id);
+        info->name   = g_strdup (name);
+        info->parent = g_strdup (parent);
+
+        /* Later directories take precedence */
+        g_hash_table_replace (hash, info->id, info);
+}
+
+static gboolean
+pending_dirs_changed (GKeyFile *cache, const char *dir)
+{
+        char     **pending;
+        gboolean   changed = FALSE;
+        guint      i;
+
+        pending = g_key_file_get_string_list (cache, dir, "Pending", NULL, NULL);
+        if (pending == NULL)
+                return FALSE;
+
+        for (i = 0; pending[i] != NULL && changed == FALSE; i++) {
+                char *index = g_build_filename (dir, pending[i], "index.theme", NULL);
+
+                changed = g_file_test (index, G_FILE_TEST_EXISTS);
+                g_free (index);
+        }
+
+        g_strfreev (pending);
+        return changed;
+}
+
+static void
+load_cached_dir (GHashTable *hash, GKeyFile *cache, const char *dir)
+{
+        char  **themes;
+        guint   i;
+
+        themes = g_key_file_get_string_list (cache, dir, "Themes", NULL, NULL);
+        if (themes == NULL)
+                return;
+
+        for (i = 0; themes[i] != NULL; i++) {
+                char *group;
+                char *name;
+                char *parent;
+
+                group = g_build_filename (dir, themes[i], NULL);
+
+                if (g_key_file_get_boolean (cache, group, "Hidden", NULL) == FALSE) {
+                        name   = g_key_file_get_string (cache, group, "Name", NULL);
+                        parent = g_key_file_get_string (cache, group, "Inherits", NULL);
+
+                        if (name != NULL)
+                                add_theme (hash, themes[i], name, parent);
+
+                        g_free (name);
+                        g_free (parent);
+                }
+                g_free (group);
+        }
+
+        g_strfreev (themes);
+}
+
+static void
+scan_dir (GHashTable *hash,
+          GKeyFile   *cache,
+          const char *dir,
+          time_t      mtime)
+{
+        GDir       *d;
+        GPtrArray  *themes;
+        GPtrArray  *pending;
+        const char *name;
+
+        remove_cached_dir (cache, dir);
+
+        d = g_dir_open (dir, 0, NULL);
+        if (d == NULL)
+                return;
+
+        /* The names returned by g_dir_read_name() are only valid until the
+         * next call */
+        themes  = g_ptr_array_new_with_free_func (g_free);
+        pending = g_ptr_array_new_with_free_func (g_free);
+
+        while ((name = g_dir_read_name (d)) != NULL) {
+                char     *dirname, *index, *group;
+                char     *indexname, *parent;
+                gboolean  hidden;
+
+                /* Hidden directories are not themes, the custom theme
+                 * is staged in them while it is being written */
+                if (name[0] == '.')
+                        continue;
+
+                /* Look for directories */
+                dirname = g_build_filename (dir, name, NULL);
+                if (g_file_test (dirname, G_FILE_TEST_IS_DIR) == FALSE) {
+                        g_free (dirname);
+                        continue;
+                }
+
+                /* Look for index files */
+                index = g_build_filename (dirname, "index.theme", NULL);
+                g_free (dirname);
+
+                if (load_index_theme (index, &indexname, &parent, &hidden) == FALSE) {
+                        if (g_file_test (index, G_FILE_TEST_EXISTS) == FALSE)
+                                g_ptr_array_add (pending, g_strdup (name));
+
+                        g_free (indexname);
+                        g_free (parent);
+                        g_free (index);
+                        continue;
+                }
+                g_free (index);
+
+                group = g_build_filename (dir, name, NULL);
+
+                g_key_file_set_string (cache, group, "Name", indexname);
+                if (parent != NULL)
+                        g_key_file_set_string (cache, group, "Inherits", parent);
+                g_key_file_set_boolean (cache, group, "Hidden", hidden);
+                g_free (group);
+
+                if (hidden == FALSE)
+                        add_theme (hash, name, indexname, parent);
+
+                g_ptr_array_add (themes, g_strdup (name));
+
+                g_free (indexname);
+                g_free (parent);
+        }
+
+        g_key_file_set_string_list (cache, dir, "Themes",
+                                    (const gchar * const *) themes->pdata,
+                                    themes->len);
+        if (pending->len > 0)
+                g_key_file_set_string_list (cache, dir, "Pending",
+                                            (const gchar * const *) pending->pdata,
+                                            pending->len);
+
+        /* A directory modified within the current second may still change
+         * without its time changing, do not trust the time in that case */
+        if (mtime < time (NULL))
+                g_key_file_set_int64 (cache, dir, "MTime", mtime);
+
+        g_ptr_array_free (themes, TRUE);
+        g_ptr_array_free (pending, TRUE);
+        g_dir_close (d);
+}
+
+static gboolean
+load_dir (GHashTable *hash, GKeyFile *cache, const char *dir)
+{
+        GStatBuf st;
+
+        if (g_stat (dir, &st) != 0 || S_ISDIR (st.st_mode) == FALSE) {
+                if (g_key_file_has_group (cache, dir) == FALSE)
+                        return FALSE;
+
+                remove_cached_dir (cache, dir);
+                return TRUE;
+        }
+
+        if (g_key_file_has_key (cache, dir, "MTime", NULL) == TRUE &&
+            g_key_file_get_int64 (cache, dir, "MTime", NULL) == (gint64) st.st_mtime &&
+            pending_dirs_changed (cache, dir) == FALSE) {
+                load_cached_dir (hash, cache, dir);
+                return FALSE;
+        }
+
+        g_debug ("Scanning sound themes in %s", dir);
+
+        scan_dir (hash, cache, dir, st.st_mtime);
+        return TRUE;
+}
+
+/**
+ * sound_theme_index_load:
+ *
+ * Finds the sound themes installed in the system and user data directories.
+ * Hidden themes are left out. When several directories contain a theme with
+ * the same identifier, the user data directory takes precedence.
+ *
+ * Returns: a hash table mapping theme identifiers to #SoundThemeInfo
+ */
+GHashTable *
+sound_theme_index_load (void)
+{
+        GHashTable         *hash;
+        GKeyFile           *cache;
+        const char * const *data_dirs;
+        char               *dir;
+        gboolean            changed = FALSE;
+        guint               i;
+
+        hash = g_hash_table_new_full (g_str_hash,
+                                      g_str_equal,
+                                      NULL,
+                                      (GDestroyNotify) sound_theme_info_free);
+
+        cache = load_cache ();
+
+        data_dirs = g_get_system_data_dirs ();
+        for (i = 0; data_dirs[i] != NULL; i++) {
+                dir = g_build_filename (data_dirs[i], "sounds", NULL);
+                changed |= load_dir (hash, cache, dir);
+                g_free (dir);
+        }
+
+        dir = g_build_filename (g_get_user_data_dir (), "sounds", NULL);
+        changed |= load_dir (hash, cache, dir);
+        g_free (dir);
+
+        if (changed)
+                save_cache (cache);
+
+        g_key_file_free (cache);
+
+        return hash;
+}
@@ -0,0 +1,37 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 8 -*-
+ * Copyright (C) 2026 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+#ifndef __SOUND_THEME_INDEX_H__
+#define __SOUND_THEME_INDEX_H__
+
+#include <glib.h>
+
+typedef struct {
+        char     *id;
+        char     *name;
+        char     *parent;
+} SoundThemeInfo;
+
+void        sound_theme_info_free       (SoundThemeInfo *info);
+
+char       *sound_theme_index_load_name (const char     *index,
+                                         char          **parent);
+
+GHashTable *sound_theme_index_load      (void);
+
+#endif /* __SOUND_THEME_INDEX_H__ */